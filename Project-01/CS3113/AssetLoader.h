@@ -0,0 +1,85 @@
+// Loads textures without stalling the frame. Worker threads decode image
+// files with LoadImage(), which only touches the CPU, and queue the pixels;
+// the render thread uploads them with upload(), a few per frame within a
+// time budget, since only the thread with the GL context may create
+// textures. Until then a request's texture has id 0, which draws nothing
+
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "cs3113.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef int AssetRequest; // Index of a request, valid for the loader's life
+constexpr AssetRequest NO_ASSET = -1;
+constexpr double ASSET_UPLOAD_BUDGET = 0.002; // Seconds of uploads per frame
+
+struct AssetLoaderStats {
+    int requests = 0;
+    int uploads = 0;              // Textures created
+    int failures = 0;             // Files that didn't decode
+    double decodeSeconds = 0.0;   // LoadImage() time, summed over workers
+    double uploadSeconds = 0.0;   // LoadTextureFromImage() time
+    double maxFrameSeconds = 0.0; // Most upload() spent in one call
+};
+
+class AssetLoader {
+public:
+    explicit AssetLoader(int threads = 2);
+    ~AssetLoader();
+
+    // Render thread only
+    AssetRequest request(const char* filepath);
+    int upload(double budgetSeconds = ASSET_UPLOAD_BUDGET);
+
+    bool isLoaded(AssetRequest request) const;
+    bool hasFailed(AssetRequest request) const;
+    const Texture2D& getTexture(AssetRequest request) const;
+    // Seconds from request() to the texture's upload, 0 until then
+    double getLatency(AssetRequest request) const;
+
+    // Every request uploaded, or failed
+    bool isIdle() const { return mOutstanding == 0; }
+
+    const AssetLoaderStats& getStats() const { return mStats; }
+    void logStats(const char* label) const;
+
+private:
+    struct Job {
+        AssetRequest request;
+        std::string filepath;
+    };
+    struct Decoded {
+        AssetRequest request;
+        Image image;
+        double seconds;
+    };
+    struct Record {
+        Texture2D texture;
+        double requestTime;
+        double uploadTime;
+        bool loaded;
+        bool failed; // Didn't decode; the texture stays empty
+    };
+
+    void workerLoop();
+
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWake; // New job, or stopping
+    std::deque<Job> mJobs;         // Waiting for a worker
+    std::deque<Decoded> mDecoded;  // Waiting for upload()
+    bool mStopping = false;
+
+    // Render thread only
+    std::vector<Record> mRecords;
+    int mOutstanding = 0;
+    AssetLoaderStats mStats;
+};
+
+#endif // ASSET_LOADER_H
@@ -8,8 +8,10 @@
  * Academic Misconduct.
  **/
 
+#include "CS3113/AssetLoader.h"
 #include "CS3113/cs3113.h"
 #include <array>
+#include <chrono>
 #include <map>
 #include <math.h>
 #include <stdlib.h>
@@ -70,7 +72,15 @@ struct TextureObject {
 
     bool flipHorizontal = false; // Needed for Maxwell only
 
-    void loadTexture() { texture = LoadTexture(texturePath); }
+    // Queues the decode; the texture draws nothing until it's uploaded
+    void loadTexture(AssetLoader& loader) {
+        request = loader.request(texturePath);
+    }
+
+    // Takes the texture once the loader has uploaded it
+    void takeTexture(const AssetLoader& loader) {
+        if (texture.id == 0) texture = loader.getTexture(request);
+    }
 
     void renderObject() {
         // Whole texture (UV coordinates)
@@ -95,7 +105,8 @@ struct TextureObject {
     }
 
     const char* texturePath;
-    Texture2D texture;
+    AssetRequest request = NO_ASSET;
+    Texture2D texture = {0, 0, 0, 0, 0};
     Vector2 position;
     Vector2 scale;
     float angle = 0.0f;
@@ -106,6 +117,13 @@ AppStatus gAppStatus = RUNNING;
 float gPreviousTicks = 0.0f;
 int gFrameCounter = 0;
 
+// Startup: the PNGs decode on worker threads while the first frames draw
+const std::chrono::steady_clock::time_point gLaunchTime =
+    std::chrono::steady_clock::now();
+AssetLoader* gAssets = nullptr;
+bool gFirstFrameLogged = false;
+bool gAssetsLogged = false;
+
 // Global timers
 float gBallerinaTime = 0.0f;
 float gBallerinaRotationTime = 0.0f;
@@ -132,15 +150,17 @@ void updateSkibidi(float deltaTime);
 void update();
 void render();
 void shutdown();
+void logStartup();
 
 // Function Definitions
 void initialise() {
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Project 1 - Brainrot");
 
-    gLebronTexture.loadTexture();
-    gMaxwellTexture.loadTexture();
-    gSkibidiTexture.loadTexture();
-    gBallerinaTexture.loadTexture();
+    gAssets = new AssetLoader();
+    gLebronTexture.loadTexture(*gAssets);
+    gMaxwellTexture.loadTexture(*gAssets);
+    gSkibidiTexture.loadTexture(*gAssets);
+    gBallerinaTexture.loadTexture(*gAssets);
 
     SetTargetFPS(FPS);
 }
@@ -166,6 +186,15 @@ void update() {
 }
 
 void render() {
+    // Upload what the workers have decoded, within the frame budget
+    if (!gAssets->isIdle()) {
+        gAssets->upload();
+        gBallerinaTexture.takeTexture(*gAssets);
+        gLebronTexture.takeTexture(*gAssets);
+        gMaxwellTexture.takeTexture(*gAssets);
+        gSkibidiTexture.takeTexture(*gAssets);
+    }
+
     BeginDrawing();
 
     // Cycle through 360 degrees of hue
@@ -179,6 +208,7 @@ void render() {
     gMaxwellTexture.renderObject();
     gSkibidiTexture.renderObject();
     EndDrawing();
+    logStartup();
 }
 
 void shutdown() {
@@ -187,6 +217,24 @@ void shutdown() {
     UnloadTexture(gLebronTexture.texture);
     UnloadTexture(gMaxwellTexture.texture);
     UnloadTexture(gSkibidiTexture.texture);
+    delete gAssets;
+}
+
+// Prints time from launch to the first frame, then to every texture loaded
+void logStartup() {
+    if (gFirstFrameLogged && gAssetsLogged) return;
+    double milliseconds = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - gLaunchTime)
+                              .count();
+    if (!gFirstFrameLogged) {
+        gFirstFrameLogged = true;
+        printf("Startup: first frame after %.1f ms\n", milliseconds);
+    }
+    if (!gAssetsLogged && gAssets->isIdle()) {
+        gAssetsLogged = true;
+        printf("Startup: all textures after %.1f ms\n", milliseconds);
+        gAssets->logStats("startup");
+    }
 }
 
 int main(void) {
@@ -0,0 +1,59 @@
+#include "Animation.h"
+
+AnimationClips::AnimationClips() {
+    for (int i = 0; i < DIRECTION_COUNT; i++) mOffset[i] = mCount[i] = 0;
+}
+
+/**
+ * @brief Copies every clip of the atlas into one array. Directions missing
+ * from the atlas get an empty clip
+ * @param animationAtlas frame indices per direction
+ */
+AnimationClips::AnimationClips(
+    const std::map<Direction, std::vector<int>>& animationAtlas) :
+    AnimationClips() {
+    size_t total = 0;
+    for (const auto& clip : animationAtlas) total += clip.second.size();
+    mFrames.reserve(total);
+    for (const auto& clip : animationAtlas) {
+        mOffset[clip.first] = static_cast<int>(mFrames.size());
+        mCount[clip.first] = static_cast<int>(clip.second.size());
+        mFrames.insert(mFrames.end(), clip.second.begin(), clip.second.end());
+    }
+}
+
+/**
+ * @brief Sprite sheet index of a frame of a clip
+ * @param direction
+ * @param index wraps around, since the frame index carries over when an
+ * entity turns to a shorter clip
+ * @return sprite sheet index, or 0 if the direction has no clip
+ */
+int AnimationClips::getFrame(Direction direction, int index) const {
+    if (mCount[direction] == 0) return 0;
+    return mFrames[mOffset[direction] + index % mCount[direction]];
+}
+
+/**
+ * Advances to the next frame of the direction's clip once 1 / frameSpeed
+ * seconds have built up.
+ *
+ * @param clips
+ * @param direction clip to step through
+ * @param deltaTime represents the time elapsed since the last frame update.
+ */
+void Animator::update(const AnimationClips& clips, Direction direction,
+                      float deltaTime) {
+    int frameCount = clips.getFrameCount(direction);
+    if (frameCount == 0) return;
+
+    mAnimationTime += deltaTime;
+    float framesPerSecond = 1.0f / mFrameSpeed;
+
+    if (mAnimationTime >= framesPerSecond) {
+        mAnimationTime = 0.0f;
+
+        mFrameIndex++;
+        mFrameIndex %= frameCount;
+    }
+}
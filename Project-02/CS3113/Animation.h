@@ -0,0 +1,64 @@
+// Raylib-free sprite sheet animation. Clip frame indices live in one flat
+// array indexed by Direction, so animating never touches the heap
+
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <map>
+#include <stddef.h>
+#include <vector>
+
+enum Direction { LEFT, UP, RIGHT, DOWN };
+
+constexpr int DIRECTION_COUNT = 4;
+
+// Frame indices for every direction, built once from an atlas map
+class AnimationClips {
+public:
+    AnimationClips();
+    explicit AnimationClips(
+        const std::map<Direction, std::vector<int>>& animationAtlas);
+
+    bool hasClip(Direction direction) const {
+        return mCount[direction] > 0;
+    }
+
+    int getFrameCount(Direction direction) const { return mCount[direction]; }
+
+    const int* getFrames(Direction direction) const {
+        return mFrames.data() + mOffset[direction];
+    }
+
+    int getFrame(Direction direction, int index) const;
+
+private:
+    std::vector<int> mFrames; // Every clip back to back
+    int mOffset[DIRECTION_COUNT];
+    int mCount[DIRECTION_COUNT];
+};
+
+// Playback state for one entity; the clips are passed in, not owned
+class Animator {
+public:
+    explicit Animator(int frameSpeed = 0) : mFrameSpeed {frameSpeed} { }
+
+    void update(const AnimationClips& clips, Direction direction,
+                float deltaTime);
+
+    int getFrame(const AnimationClips& clips, Direction direction) const {
+        return clips.getFrame(direction, mFrameIndex);
+    }
+
+    int getFrameIndex() const { return mFrameIndex; }
+
+    int getFrameSpeed() const { return mFrameSpeed; }
+
+    void setFrameSpeed(int newSpeed) { mFrameSpeed = newSpeed; }
+
+private:
+    int mFrameSpeed;
+    int mFrameIndex = 0;
+    float mAnimationTime = 0.0f;
+};
+
+#endif // ANIMATION_H
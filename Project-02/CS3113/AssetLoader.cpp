@@ -0,0 +1,142 @@
+#include "AssetLoader.h"
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+
+static const Texture2D sNoTexture = {0, 0, 0, 0, 0};
+
+// Seconds on a clock the workers can read too; GetTime() needs the window
+static double now() {
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Starts the decode threads. They sleep until there's a request
+ * @param threads at least 1
+ */
+AssetLoader::AssetLoader(int threads) {
+    for (int i = 0; i < std::max(1, threads); i++)
+        mThreads.emplace_back(&AssetLoader::workerLoop, this);
+}
+
+/**
+ * @brief Stops the workers, dropping anything not yet decoded, and frees
+ * decoded images that never got uploaded. Textures already uploaded are the
+ * caller's to unload
+ */
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for (std::thread& thread : mThreads) thread.join();
+    for (const Decoded& decoded : mDecoded) UnloadImage(decoded.image);
+}
+
+/**
+ * @brief Queues filepath for a worker to decode. Returns straight away
+ * @param filepath
+ * @return the request, for isLoaded() and getTexture()
+ */
+AssetRequest AssetLoader::request(const char* filepath) {
+    AssetRequest request = static_cast<AssetRequest>(mRecords.size());
+    mRecords.push_back({sNoTexture, now(), 0.0, false, false});
+    mOutstanding++;
+    mStats.requests++;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back({request, filepath});
+    }
+    mWake.notify_one();
+    return request;
+}
+
+/**
+ * @brief Uploads decoded images as textures, oldest first, until the budget
+ * is spent. Always uploads at least one if any are ready, so a texture
+ * bigger than the budget still arrives
+ * @param budgetSeconds
+ * @return textures uploaded
+ */
+int AssetLoader::upload(double budgetSeconds) {
+    if (mOutstanding == 0) return 0;
+    double start = now();
+    int uploaded = 0;
+    while (uploaded == 0 || now() - start < budgetSeconds) {
+        Decoded decoded;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mDecoded.empty()) break;
+            decoded = mDecoded.front();
+            mDecoded.pop_front();
+        }
+        Record& record = mRecords[decoded.request];
+        mStats.decodeSeconds += decoded.seconds;
+        mOutstanding--;
+        if (decoded.image.data == nullptr) { // LoadImage() already logged it
+            record.failed = true;
+            mStats.failures++;
+            continue;
+        }
+        double uploadStart = now();
+        record.texture = LoadTextureFromImage(decoded.image);
+        UnloadImage(decoded.image);
+        record.uploadTime = now();
+        record.loaded = true;
+        mStats.uploadSeconds += record.uploadTime - uploadStart;
+        mStats.uploads++;
+        uploaded++;
+    }
+    mStats.maxFrameSeconds = std::max(mStats.maxFrameSeconds, now() - start);
+    return uploaded;
+}
+
+bool AssetLoader::isLoaded(AssetRequest request) const {
+    return request != NO_ASSET && mRecords[request].loaded;
+}
+
+bool AssetLoader::hasFailed(AssetRequest request) const {
+    return request != NO_ASSET && mRecords[request].failed;
+}
+
+const Texture2D& AssetLoader::getTexture(AssetRequest request) const {
+    if (!isLoaded(request)) return sNoTexture;
+    return mRecords[request].texture;
+}
+
+double AssetLoader::getLatency(AssetRequest request) const {
+    if (!isLoaded(request)) return 0.0;
+    return mRecords[request].uploadTime - mRecords[request].requestTime;
+}
+
+/**
+ * @brief Prints the counters, like TextureCache::logStats()
+ * @param label what just happened
+ */
+void AssetLoader::logStats(const char* label) const {
+    printf("AssetLoader [%s]: %d/%d uploaded, %d failed, %.2f ms decoding "
+           "off thread, %.2f ms uploading (most in one frame %.2f ms)\n",
+           label, mStats.uploads, mStats.requests, mStats.failures,
+           mStats.decodeSeconds * 1000.0, mStats.uploadSeconds * 1000.0,
+           mStats.maxFrameSeconds * 1000.0);
+}
+
+// Decodes jobs until the loader is destroyed
+void AssetLoader::workerLoop() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mWake.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+        if (mStopping) return;
+        Job job = mJobs.front();
+        mJobs.pop_front();
+        lock.unlock();
+        double start = now();
+        Image image = LoadImage(job.filepath.c_str());
+        double seconds = now() - start;
+        lock.lock();
+        mDecoded.push_back({job.request, image, seconds});
+    }
+}
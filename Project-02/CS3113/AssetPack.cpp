@@ -0,0 +1,396 @@
+#include "AssetPack.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// File layout, all little-endian:
+//   "PONGPAK" + version byte, uint32 texture count, uint32 PackFlags,
+//   uint64 file size, uint64 checksum of every byte after the header
+//   then per texture a PACK_ENTRY_SIZE directory entry:
+//     name (PACK_NAME_SIZE bytes), uint32 width, height, mipmaps, format,
+//     atlas, x, y, 0, uint64 offset, size, source size, source mtime
+//   then the pixels, each texture's starting on a PACK_ALIGNMENT boundary
+static const uint8_t PACK_MAGIC[7] = {'P', 'O', 'N', 'G', 'P', 'A', 'K'};
+static const uint8_t PACK_VERSION = 3; // 2: atlas regions, 3: source stamps
+static const size_t PACK_HEADER_SIZE = 32;
+static const size_t PACK_ENTRY_SIZE = PACK_NAME_SIZE + 64;
+
+static void writeUint32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+static void writeUint64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint32_t readUint32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= (uint32_t)in[i] << (8 * i);
+    return value;
+}
+
+static uint64_t readUint64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) value |= (uint64_t)in[i] << (8 * i);
+    return value;
+}
+
+static uint64_t alignUp(uint64_t offset) {
+    return (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+}
+
+// Size and mtime of the file at filepath, or false if there isn't one
+static bool statSource(const char* filepath, uint64_t& size, int64_t& time) {
+    struct stat info;
+    if (stat(filepath, &info) != 0) return false;
+    size = static_cast<uint64_t>(info.st_size);
+    time = static_cast<int64_t>(info.st_mtime);
+    return true;
+}
+
+/**
+ * @brief FNV-1a style hash a 64-bit word at a time, over four interleaved
+ * lanes so it isn't one long multiply chain. Not cryptographic: it catches
+ * corruption, not changed images (see AssetPack::isCurrent())
+ * @param data
+ * @param size
+ */
+uint64_t packChecksum(const uint8_t* data, size_t size) {
+    const uint64_t PRIME = 1099511628211ull;
+    uint64_t a = 14695981039346656037ull, b = 1, c = 2, d = 3;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        // Native order: little-endian, like the pack and every target
+        uint64_t words[4];
+        memcpy(words, data + i, sizeof(words));
+        a = (a ^ words[0] ^ (words[0] >> 29)) * PRIME;
+        b = (b ^ words[1] ^ (words[1] >> 29)) * PRIME;
+        c = (c ^ words[2] ^ (words[2] >> 29)) * PRIME;
+        d = (d ^ words[3] ^ (words[3] >> 29)) * PRIME;
+    }
+    for (; i < size; i++) a = (a ^ data[i]) * PRIME;
+    uint64_t hash = size;
+    const uint64_t lanes[4] = {a, b, c, d};
+    for (int lane = 0; lane < 4; lane++)
+        hash = (hash ^ lanes[lane] ^ (lanes[lane] >> 32)) * PRIME;
+    return hash;
+}
+
+/**
+ * @brief Bytes of pixels a texture of this size and format has, every
+ * mipmap level included, as raylib's GetPixelDataSize() works them out for
+ * each level. Raylib-free, so the pack can check its directory
+ * @param width, height of the largest level, at most PACK_MAX_DIMENSION
+ * @param mipmaps levels, each half the size of the last down to 1 x 1
+ * @param format a raylib 5 PixelFormat
+ * @return 0 for an unknown format or a size no texture can have
+ */
+uint64_t packPixelBytes(uint32_t width, uint32_t height, uint32_t mipmaps,
+                        uint32_t format) {
+    // Bits per pixel by PixelFormat, from PIXELFORMAT_UNCOMPRESSED_GRAYSCALE
+    // (1) to PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA (24)
+    static const uint32_t BITS[25] = {0,  8,  16, 16, 24, 16, 16, 32, 32,
+                                      96, 128, 16, 48, 64, 4, 4,  8,  8,
+                                      4,  4,  8,  4,  4,  8,  2};
+    const uint32_t FIRST_DXT3 = 16, FIRST_COMPRESSED = 14, ASTC_8X8 = 24;
+    if (format == 0 || format > ASTC_8X8 || width == 0 || height == 0
+        || width > PACK_MAX_DIMENSION || height > PACK_MAX_DIMENSION
+        || mipmaps == 0 || mipmaps > 32)
+        return 0;
+    uint64_t bytes = 0;
+    for (uint32_t level = 0; level < mipmaps; level++) {
+        uint64_t levelBytes = (uint64_t)width * height * BITS[format] / 8;
+        // Compressed formats work on 4 x 4 blocks
+        if (width < 4 && height < 4 && format >= FIRST_COMPRESSED
+            && format < ASTC_8X8)
+            levelBytes = format < FIRST_DXT3 ? 8 : 16;
+        bytes += levelBytes;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Copies a texture's pixels into the pack to be written, stamped with
+ * the size and mtime of the file at name if there is one
+ * @param name what the game acquires it by, under PACK_NAME_SIZE bytes
+ * @param size bytes of pixels, every mipmap level included
+ * @return false if the name is too long or already in the pack, or size
+ * isn't packPixelBytes() of the rest
+ */
+bool AssetPackWriter::add(const char* name, uint32_t width, uint32_t height,
+                          uint32_t mipmaps, uint32_t format,
+                          const void* pixels, size_t size) {
+    if (strlen(name) >= static_cast<size_t>(PACK_NAME_SIZE)) return false;
+    if (size != packPixelBytes(width, height, mipmaps, format)) return false;
+    for (const PackTexture& texture : mTextures)
+        if (texture.name == name) return false;
+    mTextures.push_back({name, width, height, mipmaps, format, PACK_NO_ATLAS,
+                         0, 0, 0, size, 0, 0});
+    statSource(name, mTextures.back().sourceSize,
+               mTextures.back().sourceTime);
+    const uint8_t* bytes = static_cast<const uint8_t*>(pixels);
+    mPixels.push_back(std::vector<uint8_t>(bytes, bytes + size));
+    return true;
+}
+
+/**
+ * @brief Adds a sprite that's part of an atlas already added, so the game
+ * can acquire it by its own path. Stamped like add()
+ * @param name the sprite's path
+ * @param atlas the atlas texture's name
+ * @return false if the name is taken or too long, or there's no such atlas
+ */
+bool AssetPackWriter::addRegion(const char* name, const char* atlas,
+                                uint32_t x, uint32_t y, uint32_t width,
+                                uint32_t height) {
+    if (strlen(name) >= static_cast<size_t>(PACK_NAME_SIZE)) return false;
+    uint32_t atlasIndex = PACK_NO_ATLAS;
+    for (size_t i = 0; i < mTextures.size(); i++) {
+        if (mTextures[i].name == name) return false;
+        if (mTextures[i].name == atlas && mTextures[i].atlas == PACK_NO_ATLAS)
+            atlasIndex = static_cast<uint32_t>(i);
+    }
+    if (atlasIndex == PACK_NO_ATLAS) return false;
+    const PackTexture& texture = mTextures[atlasIndex];
+    if ((uint64_t)x + width > texture.width
+        || (uint64_t)y + height > texture.height)
+        return false;
+    mTextures.push_back({name, width, height, texture.mipmaps, texture.format,
+                         atlasIndex, x, y, 0, 0, 0, 0});
+    statSource(name, mTextures.back().sourceSize,
+               mTextures.back().sourceTime);
+    mPixels.push_back(std::vector<uint8_t>());
+    return true;
+}
+
+/**
+ * @brief Lays the pack out in memory, checksums it and writes it through a
+ * temporary file and a rename, so the game never maps half a pack
+ * @param flags PackFlags
+ * @return false if the file couldn't be written
+ */
+bool AssetPackWriter::write(const char* filepath, uint32_t flags) const {
+    size_t count = mTextures.size();
+    uint64_t offset = alignUp(PACK_HEADER_SIZE + count * PACK_ENTRY_SIZE);
+    std::vector<uint64_t> offsets(count);
+    for (size_t i = 0; i < count; i++) {
+        if (mTextures[i].size == 0) continue; // Regions have no pixels
+        offsets[i] = offset;
+        offset = alignUp(offset + mTextures[i].size);
+    }
+    std::vector<uint8_t> file(offset, 0); // Padding stays zero
+    uint8_t* entry = &file[PACK_HEADER_SIZE];
+    for (size_t i = 0; i < count; i++, entry += PACK_ENTRY_SIZE) {
+        const PackTexture& texture = mTextures[i];
+        memcpy(entry, texture.name.c_str(), texture.name.size());
+        uint8_t* fields = entry + PACK_NAME_SIZE;
+        writeUint32(fields, texture.width);
+        writeUint32(fields + 4, texture.height);
+        writeUint32(fields + 8, texture.mipmaps);
+        writeUint32(fields + 12, texture.format);
+        writeUint32(fields + 16, texture.atlas);
+        writeUint32(fields + 20, texture.x);
+        writeUint32(fields + 24, texture.y);
+        writeUint64(fields + 32, offsets[i]);
+        writeUint64(fields + 40, texture.size);
+        writeUint64(fields + 48, texture.sourceSize);
+        writeUint64(fields + 56, static_cast<uint64_t>(texture.sourceTime));
+        if (texture.size > 0)
+            memcpy(&file[offsets[i]], mPixels[i].data(), texture.size);
+    }
+    memcpy(&file[0], PACK_MAGIC, sizeof(PACK_MAGIC));
+    file[7] = PACK_VERSION;
+    writeUint32(&file[8], static_cast<uint32_t>(count));
+    writeUint32(&file[12], flags);
+    writeUint64(&file[16], offset);
+    writeUint64(&file[24], packChecksum(&file[PACK_HEADER_SIZE],
+                                        offset - PACK_HEADER_SIZE));
+
+    std::string temporary = std::string(filepath) + ".tmp";
+    FILE* out = fopen(temporary.c_str(), "wb");
+    if (!out) return false;
+    bool ok = fwrite(file.data(), 1, file.size(), out) == file.size();
+    ok = fclose(out) == 0 && ok;
+    remove(filepath); // rename() won't replace a file on Windows
+    if (ok && rename(temporary.c_str(), filepath) == 0) return true;
+    remove(temporary.c_str());
+    return false;
+}
+
+/**
+ * @brief Maps the pack read only and reads its directory
+ * @param verify checksum every byte first, which touches the whole file
+ * @return PACK_OK, or why the pack can't be used; it's closed if so
+ */
+PackStatus AssetPack::open(const char* filepath, bool verify) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return PACK_MISSING;
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0,
+                                     nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) :
+                           nullptr;
+    mFile = file;
+    mMapping = mapping;
+    if (!view) {
+        close();
+        return PACK_MISSING;
+    }
+    mData = static_cast<const uint8_t*>(view);
+    mSize = static_cast<size_t>(size.QuadPart);
+#else
+    int file = ::open(filepath, O_RDONLY);
+    if (file < 0) return PACK_MISSING;
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(file, &info) == 0 && info.st_size > 0)
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                    MAP_PRIVATE, file, 0);
+    ::close(file); // The mapping keeps the file alive
+    if (view == MAP_FAILED) return PACK_MISSING;
+    mData = static_cast<const uint8_t*>(view);
+    mSize = static_cast<size_t>(info.st_size);
+#endif
+    PackStatus status = parse(verify);
+    if (status != PACK_OK) close();
+    return status;
+}
+
+void AssetPack::close() {
+    if (mData) {
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+#else
+        munmap(const_cast<uint8_t*>(mData), mSize);
+#endif
+    }
+#ifdef _WIN32
+    if (mMapping) CloseHandle(mMapping);
+    if (mFile) CloseHandle(mFile);
+    mMapping = nullptr;
+    mFile = nullptr;
+#endif
+    mData = nullptr;
+    mSize = 0;
+    mFlags = 0;
+    mTextures.clear();
+}
+
+// Checks the header and checksum, then reads the directory. Every entry's
+// pixels must be inside the file and exactly as big as its size and format
+PackStatus AssetPack::parse(bool verify) {
+    if (mSize < PACK_HEADER_SIZE) return PACK_TRUNCATED;
+    if (memcmp(mData, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0)
+        return PACK_BAD_MAGIC;
+    if (mData[7] != PACK_VERSION) return PACK_BAD_VERSION;
+    uint32_t count = readUint32(mData + 8);
+    if (readUint64(mData + 16) != mSize
+        || PACK_HEADER_SIZE + (uint64_t)count * PACK_ENTRY_SIZE > mSize)
+        return PACK_TRUNCATED;
+    if (verify
+        && packChecksum(mData + PACK_HEADER_SIZE, mSize - PACK_HEADER_SIZE)
+               != readUint64(mData + 24))
+        return PACK_BAD_CHECKSUM;
+    mFlags = readUint32(mData + 12);
+    mTextures.resize(count);
+    const uint8_t* entry = mData + PACK_HEADER_SIZE;
+    for (uint32_t i = 0; i < count; i++, entry += PACK_ENTRY_SIZE) {
+        PackTexture& texture = mTextures[i];
+        texture.name.assign(reinterpret_cast<const char*>(entry),
+                            strnlen(reinterpret_cast<const char*>(entry),
+                                    PACK_NAME_SIZE));
+        const uint8_t* fields = entry + PACK_NAME_SIZE;
+        texture.width = readUint32(fields);
+        texture.height = readUint32(fields + 4);
+        texture.mipmaps = readUint32(fields + 8);
+        texture.format = readUint32(fields + 12);
+        texture.atlas = readUint32(fields + 16);
+        texture.x = readUint32(fields + 20);
+        texture.y = readUint32(fields + 24);
+        texture.offset = readUint64(fields + 32);
+        texture.size = readUint64(fields + 40);
+        texture.sourceSize = readUint64(fields + 48);
+        texture.sourceTime = static_cast<int64_t>(readUint64(fields + 56));
+        if (texture.offset > mSize || texture.size > mSize - texture.offset)
+            return PACK_TRUNCATED;
+        // Uploads read as many bytes as the size and format say, which the
+        // checksum doesn't cover when verify is off
+        uint64_t expected =
+            texture.atlas == PACK_NO_ATLAS ?
+                packPixelBytes(texture.width, texture.height, texture.mipmaps,
+                               texture.format) :
+                0;
+        if (texture.size != expected
+            || (texture.atlas == PACK_NO_ATLAS && expected == 0))
+            return PACK_BAD_SIZE;
+    }
+    // A region must sit inside a texture that has pixels
+    for (const PackTexture& texture : mTextures) {
+        if (texture.atlas == PACK_NO_ATLAS) continue;
+        if (texture.atlas >= count) return PACK_BAD_REGION;
+        const PackTexture& atlas = mTextures[texture.atlas];
+        if (atlas.atlas != PACK_NO_ATLAS
+            || (uint64_t)texture.x + texture.width > atlas.width
+            || (uint64_t)texture.y + texture.height > atlas.height)
+            return PACK_BAD_REGION;
+    }
+    return PACK_OK;
+}
+
+/**
+ * @brief Looks a texture up by the path the game would load it from
+ * @return nullptr if the pack doesn't have it
+ */
+const PackTexture* AssetPack::find(const char* name) const {
+    for (const PackTexture& texture : mTextures)
+        if (texture.name == name) return &texture;
+    return nullptr;
+}
+
+/**
+ * @brief Checks the file a texture was packed from against its stamp, so an
+ * image edited without `make pack` is loaded from the file instead. One
+ * stat() per texture acquired for the first time
+ * @return false if the file is there and its size or mtime changed
+ */
+bool AssetPack::isCurrent(const PackTexture& texture) const {
+    if (texture.sourceSize == 0 && texture.sourceTime == 0) return true;
+    uint64_t size;
+    int64_t time;
+    if (!statSource(texture.name.c_str(), size, time)) return true;
+    return size == texture.sourceSize && time == texture.sourceTime;
+}
+
+// Pixels inside the mapping, valid until close()
+const void* AssetPack::getPixels(const PackTexture& texture) const {
+    return mData + texture.offset;
+}
+
+const char* AssetPack::describe(PackStatus status) {
+    switch (status) {
+    case PACK_OK : return "ok";
+    case PACK_MISSING : return "missing";
+    case PACK_TRUNCATED : return "truncated";
+    case PACK_BAD_MAGIC : return "not a pack";
+    case PACK_BAD_VERSION : return "wrong version";
+    case PACK_BAD_CHECKSUM : return "checksum mismatch";
+    case PACK_BAD_REGION : return "region outside its atlas";
+    case PACK_BAD_SIZE : return "pixel size doesn't match the texture";
+    }
+    return "unknown";
+}
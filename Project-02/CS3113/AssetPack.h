@@ -0,0 +1,113 @@
+// Prebaked textures: every image already decoded to raw pixels (optionally
+// with mipmaps) in one aligned file. The game maps the file and uploads
+// straight from the mapping, so there's no PNG inflate and no file per
+// texture. Sprites can share one atlas texture, each a region of it.
+// tools/pack_assets writes it. Raylib-free
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+constexpr int PACK_NAME_SIZE = 48;      // Bytes per name, NUL padded
+constexpr uint64_t PACK_ALIGNMENT = 64; // Every texture's pixels start here
+constexpr uint32_t PACK_NO_ATLAS = 0xFFFFFFFF;
+constexpr uint32_t PACK_MAX_DIMENSION = 65536; // Widest or tallest texture
+
+enum PackFlags : uint32_t {
+    PACK_MIPMAPS = 1, // Textures carry their whole mipmap chain
+    PACK_ATLAS = 2,   // Sprites are regions of one atlas texture
+};
+
+enum PackStatus {
+    PACK_OK,
+    PACK_MISSING,      // No file, or it can't be mapped
+    PACK_TRUNCATED,    // Shorter than its header or directory says
+    PACK_BAD_MAGIC,    // Not a pack
+    PACK_BAD_VERSION,  // A pack this build can't read
+    PACK_BAD_CHECKSUM, // Corrupt, or changed since it was written
+    PACK_BAD_REGION,   // A sprite outside the atlas it's part of
+    PACK_BAD_SIZE,     // Pixel bytes don't fit the size and format given
+};
+
+// One texture in the directory, or a region of an atlas texture that's
+// also in it. format is a raylib PixelFormat
+struct PackTexture {
+    std::string name; // Path the game loads it by, e.g. "assets/ball.png"
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipmaps;
+    uint32_t format;
+    uint32_t atlas;  // Index of the texture this is a region of, or
+                     // PACK_NO_ATLAS if it has its own pixels
+    uint32_t x;      // Region's top-left corner in the atlas
+    uint32_t y;
+    uint64_t offset; // From the start of the file, 0 for regions
+    uint64_t size;   // Bytes of pixels, every mipmap level included
+    uint64_t sourceSize; // Bytes of the file at name when it was packed,
+    int64_t sourceTime;  // and its mtime; both 0 if there was no such file
+};
+
+class AssetPackWriter {
+public:
+    bool add(const char* name, uint32_t width, uint32_t height,
+             uint32_t mipmaps, uint32_t format, const void* pixels,
+             size_t size);
+    bool addRegion(const char* name, const char* atlas, uint32_t x,
+                   uint32_t y, uint32_t width, uint32_t height);
+    bool write(const char* filepath, uint32_t flags) const;
+
+    int size() const { return static_cast<int>(mTextures.size()); }
+
+private:
+    std::vector<PackTexture> mTextures; // Offsets are filled in by write()
+    std::vector<std::vector<uint8_t>> mPixels;
+};
+
+class AssetPack {
+public:
+    AssetPack() = default;
+    ~AssetPack() { close(); }
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    PackStatus open(const char* filepath, bool verify = true);
+    void close();
+
+    const PackTexture* find(const char* name) const;
+    const void* getPixels(const PackTexture& texture) const;
+    bool isCurrent(const PackTexture& texture) const;
+
+    bool isOpen() const { return mData != nullptr; }
+
+    int size() const { return static_cast<int>(mTextures.size()); }
+
+    const PackTexture& get(int index) const { return mTextures[index]; }
+
+    uint32_t getFlags() const { return mFlags; }
+
+    size_t getFileSize() const { return mSize; }
+
+    static const char* describe(PackStatus status);
+
+private:
+    PackStatus parse(bool verify);
+
+    const uint8_t* mData = nullptr; // The mapping, read only
+    size_t mSize = 0;
+    uint32_t mFlags = 0;
+    std::vector<PackTexture> mTextures;
+#ifdef _WIN32
+    void* mFile = nullptr; // HANDLEs, kept opaque so windows.h stays out
+    void* mMapping = nullptr;
+#endif
+};
+
+uint64_t packChecksum(const uint8_t* data, size_t size);
+uint64_t packPixelBytes(uint32_t width, uint32_t height, uint32_t mipmaps,
+                        uint32_t format);
+
+#endif // ASSET_PACK_H
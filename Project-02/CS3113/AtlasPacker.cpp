@@ -0,0 +1,128 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <climits>
+
+// Widths tried between the widest sprite and maxSize
+static const int WIDTH_STEPS = 64;
+
+// Top edge of the packed area over [x, x + width), one span per change
+struct Skyline {
+    int x;
+    int y;
+    int width;
+};
+
+/**
+ * @brief Packs slots (sprites plus their borders) bottom-left into an atlas
+ * atlasWidth wide, tallest first
+ * @return the atlas height, or INT_MAX if a slot didn't fit under maxHeight
+ */
+static int packSkyline(const std::vector<AtlasRect>& slots,
+                       const std::vector<int>& order, int atlasWidth,
+                       int maxHeight, std::vector<AtlasRect>& placed) {
+    std::vector<Skyline> skyline(1, Skyline {0, 0, atlasWidth});
+    int height = 0;
+    for (int index : order) {
+        const AtlasRect& slot = slots[index];
+        // Lowest spot, then leftmost, where the slot rests on the skyline
+        int bestY = INT_MAX, bestX = 0;
+        size_t bestSpan = 0;
+        for (size_t span = 0; span < skyline.size(); span++) {
+            int x = skyline[span].x;
+            if (x + slot.width > atlasWidth) break;
+            int y = 0;
+            for (size_t next = span;
+                 next < skyline.size() && skyline[next].x < x + slot.width;
+                 next++)
+                y = std::max(y, skyline[next].y);
+            if (y < bestY) {
+                bestY = y;
+                bestX = x;
+                bestSpan = span;
+            }
+        }
+        if (bestY == INT_MAX || bestY + slot.height > maxHeight) return INT_MAX;
+        placed[index].x = bestX;
+        placed[index].y = bestY;
+        height = std::max(height, bestY + slot.height);
+
+        // Raise the skyline under the slot: spans it covers go, a span it
+        // only partly covers keeps its uncovered right end
+        int right = bestX + slot.width;
+        size_t end = bestSpan;
+        while (end < skyline.size() && skyline[end].x + skyline[end].width
+                                           <= right)
+            end++;
+        if (end < skyline.size() && skyline[end].x < right) {
+            skyline[end].width -= right - skyline[end].x;
+            skyline[end].x = right;
+        }
+        skyline.erase(skyline.begin() + bestSpan, skyline.begin() + end);
+        skyline.insert(skyline.begin() + bestSpan,
+                       Skyline {bestX, bestY + slot.height, slot.width});
+        // Merge equal neighbours so the span count stays small
+        for (size_t span = 1; span < skyline.size();) {
+            if (skyline[span].y == skyline[span - 1].y) {
+                skyline[span - 1].width += skyline[span].width;
+                skyline.erase(skyline.begin() + span);
+            } else {
+                span++;
+            }
+        }
+    }
+    return height;
+}
+
+/**
+ * @brief Places every rect in one atlas, keeping the smallest atlas of the
+ * widths tried. Each sprite gets padding pixels of border on every side, for
+ * the packer's caller to fill by extruding the sprite's edges so filtering
+ * never samples a neighbour
+ * @param rects sizes in; x and y of each sprite, inside its border, out
+ * @param padding border on each side of every sprite
+ * @param maxSize most pixels the atlas may be in either direction
+ * @param outWidth
+ * @param outHeight
+ * @return false if the rects can't fit in maxSize by maxSize
+ */
+bool packAtlas(std::vector<AtlasRect>& rects, int padding, int maxSize,
+               int& outWidth, int& outHeight) {
+    std::vector<AtlasRect> slots = rects;
+    std::vector<int> order(rects.size());
+    int widest = 0;
+    for (size_t i = 0; i < rects.size(); i++) {
+        slots[i].width = rects[i].width + 2 * padding;
+        slots[i].height = rects[i].height + 2 * padding;
+        widest = std::max(widest, slots[i].width);
+        order[i] = static_cast<int>(i);
+    }
+    if (widest > maxSize) return false;
+    std::stable_sort(order.begin(), order.end(), [&slots](int a, int b) {
+        return slots[a].height > slots[b].height;
+    });
+
+    long long bestArea = LLONG_MAX;
+    std::vector<AtlasRect> placed = slots, best;
+    int step = std::max(1, (maxSize - widest) / WIDTH_STEPS);
+    for (int width = widest; width <= maxSize; width += step) {
+        int height = packSkyline(slots, order, width, maxSize, placed);
+        if (height == INT_MAX) continue;
+        // Trim the width to what was used
+        int used = 0;
+        for (size_t i = 0; i < placed.size(); i++)
+            used = std::max(used, placed[i].x + slots[i].width);
+        long long area = static_cast<long long>(used) * height;
+        if (area < bestArea) {
+            bestArea = area;
+            best = placed;
+            outWidth = used;
+            outHeight = height;
+        }
+    }
+    if (bestArea == LLONG_MAX) return false;
+    for (size_t i = 0; i < rects.size(); i++) {
+        rects[i].x = best[i].x + padding;
+        rects[i].y = best[i].y + padding;
+    }
+    return true;
+}
@@ -0,0 +1,23 @@
+// Packs rectangles into one texture atlas with a skyline bottom-left
+// packer, trying atlas widths until it finds the smallest area. Used offline
+// by tools/pack_assets; raylib-free so bench/atlas_bench can check it
+
+#ifndef ATLAS_PACKER_H
+#define ATLAS_PACKER_H
+
+#include <vector>
+
+constexpr int ATLAS_MAX_SIZE = 8192; // Widest and tallest atlas we make
+constexpr int ATLAS_PADDING = 2;     // Border around each sprite, extruded
+
+struct AtlasRect {
+    int width;
+    int height;
+    int x = 0; // Where packAtlas() put the sprite, inside its border
+    int y = 0;
+};
+
+bool packAtlas(std::vector<AtlasRect>& rects, int padding, int maxSize,
+               int& outWidth, int& outHeight);
+
+#endif // ATLAS_PACKER_H
@@ -0,0 +1,165 @@
+#include "BallGrid.h"
+#include <algorithm>
+
+BallGrid::BallGrid(float cellSize, float width, float height) :
+    mCellSize {cellSize},
+    mColumns {std::max(1, static_cast<int>(ceilf(width / cellSize)))},
+    mRows {std::max(1, static_cast<int>(ceilf(height / cellSize)))},
+    mCellStart(mColumns * mRows + 1) { }
+
+/**
+ * @brief Allocates the per-ball arrays for up to balls balls, so collide()
+ * doesn't allocate unless more balls than that are touching at once
+ * @param balls
+ */
+void BallGrid::reserve(int balls) {
+    mBallCell.reserve(balls);
+    mCellBalls.reserve(balls);
+    mContacts.reserve(balls);
+}
+
+/**
+ * @brief Finds the cell containing a point. Points off the arena (balls on
+ * their way out to score) are clamped into the border cells
+ */
+int BallGrid::cellOf(float x, float y) const {
+    int column = static_cast<int>(x / mCellSize);
+    int row = static_cast<int>(y / mCellSize);
+    column = std::min(std::max(column, 0), mColumns - 1);
+    row = std::min(std::max(row, 0), mRows - 1);
+    return row * mColumns + column;
+}
+
+/**
+ * @brief Bins the balls into the grid with a counting sort, then tests each
+ * ball against its own cell and the 4 forward neighbours so every pair is
+ * tested once
+ * @param posX, posY ball centres
+ * @param count
+ * @param radius shared ball radius, at most half the cell size
+ * @param contacts overlapping pairs, in ascending order of first ball's cell
+ * @return the number of narrow phase pair tests
+ */
+int BallGrid::findContacts(const float* posX, const float* posY, int count,
+                           float radius, std::vector<BallPair>& contacts) {
+    contacts.clear();
+    mBallCell.resize(count);
+    mCellBalls.resize(count);
+    std::fill(mCellStart.begin(), mCellStart.end(), 0);
+    // Count balls per cell, then prefix sum into offsets
+    for (int i = 0; i < count; i++) {
+        mBallCell[i] = cellOf(posX[i], posY[i]);
+        mCellStart[mBallCell[i] + 1]++;
+    }
+    for (size_t cell = 1; cell < mCellStart.size(); cell++)
+        mCellStart[cell] += mCellStart[cell - 1];
+    // Scatter ball indices into their cells, in index order
+    mCursor.assign(mCellStart.begin(), mCellStart.end() - 1);
+    for (int i = 0; i < count; i++) mCellBalls[mCursor[mBallCell[i]]++] = i;
+
+    const float touchSq = (2.0f * radius) * (2.0f * radius);
+    // Own cell, then right, below-left, below, below-right
+    const int offsetColumn[5] = {0, 1, -1, 0, 1};
+    const int offsetRow[5] = {0, 0, 1, 1, 1};
+    int tests = 0;
+    for (int row = 0; row < mRows; row++) {
+        for (int column = 0; column < mColumns; column++) {
+            int cell = row * mColumns + column;
+            for (int a = mCellStart[cell]; a < mCellStart[cell + 1]; a++) {
+                int i = mCellBalls[a];
+                for (int n = 0; n < 5; n++) {
+                    int otherColumn = column + offsetColumn[n];
+                    int otherRow = row + offsetRow[n];
+                    if (otherColumn < 0 || otherColumn >= mColumns
+                        || otherRow >= mRows)
+                        continue;
+                    int other = otherRow * mColumns + otherColumn;
+                    // Same cell: only balls after this one
+                    int b = n == 0 ? a + 1 : mCellStart[other];
+                    for (; b < mCellStart[other + 1]; b++) {
+                        int j = mCellBalls[b];
+                        tests++;
+                        float dx = posX[j] - posX[i];
+                        float dy = posY[j] - posY[i];
+                        if (dx * dx + dy * dy < touchSq)
+                            contacts.push_back(
+                                {std::min(i, j), std::max(i, j)});
+                    }
+                }
+            }
+        }
+    }
+    return tests;
+}
+
+/**
+ * @brief Finds and resolves every ball-ball contact in the pool
+ * @param balls
+ * @return the number of contacts resolved
+ */
+int BallGrid::collide(BallPool& balls) {
+    mPairTests = findContacts(balls.getPositionsX(), balls.getPositionsY(),
+                              balls.size(), balls.getRadius(), mContacts);
+    resolveBallContacts(balls, mContacts);
+    return getContacts();
+}
+
+/**
+ * @brief Bounces touching balls off each other as equal masses, swapping
+ * their velocity along the contact normal, and pushes them apart. Pairs that
+ * are already separating are only pushed apart
+ * @param balls
+ * @param contacts
+ */
+void resolveBallContacts(BallPool& balls,
+                         const std::vector<BallPair>& contacts) {
+    for (const BallPair& pair : contacts) {
+        BallState a = balls.get(pair.first);
+        BallState b = balls.get(pair.second);
+        float dx = b.position.x - a.position.x;
+        float dy = b.position.y - a.position.y;
+        float dist = sqrtf(dx * dx + dy * dy);
+        float touching = a.radius + b.radius;
+        if (dist >= touching) continue; // Separated by an earlier contact
+        // Contact normal from a to b; pick one if the centres coincide
+        Vec2 normal = dist > PHYSICS_EPSILON ? Vec2 {dx / dist, dy / dist} :
+                                               Vec2 {1.0f, 0.0f};
+        // Push apart, half each, staying inside the screen vertically
+        float push = (touching - dist) / 2.0f;
+        a.position.x -= normal.x * push;
+        a.position.y -= normal.y * push;
+        b.position.x += normal.x * push;
+        b.position.y += normal.y * push;
+        a.position.y = std::min(std::max(a.position.y, a.radius),
+                                SCREEN_HEIGHT - a.radius);
+        b.position.y = std::min(std::max(b.position.y, b.radius),
+                                SCREEN_HEIGHT - b.radius);
+        // Velocities, since balls can have different speeds
+        Vec2 velA = {a.movement.x * a.speed, a.movement.y * a.speed};
+        Vec2 velB = {b.movement.x * b.speed, b.movement.y * b.speed};
+        float approach = (velA.x - velB.x) * normal.x
+                       + (velA.y - velB.y) * normal.y;
+        if (approach > 0.0f) {
+            // Swap the normal components
+            velA.x -= approach * normal.x;
+            velA.y -= approach * normal.y;
+            velB.x += approach * normal.x;
+            velB.y += approach * normal.y;
+            float speedA = sqrtf(velA.x * velA.x + velA.y * velA.y);
+            float speedB = sqrtf(velB.x * velB.x + velB.y * velB.y);
+            // Keep the old velocity rather than stopping dead
+            if (speedA > PHYSICS_EPSILON) {
+                a.movement = {velA.x / speedA, velA.y / speedA};
+                a.speed = speedA;
+            }
+            if (speedB > PHYSICS_EPSILON) {
+                b.movement = {velB.x / speedB, velB.y / speedB};
+                b.speed = speedB;
+            }
+        }
+        balls.set(pair.first, a);
+        balls.set(pair.second, b);
+        balls.markTurned(pair.first);
+        balls.markTurned(pair.second);
+    }
+}
@@ -0,0 +1,45 @@
+// Uniform grid broadphase for ball-ball collisions. Cells are one ball
+// diameter wide, so a ball can only touch balls in its own or adjacent cells
+
+#ifndef BALL_GRID_H
+#define BALL_GRID_H
+
+#include "BallPool.h"
+#include <vector>
+
+struct BallPair {
+    int first;
+    int second; // Always greater than first
+};
+
+class BallGrid {
+public:
+    explicit BallGrid(float cellSize = BALL_SIZE, float width = SCREEN_WIDTH,
+                      float height = SCREEN_HEIGHT);
+
+    void reserve(int balls);
+    int findContacts(const float* posX, const float* posY, int count,
+                     float radius, std::vector<BallPair>& contacts);
+    int collide(BallPool& balls);
+
+    int getPairTests() const { return mPairTests; }
+
+    int getContacts() const { return static_cast<int>(mContacts.size()); }
+
+private:
+    int cellOf(float x, float y) const;
+
+    float mCellSize;
+    int mColumns, mRows;
+    std::vector<int> mCellStart; // Counting sort offsets, one per cell + 1
+    std::vector<int> mCellBalls; // Ball indices grouped by cell
+    std::vector<int> mBallCell;  // Cell of each ball
+    std::vector<int> mCursor;    // Next free slot per cell while scattering
+    std::vector<BallPair> mContacts;
+    int mPairTests = 0;
+};
+
+void resolveBallContacts(BallPool& balls,
+                         const std::vector<BallPair>& contacts);
+
+#endif // BALL_GRID_H
@@ -0,0 +1,295 @@
+#include "BallPool.h"
+#include "SweepKernel.h"
+#include <algorithm>
+#include <string.h>
+
+BallPool::BallPool(float radius, int capacity) : mRadius {radius} {
+    reserve(capacity);
+}
+
+/**
+ * @brief Allocates room for capacity balls, so activating up to that many
+ * doesn't allocate. Never shrinks
+ * @param capacity
+ */
+void BallPool::reserve(int capacity) {
+    if (capacity <= mCapacity) return;
+    mPosX.resize(capacity);
+    mPosY.resize(capacity);
+    mMoveX.resize(capacity);
+    mMoveY.resize(capacity);
+    mSpeed.resize(capacity);
+    mSpeedMultiplier.resize(capacity);
+    mLastCollision.resize(capacity);
+    mIndexHandle.resize(capacity);
+    mHandleIndex.resize(capacity, -1);
+    // New handles go under the old free ones, highest first, so activate()
+    // hands handles out in order
+    mFreeHandles.reserve(capacity);
+    mFreeHandles.insert(mFreeHandles.begin(), capacity - mCapacity, 0);
+    for (int i = 0; i < capacity - mCapacity; i++)
+        mFreeHandles[i] = capacity - 1 - i;
+    // Enough results for the finest split. Their lists share one slot per
+    // ball, however update() splits the pool
+    int ranges = (capacity + MIN_RANGE_BALLS - 1) / MIN_RANGE_BALLS;
+    if (static_cast<int>(mRangeResults.size()) < ranges)
+        mRangeResults.resize(ranges);
+    mRangeScored.resize(capacity);
+    mRangeTurned.resize(capacity);
+    mTurned.reserve(capacity);
+    mCapacity = capacity;
+}
+
+/**
+ * @brief Bytes allocated for the pool: the ball arrays, the handle tables and
+ * free list, the turned list and the per-range results
+ */
+size_t BallPool::memoryUsage() const {
+    size_t bytes = mPosX.capacity() * BYTES_PER_BALL
+                 + mIndexHandle.capacity() * sizeof(BallHandle)
+                 + mHandleIndex.capacity() * sizeof(int)
+                 + mFreeHandles.capacity() * sizeof(BallHandle)
+                 + mTurned.capacity() * sizeof(int)
+                 + mRangeResults.capacity() * sizeof(RangeResult)
+                 + mRangeScored.capacity() * sizeof(int)
+                 + mRangeTurned.capacity() * sizeof(int);
+    return bytes;
+}
+
+/**
+ * @brief Turns on a ball at the end of the active ones, zeroed until reset.
+ * O(1) and allocation free while under capacity; past it the pool doubles
+ * @return the ball's handle
+ */
+BallHandle BallPool::activate() {
+    if (mCount == mCapacity) {
+        mGrowths++;
+        reserve(std::max(64, mCapacity * 2));
+    }
+    BallHandle handle = mFreeHandles.back();
+    mFreeHandles.pop_back();
+    int index = mCount++;
+    mIndexHandle[index] = handle;
+    mHandleIndex[handle] = index;
+    mPosX[index] = mPosY[index] = 0.0f;
+    mMoveX[index] = mMoveY[index] = 0.0f;
+    mSpeed[index] = mBaseSpeed;
+    mSpeedMultiplier[index] = 1.0f;
+    mLastCollision[index] = NO_PADDLE;
+    return handle;
+}
+
+/**
+ * @brief Turns a ball off in O(1) by moving the last active ball into its
+ * slot, so the active balls stay packed
+ * @param handle
+ */
+void BallPool::deactivate(BallHandle handle) {
+    int index = mHandleIndex[handle];
+    int last = --mCount;
+    if (index != last) {
+        mPosX[index] = mPosX[last];
+        mPosY[index] = mPosY[last];
+        mMoveX[index] = mMoveX[last];
+        mMoveY[index] = mMoveY[last];
+        mSpeed[index] = mSpeed[last];
+        mSpeedMultiplier[index] = mSpeedMultiplier[last];
+        mLastCollision[index] = mLastCollision[last];
+        mIndexHandle[index] = mIndexHandle[last];
+        mHandleIndex[mIndexHandle[index]] = index;
+        mAllTurned = true; // Another ball is at index now
+    }
+    mHandleIndex[handle] = -1;
+    mFreeHandles.push_back(handle);
+}
+
+/**
+ * @brief Activates or deactivates balls at the end until count are active.
+ * Balls before count keep their slots; new ones are zeroed until reset
+ * @param count
+ */
+void BallPool::resize(int count) {
+    if (count != mCount) mAllTurned = true;
+    while (mCount > count) deactivate(mIndexHandle[mCount - 1]);
+    if (count > mCapacity) { // Grow once rather than doubling repeatedly
+        mGrowths++;
+        reserve(count);
+    }
+    while (mCount < count) activate();
+}
+
+/**
+ * @brief Lists a ball in getTurned(), e.g. after changing its movement
+ * with set(). Never allocates under capacity
+ * @param index
+ */
+void BallPool::markTurned(int index) {
+    if (mAllTurned) return;
+    if (static_cast<int>(mTurned.size()) >= mCount) {
+        mAllTurned = true; // Cheaper to go over every ball than the list
+        return;
+    }
+    mTurned.push_back(index);
+}
+
+void BallPool::clearTurned() {
+    mTurned.clear();
+    mAllTurned = false;
+}
+
+/**
+ * @brief Resets every ball in index order, so serves are reproducible for a
+ * given rng seed
+ * @param rng
+ */
+void BallPool::resetAll(Rng& rng) {
+    for (int i = 0; i < mCount; i++) reset(i, rng);
+}
+
+void BallPool::reset(int index, Rng& rng) {
+    BallState state = get(index);
+    resetBall(state, rng);
+    set(index, state);
+    markTurned(index);
+}
+
+/**
+ * @brief Steps every ball through the physics core, scoring balls that leave
+ * the screen. Ranges of balls can run on workers in parallel, a few per
+ * worker but none under MIN_RANGE_BALLS balls. Each keeps its own score
+ * deltas and list of balls to serve, which are merged afterwards in ball
+ * order, so the outcome is identical to running serially
+ * @param deltaTime
+ * @param paddles left and right paddle, indexed by PaddleSide
+ * @param leftScore
+ * @param rightScore
+ * @param rng used to serve balls that scored, in ball order
+ * @param workers optional pool to split the balls across
+ */
+void BallPool::update(float deltaTime, const PaddleState paddles[2],
+                      int& leftScore, int& rightScore, Rng& rng,
+                      WorkerPool* workers) {
+    int ranges = 1;
+    if (workers)
+        ranges = std::max(1, std::min(workers->size() * RANGES_PER_WORKER,
+                                      mCount / MIN_RANGE_BALLS));
+    if (static_cast<int>(mRangeResults.size()) < ranges)
+        mRangeResults.resize(ranges); // Only if reserve() wasn't called
+    int rangeSize = (mCount + ranges - 1) / ranges;
+    auto task = [&](int range) {
+        int begin = range * rangeSize;
+        int end = std::min(mCount, begin + rangeSize);
+        updateRange(begin, end, deltaTime, paddles, mRangeResults[range]);
+    };
+    if (ranges == 1)
+        task(0);
+    else
+        workers->run(ranges, task);
+    // Merge in range order: scores, then serves in ascending ball order
+    for (int range = 0; range < ranges; range++) {
+        RangeResult& result = mRangeResults[range];
+        leftScore += result.scores[LEFT_PADDLE];
+        rightScore += result.scores[RIGHT_PADDLE];
+        for (int i = 0; i < result.turned; i++)
+            markTurned(mRangeTurned[result.begin + i]);
+        for (int i = 0; i < result.scored; i++)
+            reset(mRangeScored[result.begin + i], rng);
+    }
+}
+
+/**
+ * @brief Moves balls [begin, end), sweeping a block at a time against both
+ * paddles with sweepBatch(). Touches nothing outside its range
+ */
+void BallPool::updateRange(int begin, int end, float deltaTime,
+                           const PaddleState paddles[2], RangeResult& result) {
+    result.begin = begin;
+    result.scores[LEFT_PADDLE] = result.scores[RIGHT_PADDLE] = 0;
+    result.scored = result.turned = 0;
+    float tLeft[SWEEP_BLOCK], leftX[SWEEP_BLOCK], leftY[SWEEP_BLOCK];
+    float tRight[SWEEP_BLOCK], rightX[SWEEP_BLOCK], rightY[SWEEP_BLOCK];
+    for (int block = begin; block < end; block += SWEEP_BLOCK) {
+        int count = std::min(SWEEP_BLOCK, end - block);
+        sweepBatch(&mPosX[block], &mPosY[block], &mMoveX[block],
+                   &mMoveY[block], &mSpeed[block], mRadius, count,
+                   paddles[LEFT_PADDLE], deltaTime, tLeft, leftX, leftY);
+        sweepBatch(&mPosX[block], &mPosY[block], &mMoveX[block],
+                   &mMoveY[block], &mSpeed[block], mRadius, count,
+                   paddles[RIGHT_PADDLE], deltaTime, tRight, rightX, rightY);
+        for (int j = 0; j < count; j++) {
+            int i = block + j;
+            BallState state = get(i);
+            bool hitPaddle;
+            int scorer =
+                moveBall(state, paddles, deltaTime, tLeft[j],
+                         {leftX[j], leftY[j]}, tRight[j],
+                         {rightX[j], rightY[j]}, hitPaddle);
+            if (hitPaddle) mRangeTurned[begin + result.turned++] = i;
+            set(i, state);
+            if (scorer != NO_PADDLE) {
+                result.scores[scorer]++;
+                mRangeScored[begin + result.scored++] = i;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copies every ball's state, array by array, into stateSize() bytes
+ * @param out
+ */
+void BallPool::saveState(uint8_t* out) const {
+    size_t floats = mCount * sizeof(float);
+    const float* arrays[] = {mPosX.data(),   mPosY.data(),
+                             mMoveX.data(),  mMoveY.data(),
+                             mSpeed.data(),  mSpeedMultiplier.data()};
+    for (const float* array : arrays) {
+        memcpy(out, array, floats);
+        out += floats;
+    }
+    memcpy(out, mLastCollision.data(), mCount * sizeof(int8_t));
+}
+
+/**
+ * @brief Restores balls written by saveState(), resizing the pool to count
+ * @param in
+ * @param count
+ */
+void BallPool::loadState(const uint8_t* in, int count) {
+    resize(count);
+    size_t floats = mCount * sizeof(float);
+    float* arrays[] = {mPosX.data(),  mPosY.data(),  mMoveX.data(),
+                       mMoveY.data(), mSpeed.data(), mSpeedMultiplier.data()};
+    for (float* array : arrays) {
+        memcpy(array, in, floats);
+        in += floats;
+    }
+    memcpy(mLastCollision.data(), in, mCount * sizeof(int8_t));
+    mAllTurned = true;
+}
+
+BallState BallPool::get(int index) const {
+    BallState state;
+    state.position = {mPosX[index], mPosY[index]};
+    state.movement = {mMoveX[index], mMoveY[index]};
+    state.speed = mSpeed[index];
+    state.baseSpeed = mBaseSpeed;
+    state.speedMultiplier = mSpeedMultiplier[index];
+    state.radius = mRadius;
+    state.lastCollision = mLastCollision[index];
+    return state;
+}
+
+/**
+ * @brief Stores a ball's state. Base speed and radius are shared by the pool,
+ * so those fields of state are ignored
+ */
+void BallPool::set(int index, const BallState& state) {
+    mPosX[index] = state.position.x;
+    mPosY[index] = state.position.y;
+    mMoveX[index] = state.movement.x;
+    mMoveY[index] = state.movement.y;
+    mSpeed[index] = state.speed;
+    mSpeedMultiplier[index] = state.speedMultiplier;
+    mLastCollision[index] = static_cast<int8_t>(state.lastCollision);
+}
@@ -0,0 +1,113 @@
+// Structure-of-arrays ball storage. Every ball in a pool shares a radius and
+// base speed, so only the per-ball physics state is stored, in flat arrays.
+// Arrays are allocated up front for a capacity; active balls are packed at
+// the front, and turning balls on and off never touches the heap
+
+#ifndef BALL_POOL_H
+#define BALL_POOL_H
+
+#include "Physics.h"
+#include "WorkerPool.h"
+#include <stddef.h>
+#include <vector>
+
+typedef int BallHandle; // Stays with a ball while it's active
+constexpr BallHandle NO_BALL = -1;
+
+class BallPool {
+public:
+    // Bytes of per-ball state (position, movement, speed, multiplier, paddle)
+    static constexpr size_t BYTES_PER_BALL = 6 * sizeof(float) + sizeof(int8_t);
+
+    explicit BallPool(float radius = BALL_SIZE / 2.0f, int capacity = 0);
+
+    void reserve(int capacity);
+    BallHandle activate();
+    void deactivate(BallHandle handle);
+    void resize(int count);
+    void setBaseSpeed(float speed) { mBaseSpeed = speed; }
+    void resetAll(Rng& rng);
+    void reset(int index, Rng& rng);
+    void update(float deltaTime, const PaddleState paddles[2], int& leftScore,
+                int& rightScore, Rng& rng, WorkerPool* workers = nullptr);
+
+    size_t stateSize() const { return mCount * BYTES_PER_BALL; }
+
+    void saveState(uint8_t* out) const;
+    void loadState(const uint8_t* in, int count);
+
+    BallState get(int index) const;
+    void set(int index, const BallState& state);
+
+    int size() const { return mCount; }
+
+    int capacity() const { return mCapacity; }
+
+    // Index of an active ball in the arrays; changes when others deactivate
+    int indexOf(BallHandle handle) const { return mHandleIndex[handle]; }
+
+    // Times activate() found the pool full and had to reallocate
+    int getGrowthCount() const { return mGrowths; }
+
+    float getRadius() const { return mRadius; }
+
+    float getBaseSpeed() const { return mBaseSpeed; }
+
+    size_t memoryUsage() const;
+
+    const float* getPositionsX() const { return mPosX.data(); }
+
+    const float* getPositionsY() const { return mPosY.data(); }
+
+    // Balls whose course changed since clearTurned(): paddle hits, serves
+    // and ball-ball contacts, but not wall bounces. Once as many are listed
+    // as there are balls, or after resize() or loadState(), it's all of them
+    const std::vector<int>& getTurned() const { return mTurned; }
+
+    bool allTurned() const { return mAllTurned; }
+
+    void markTurned(int index);
+    void clearTurned();
+
+private:
+    static constexpr int SWEEP_BLOCK = 256; // Balls swept per sweepBatch()
+    // update() splits the pool into a few ranges per worker, so a slow range
+    // doesn't hold the others up, but no smaller than a task is worth
+    static constexpr int RANGES_PER_WORKER = 4;
+    static constexpr int MIN_RANGE_BALLS = 512;
+
+    // What one task's range of balls did during update(). Its lists live in
+    // mRangeScored and mRangeTurned from the range's first ball on
+    struct RangeResult {
+        int begin;
+        int scores[2];
+        int scored; // Balls to serve again, in index order
+        int turned; // Balls a paddle sent a new way
+    };
+
+    void updateRange(int begin, int end, float deltaTime,
+                     const PaddleState paddles[2], RangeResult& result);
+
+    int mCount = 0;
+    int mCapacity = 0;
+    int mGrowths = 0;
+    float mRadius;
+    float mBaseSpeed = BALL_FAST_SPEED;
+
+    std::vector<float> mPosX, mPosY;
+    std::vector<float> mMoveX, mMoveY;
+    std::vector<float> mSpeed;
+    std::vector<float> mSpeedMultiplier;
+    std::vector<int8_t> mLastCollision; // PaddleSide of the last paddle hit
+    std::vector<BallHandle> mIndexHandle; // Handle of each array slot
+    std::vector<int> mHandleIndex;        // Array slot of each handle
+    std::vector<BallHandle> mFreeHandles; // Stack of unused handles
+    std::vector<int> mTurned;             // Indices, see getTurned()
+    bool mAllTurned = true;
+
+    std::vector<RangeResult> mRangeResults; // Reused between updates
+    // One slot per ball, so a range's lists never outgrow its own slice
+    std::vector<int> mRangeScored, mRangeTurned;
+};
+
+#endif // BALL_POOL_H
@@ -0,0 +1,144 @@
+#include "BatchEnv.h"
+#include "Interceptor.h"
+#include <algorithm>
+
+BatchEnv::BatchEnv(WorkerPool* workers, int ticksPerStep, float tickRate) :
+    mWorkers {workers}, mTicksPerStep {std::max(1, ticksPerStep)},
+    mDeltaTime {1.0f / tickRate} { }
+
+/**
+ * @brief Starts count new episodes. The only call that allocates: step()
+ * reuses everything sized here
+ * @param count envs to run
+ * @param seed env i serves from seed + i, so runs repeat
+ * @param observations optional caller-owned buffer of count * ENV_OBS_SIZE
+ * floats, e.g. a tensor the trainer reads from, filled in place from now on
+ * @return the first observations; rewards and dones are all 0
+ */
+EnvStep BatchEnv::reset(int count, uint32_t seed, float* observations) {
+    mCount = count;
+    mSteps = 0;
+    mEpisodes = 0;
+    mBalls.resize(count);
+    mPaddles.resize(2 * count);
+    mScores.resize(2 * count);
+    mRngs.resize(count);
+    if (observations) {
+        mOwnObservations.clear();
+        mObservations = observations;
+    } else {
+        mOwnObservations.resize(count * ENV_OBS_SIZE);
+        mObservations = mOwnObservations.data();
+    }
+    mRewards.assign(count, 0.0f);
+    mDones.assign(count, 0);
+    int blocks = 1;
+    if (mWorkers)
+        blocks = std::max(1, std::min(mWorkers->size() * BLOCKS_PER_WORKER,
+                                      count / MIN_BLOCK_ENVS));
+    mBlockEpisodes.resize(blocks);
+    for (int env = 0; env < count; env++) {
+        mRngs[env].setSeed(seed + env);
+        resetEnv(env);
+        observe(env);
+    }
+    return {mObservations, mRewards.data(), mDones.data()};
+}
+
+/**
+ * @brief Holds each env's action for the next ticksPerStep ticks. Envs whose
+ * episode ends start a new one straight away, and report the new episode's
+ * first observation
+ * @param actions count() EnvActions; anything else is clamped
+ * @return observations, rewards and dones, refilled in place
+ */
+EnvStep BatchEnv::step(const int8_t* actions) {
+    int blocks = static_cast<int>(mBlockEpisodes.size());
+    int blockSize = (mCount + blocks - 1) / blocks;
+    auto task = [&](int block) {
+        int begin = block * blockSize;
+        int end = std::min(mCount, begin + blockSize);
+        int episodes = 0;
+        for (int env = begin; env < end; env++) {
+            bool done = false;
+            mRewards[env] = stepEnv(env, actions[env], done);
+            mDones[env] = done;
+            if (done) {
+                resetEnv(env);
+                episodes++;
+            }
+            observe(env);
+        }
+        mBlockEpisodes[block] = episodes;
+    };
+    if (!mWorkers || blocks <= 1)
+        for (int block = 0; block < blocks; block++) task(block);
+    else
+        mWorkers->run(blocks, task);
+    for (int episodes : mBlockEpisodes) mEpisodes += episodes;
+    mSteps += mCount;
+    return {mObservations, mRewards.data(), mDones.data()};
+}
+
+// Paddles back to the middle, scores to 0 and a new serve
+void BatchEnv::resetEnv(int env) {
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+        mPaddles[2 * env + side] = makePaddle(side);
+        mScores[2 * env + side] = 0;
+    }
+    BallState& ball = mBalls[env];
+    ball.baseSpeed = BALL_FAST_SPEED;
+    ball.radius = BALL_SIZE / 2.0f;
+    resetBall(ball, mRngs[env]);
+}
+
+/**
+ * @brief Runs one env for ticksPerStep ticks in the order Simulation::step()
+ * does: AI, ball, then paddles. Stops early if the episode ends
+ * @param env
+ * @param action
+ * @param done set if a side reached ENV_WIN_SCORE
+ * @return the reward for the step
+ */
+float BatchEnv::stepEnv(int env, int8_t action, bool& done) {
+    PaddleState* paddles = &mPaddles[2 * env];
+    int* scores = &mScores[2 * env];
+    BallState& ball = mBalls[env];
+    float movement = static_cast<float>(
+        std::min<int>(ENV_DOWN, std::max<int>(ENV_UP, action)));
+    float reward = 0.0f;
+    for (int tick = 0; tick < mTicksPerStep && !done; tick++) {
+        paddles[LEFT_PADDLE].movement.y = movement;
+        // The opponent is the game's AI; with one ball it needs no heap
+        float seconds, y, dirY;
+        float targetY = SCREEN_HEIGHT / 2.0f;
+        if (predictIntercept(ball, paddles[RIGHT_PADDLE], RIGHT_PADDLE,
+                             seconds, y, dirY))
+            targetY = aimAt(paddles[RIGHT_PADDLE], y, dirY);
+        steerPaddle(paddles[RIGHT_PADDLE], targetY, mDeltaTime);
+        int scorer = stepBall(ball, paddles, mDeltaTime);
+        stepPaddle(paddles[LEFT_PADDLE], mDeltaTime);
+        stepPaddle(paddles[RIGHT_PADDLE], mDeltaTime);
+        if (scorer == NO_PADDLE) continue;
+        scores[scorer]++;
+        reward += scorer == LEFT_PADDLE ? 1.0f : -1.0f;
+        resetBall(ball, mRngs[env]);
+        done = scores[scorer] >= ENV_WIN_SCORE;
+    }
+    return reward;
+}
+
+// Writes one env's row of the observation buffer
+void BatchEnv::observe(int env) {
+    const BallState& ball = mBalls[env];
+    const PaddleState* paddles = &mPaddles[2 * env];
+    float* row = mObservations + static_cast<size_t>(env) * ENV_OBS_SIZE;
+    row[0] = ball.position.x / SCREEN_WIDTH;
+    row[1] = ball.position.y / SCREEN_HEIGHT;
+    row[2] = ball.movement.x * ball.speed / BALL_FAST_SPEED;
+    row[3] = ball.movement.y * ball.speed / BALL_FAST_SPEED;
+    row[4] = paddles[LEFT_PADDLE].position.y / SCREEN_HEIGHT;
+    row[5] = paddles[RIGHT_PADDLE].position.y / SCREEN_HEIGHT;
+    row[6] = mScores[2 * env + LEFT_PADDLE] / (float)ENV_WIN_SCORE;
+    row[7] = mScores[2 * env + RIGHT_PADDLE] / (float)ENV_WIN_SCORE;
+}
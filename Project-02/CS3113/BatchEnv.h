@@ -0,0 +1,80 @@
+// Many independent games of Pong stepped together, for training paddle
+// policies offline. Each env is one ball and two paddles under the same
+// physics core as the game: the policy moves the left paddle and the
+// predictive AI the right. State sits in flat arrays, one slot per env, and
+// step() splits the envs across a WorkerPool. Observations are written
+// straight into one float buffer that stays put (ours, or one the caller
+// hands over), so a trainer can wrap it once and never copy. Raylib-free
+
+#ifndef BATCH_ENV_H
+#define BATCH_ENV_H
+
+#include "Physics.h"
+#include "WorkerPool.h"
+#include <stdint.h>
+#include <vector>
+
+// Floats of observation per env, from the left paddle's side of the court:
+// ball x, y, x velocity, y velocity, own paddle y, opponent paddle y, own
+// score, opponent score. Positions are over the screen size, velocities over
+// BALL_FAST_SPEED and scores over ENV_WIN_SCORE
+constexpr int ENV_OBS_SIZE = 8;
+constexpr int ENV_WIN_SCORE = 10; // Points that end an episode, as in the game
+constexpr int ENV_TICKS_PER_STEP = 4; // Ticks an action is held for
+
+// Actions, one per env: the left paddle's movement.y
+enum EnvAction : int8_t { ENV_UP = -1, ENV_STAY = 0, ENV_DOWN = 1 };
+
+// What reset() and step() hand back. All three point into buffers the env
+// keeps and overwrites on the next call
+struct EnvStep {
+    const float* observations; // count() rows of ENV_OBS_SIZE
+    const float* rewards;      // +1 per point won, -1 per point lost
+    const uint8_t* dones;      // 1 if the episode ended; that env restarted
+};
+
+class BatchEnv {
+public:
+    explicit BatchEnv(WorkerPool* workers = nullptr,
+                      int ticksPerStep = ENV_TICKS_PER_STEP,
+                      float tickRate = SIM_TICK_RATE);
+
+    EnvStep reset(int count, uint32_t seed = 67,
+                  float* observations = nullptr);
+    EnvStep step(const int8_t* actions);
+
+    int count() const { return mCount; }
+
+    uint64_t getSteps() const { return mSteps; }
+
+    uint64_t getEpisodes() const { return mEpisodes; }
+
+private:
+    // step() splits the envs into a few blocks per worker, like
+    // BallPool::update(), but no smaller than a task is worth
+    static constexpr int BLOCKS_PER_WORKER = 4;
+    static constexpr int MIN_BLOCK_ENVS = 16;
+
+    void resetEnv(int env);
+    float stepEnv(int env, int8_t action, bool& done);
+    void observe(int env);
+
+    WorkerPool* mWorkers; // Not owned
+    int mTicksPerStep;
+    float mDeltaTime;
+    int mCount = 0;
+    uint64_t mSteps = 0;    // step() calls since reset(), times count()
+    uint64_t mEpisodes = 0; // Finished since reset()
+
+    std::vector<BallState> mBalls;
+    std::vector<PaddleState> mPaddles; // Left and right of each env in turn
+    std::vector<int> mScores;          // Same order as mPaddles
+    std::vector<Rng> mRngs;            // Each env serves from its own
+    std::vector<float> mOwnObservations;
+    float* mObservations = nullptr; // mOwnObservations or the caller's
+    std::vector<float> mRewards;
+    std::vector<uint8_t> mDones;
+    std::vector<int> mBlockEpisodes; // Per task, summed after each step
+};
+
+#endif // BATCH_ENV_H
@@ -0,0 +1,341 @@
+#include "CollisionWorld.h"
+#include <algorithm>
+
+// Swept boxes are padded so rounding can't prune a pair the slab test hits
+static constexpr float BOX_MARGIN = 1.0f;
+
+CollisionWorld::CollisionWorld() {
+    // The classic layout: top and bottom bounce, left and right score
+    mEdges[EDGE_LEFT] = mEdges[EDGE_RIGHT] = EDGE_GOAL;
+    mEdges[EDGE_TOP] = mEdges[EDGE_BOTTOM] = EDGE_BOUNCE;
+}
+
+/**
+ * @brief Registers a paddle or obstacle. Earlier colliders win ties when a
+ * ball would hit two at the same time
+ * @param collider
+ * @return the collider's id, or -1 once MAX_COLLIDERS are registered
+ */
+int CollisionWorld::addCollider(const Collider& collider) {
+    if (getColliderCount() >= MAX_COLLIDERS) return -1;
+    mColliders.push_back(collider);
+    return getColliderCount() - 1;
+}
+
+/**
+ * @brief Moves every collider by its movement for one step and resets the
+ * movement, like stepPaddle()
+ */
+void CollisionWorld::stepColliders(float deltaTime) {
+    for (Collider& collider : mColliders) stepPaddle(collider.body, deltaTime);
+}
+
+/**
+ * @brief Moves every ball one step: first hit among all colliders, edge
+ * bounces, then depenetration, in the same order as stepBall(). Balls past a
+ * goal edge are reported in ball order and left for the caller to serve
+ * @param balls
+ * @param deltaTime
+ * @param exits cleared, then filled with the balls that left
+ */
+void CollisionWorld::step(BallPool& balls, float deltaTime,
+                          std::vector<BallExit>& exits) {
+    exits.clear();
+    mStats = CollisionWorldStats();
+    int count = balls.size();
+    mHitTime.assign(count, -1.0f);
+    mHitCollider.assign(count, -1);
+    mHitNormal.resize(count);
+
+    if (mBroadphase) {
+        findPairs(balls, deltaTime);
+    } else { // Every ball against every collider, for comparison
+        for (int i = 0; i < count; i++) {
+            BallState ball = balls.get(i);
+            for (int id = 0; id < getColliderCount(); id++)
+                testPair(ball, i, id, deltaTime);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        BallState ball = balls.get(i);
+        int edge = moveBall(ball, i, deltaTime);
+        balls.set(i, ball);
+        if (edge != EDGE_COUNT)
+            exits.push_back({i, static_cast<ScreenEdge>(edge)});
+    }
+}
+
+/**
+ * @brief Sorts ball indices by the left end of their swept box. Balls barely
+ * move in a step, so an insertion sort over last step's order is close to
+ * linear
+ */
+void CollisionWorld::sortBalls(const BallPool& balls, float deltaTime) {
+    int count = balls.size();
+    mBallMinX.resize(count);
+    mBallMaxX.resize(count);
+    mBallMinY.resize(count);
+    mBallMaxY.resize(count);
+    for (int i = 0; i < count; i++) {
+        BallState ball = balls.get(i);
+        float reach = ball.radius + BOX_MARGIN;
+        float endX = ball.position.x + ball.movement.x * ball.speed * deltaTime;
+        float endY = ball.position.y + ball.movement.y * ball.speed * deltaTime;
+        mBallMinX[i] = std::min(ball.position.x, endX) - reach;
+        mBallMaxX[i] = std::max(ball.position.x, endX) + reach;
+        mBallMinY[i] = std::min(ball.position.y, endY) - reach;
+        mBallMaxY[i] = std::max(ball.position.y, endY) + reach;
+    }
+    if (static_cast<int>(mOrder.size()) != count) { // Pool resized: start over
+        mOrder.resize(count);
+        for (int i = 0; i < count; i++) mOrder[i] = i;
+        std::sort(mOrder.begin(), mOrder.end(), [this](int a, int b) {
+            return mBallMinX[a] < mBallMinX[b];
+        });
+        return;
+    }
+    for (int i = 1; i < count; i++) {
+        int ball = mOrder[i];
+        float key = mBallMinX[ball];
+        int j = i - 1;
+        while (j >= 0 && mBallMinX[mOrder[j]] > key) {
+            mOrder[j + 1] = mOrder[j];
+            j--;
+        }
+        mOrder[j + 1] = ball;
+    }
+}
+
+/**
+ * @brief Sweep-and-prune on x: walks balls and colliders in order of their
+ * swept boxes' left ends, keeping the colliders whose boxes are still open,
+ * and slab tests only pairs that overlap on both axes
+ */
+void CollisionWorld::findPairs(const BallPool& balls, float deltaTime) {
+    sortBalls(balls, deltaTime);
+    int colliders = getColliderCount();
+    mColliderMinX.resize(colliders);
+    mColliderMaxX.resize(colliders);
+    mColliderMinY.resize(colliders);
+    mColliderMaxY.resize(colliders);
+    mColliderOrder.resize(colliders);
+    for (int id = 0; id < colliders; id++) {
+        const PaddleState& body = mColliders[id].body;
+        float moveX = body.movement.x * body.speed * deltaTime;
+        float moveY = body.movement.y * body.speed * deltaTime;
+        float halfWidth = body.colliderDimensions.x / 2.0f;
+        float halfHeight = body.colliderDimensions.y / 2.0f;
+        mColliderMinX[id] = body.position.x + std::min(0.0f, moveX) - halfWidth;
+        mColliderMaxX[id] = body.position.x + std::max(0.0f, moveX) + halfWidth;
+        mColliderMinY[id] =
+            body.position.y + std::min(0.0f, moveY) - halfHeight;
+        mColliderMaxY[id] =
+            body.position.y + std::max(0.0f, moveY) + halfHeight;
+        mColliderOrder[id] = id;
+    }
+    std::sort(mColliderOrder.begin(), mColliderOrder.end(),
+              [this](int a, int b) {
+                  return mColliderMinX[a] < mColliderMinX[b];
+              });
+
+    mActive.clear();
+    int next = 0; // First collider in mColliderOrder not yet opened
+    for (int ballIndex : mOrder) {
+        float minX = mBallMinX[ballIndex], maxX = mBallMaxX[ballIndex];
+        // Open colliders starting left of this ball, close finished ones
+        while (next < colliders && mColliderMinX[mColliderOrder[next]] <= minX)
+            mActive.push_back(mColliderOrder[next++]);
+        for (size_t k = 0; k < mActive.size();) {
+            if (mColliderMaxX[mActive[k]] < minX) {
+                mActive[k] = mActive.back();
+                mActive.pop_back();
+            } else {
+                k++;
+            }
+        }
+        for (int id : mActive) testCandidate(balls, ballIndex, id, deltaTime);
+        // Colliders starting inside the ball's interval overlap it too
+        for (int k = next; k < colliders; k++) {
+            int id = mColliderOrder[k];
+            if (mColliderMinX[id] > maxX) break;
+            testCandidate(balls, ballIndex, id, deltaTime);
+        }
+    }
+}
+
+// Rejects a pair overlapping on x unless it also overlaps on y
+void CollisionWorld::testCandidate(const BallPool& balls, int ballIndex,
+                                   int colliderId, float deltaTime) {
+    mStats.candidatePairs++;
+    if (mColliderMaxY[colliderId] < mBallMinY[ballIndex]
+        || mColliderMinY[colliderId] > mBallMaxY[ballIndex])
+        return;
+    testPair(balls.get(ballIndex), ballIndex, colliderId, deltaTime);
+}
+
+// Slab test one pair, keeping the earliest hit per ball (lowest id on ties)
+void CollisionWorld::testPair(const BallState& ball, int ballIndex,
+                              int colliderId, float deltaTime) {
+    mStats.slabTests++;
+    Vec2 normal;
+    float t = sweepCollision(ball, mColliders[colliderId].body, normal,
+                             deltaTime);
+    if (t < 0.0f) return;
+    float best = mHitTime[ballIndex];
+    if (best < 0.0f || t < best
+        || (t == best && colliderId < mHitCollider[ballIndex])) {
+        mHitTime[ballIndex] = t;
+        mHitCollider[ballIndex] = colliderId;
+        mHitNormal[ballIndex] = normal;
+    }
+}
+
+/**
+ * @brief moveBall() for any set of colliders and edges: the first hit comes
+ * from the broadphase, and each later contact in the step from sweeping the
+ * rest of the step against every collider, since the ball has turned
+ * @return the ScreenEdge the ball left through, or EDGE_COUNT
+ */
+int CollisionWorld::moveBall(BallState& ball, int ballIndex,
+                             float deltaTime) {
+    int hit = mHitCollider[ballIndex];
+    float tImpact = mHitTime[ballIndex];
+    Vec2 normal = mHitNormal[ballIndex];
+    float elapsed = 0.0f; // Fraction of the step already moved
+    int lastHit = -1;     // Collider hit most recently this step
+    for (int contact = 0;; contact++) {
+        float remaining = 1.0f - elapsed;
+        float stepTime = deltaTime * remaining;
+        // Bouncing edges the ball reaches this step, top and bottom first
+        float tWall = boundaryTime(
+            ball.position.y, ball.movement.y * ball.speed * stepTime,
+            mEdges[EDGE_TOP] == EDGE_BOUNCE ? ball.radius : -INFINITY,
+            mEdges[EDGE_BOTTOM] == EDGE_BOUNCE ? SCREEN_HEIGHT - ball.radius :
+                                                 INFINITY);
+        float tSide = boundaryTime(
+            ball.position.x, ball.movement.x * ball.speed * stepTime,
+            mEdges[EDGE_LEFT] == EDGE_BOUNCE ? ball.radius : -INFINITY,
+            mEdges[EDGE_RIGHT] == EDGE_BOUNCE ? SCREEN_WIDTH - ball.radius :
+                                                INFINITY);
+        bool sideFirst = tSide >= 0.0f && (tWall < 0.0f || tSide < tWall);
+        if (sideFirst) tWall = tSide;
+        bool wallFirst = tWall >= 0.0f && (hit < 0 || tWall < tImpact);
+        if ((hit < 0 && !wallFirst) || contact == CCD_MAX_CONTACTS) break;
+        if (wallFirst) { // Bounce off the edge and carry on
+            if (sideFirst) {
+                ball.position.x = ball.movement.x < 0.0f ?
+                                      ball.radius :
+                                      SCREEN_WIDTH - ball.radius;
+                ball.position.y +=
+                    ball.movement.y * ball.speed * stepTime * tWall;
+                ball.movement.x = -ball.movement.x;
+            } else {
+                ball.position.x +=
+                    ball.movement.x * ball.speed * stepTime * tWall;
+                ball.position.y = ball.movement.y < 0.0f ?
+                                      ball.radius :
+                                      SCREEN_HEIGHT - ball.radius;
+                ball.movement.y = -ball.movement.y;
+            }
+            elapsed += remaining * tWall;
+        } else {
+            const Collider& collider = mColliders[hit];
+            ball.position.x += ball.movement.x * ball.speed * stepTime
+                             * tImpact; // Move to contact point
+            ball.position.y += ball.movement.y * ball.speed * stepTime
+                             * tImpact; // Move to contact point
+            elapsed += remaining * tImpact;
+            if (collider.kind == COLLIDER_PADDLE) {
+                resolvePaddleHit(ball, collider.body, hit, collider.facing,
+                                 normal, elapsed, deltaTime);
+            } else if (fabsf(normal.y) > 0.5f) { // Obstacle: reflect
+                ball.movement.y = -ball.movement.y;
+            } else {
+                ball.movement.x = -ball.movement.x;
+            }
+            lastHit = hit;
+            mStats.hits++;
+        }
+        hit = findNextHit(ball, deltaTime, elapsed, lastHit, tImpact, normal);
+    }
+    // Continue moving for remainder of frame
+    float remaining = 1.0f - elapsed;
+    ball.position.x += ball.movement.x * ball.speed * deltaTime * remaining;
+    ball.position.y += ball.movement.y * ball.speed * deltaTime * remaining;
+    // Screen edge bounce
+    if (mEdges[EDGE_TOP] == EDGE_BOUNCE && ball.position.y - ball.radius < 0) {
+        ball.position.y = ball.radius;
+        ball.movement.y = -ball.movement.y;
+    } else if (mEdges[EDGE_BOTTOM] == EDGE_BOUNCE
+               && ball.position.y + ball.radius > SCREEN_HEIGHT) {
+        ball.position.y = SCREEN_HEIGHT - ball.radius;
+        ball.movement.y = -ball.movement.y;
+    }
+    if (mEdges[EDGE_LEFT] == EDGE_BOUNCE && ball.position.x - ball.radius < 0) {
+        ball.position.x = ball.radius;
+        ball.movement.x = -ball.movement.x;
+    } else if (mEdges[EDGE_RIGHT] == EDGE_BOUNCE
+               && ball.position.x + ball.radius > SCREEN_WIDTH) {
+        ball.position.x = SCREEN_WIDTH - ball.radius;
+        ball.movement.x = -ball.movement.x;
+    }
+    if (lastHit >= 0) depenetrate(ball, mColliders[lastHit].body, deltaTime);
+    // Goals, checked in the same order as moveBall() scores
+    if (mEdges[EDGE_RIGHT] == EDGE_GOAL
+        && ball.position.x - ball.radius > SCREEN_WIDTH)
+        return EDGE_RIGHT;
+    if (mEdges[EDGE_LEFT] == EDGE_GOAL && ball.position.x + ball.radius < 0)
+        return EDGE_LEFT;
+    if (mEdges[EDGE_BOTTOM] == EDGE_GOAL
+        && ball.position.y - ball.radius > SCREEN_HEIGHT)
+        return EDGE_BOTTOM;
+    if (mEdges[EDGE_TOP] == EDGE_GOAL && ball.position.y + ball.radius < 0)
+        return EDGE_TOP;
+    return EDGE_COUNT;
+}
+
+/**
+ * @brief Sweeps the rest of a step against every collider, where each is
+ * partway through its move. With the broadphase on, colliders whose swept
+ * box misses the ball's box for the rest of the step are skipped. Earliest
+ * hit wins, lowest id on ties, like testPair()
+ * @param ball
+ * @param deltaTime
+ * @param elapsed fraction of the step already moved
+ * @param touching collider just resolved, whose t = 0 touch isn't a hit
+ * @param outTime fraction of the rest of the step until the hit
+ * @param outNormal
+ * @return the collider hit, or -1
+ */
+int CollisionWorld::findNextHit(const BallState& ball, float deltaTime,
+                                float elapsed, int touching, float& outTime,
+                                Vec2& outNormal) {
+    float stepTime = deltaTime * (1.0f - elapsed);
+    float reach = ball.radius + BOX_MARGIN;
+    float endX = ball.position.x + ball.movement.x * ball.speed * stepTime;
+    float endY = ball.position.y + ball.movement.y * ball.speed * stepTime;
+    float minX = std::min(ball.position.x, endX) - reach;
+    float maxX = std::max(ball.position.x, endX) + reach;
+    float minY = std::min(ball.position.y, endY) - reach;
+    float maxY = std::max(ball.position.y, endY) + reach;
+    int best = -1;
+    for (int id = 0; id < getColliderCount(); id++) {
+        if (mBroadphase
+            && (mColliderMaxX[id] < minX || mColliderMinX[id] > maxX
+                || mColliderMaxY[id] < minY || mColliderMinY[id] > maxY))
+            continue;
+        PaddleState body = mColliders[id].body;
+        body.position.x += body.movement.x * body.speed * deltaTime * elapsed;
+        body.position.y += body.movement.y * body.speed * deltaTime * elapsed;
+        Vec2 normal;
+        float t = sweepCollision(ball, body, normal, stepTime);
+        mStats.resweeps++;
+        if (t < 0.0f || (id == touching && t == 0.0f)) continue;
+        if (best < 0 || t < outTime) {
+            best = id;
+            outTime = t;
+            outNormal = normal;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,91 @@
+// Any number of paddles and obstacles colliding with a BallPool. Candidate
+// ball/collider pairs come from sweep-and-prune on x, so only pairs whose
+// swept boxes overlap get the slab test from sweepCollision()
+
+#ifndef COLLISION_WORLD_H
+#define COLLISION_WORLD_H
+
+#include "BallPool.h"
+#include "Physics.h"
+#include <stdint.h>
+#include <vector>
+
+enum ColliderKind : uint8_t {
+    COLLIDER_PADDLE,   // Aims the ball by hit offset and speeds it up
+    COLLIDER_OBSTACLE, // Plain reflection off whichever face was hit
+};
+
+struct Collider {
+    PaddleState body;  // Position, size, movement and speed, like a paddle
+    Vec2 facing;       // Direction a paddle sends the ball; unused otherwise
+    ColliderKind kind;
+};
+
+enum ScreenEdge { EDGE_LEFT, EDGE_RIGHT, EDGE_TOP, EDGE_BOTTOM, EDGE_COUNT };
+
+enum EdgeMode : uint8_t {
+    EDGE_BOUNCE, // Ball reflects off the edge
+    EDGE_GOAL,   // Ball leaving past the edge is reported as an exit
+};
+
+struct BallExit {
+    int ball;
+    ScreenEdge edge;
+};
+
+struct CollisionWorldStats {
+    int candidatePairs = 0; // Pairs overlapping on x after sweep-and-prune
+    int slabTests = 0;      // Candidates also overlapping on y
+    int hits = 0;           // Collider hits, including later ones in a step
+    int resweeps = 0;       // Slab tests after a ball's first contact
+};
+
+class CollisionWorld {
+public:
+    // Collider ids are stored as BallPool's int8_t lastCollision
+    static constexpr int MAX_COLLIDERS = 127;
+
+    CollisionWorld();
+
+    int addCollider(const Collider& collider);
+    void clearColliders() { mColliders.clear(); }
+    void setEdge(ScreenEdge edge, EdgeMode mode) { mEdges[edge] = mode; }
+    void setBroadphase(bool enabled) { mBroadphase = enabled; }
+
+    Collider& getCollider(int id) { return mColliders[id]; }
+
+    int getColliderCount() const { return static_cast<int>(mColliders.size()); }
+
+    const CollisionWorldStats& getStats() const { return mStats; }
+
+    void step(BallPool& balls, float deltaTime, std::vector<BallExit>& exits);
+    void stepColliders(float deltaTime);
+
+private:
+    void sortBalls(const BallPool& balls, float deltaTime);
+    void findPairs(const BallPool& balls, float deltaTime);
+    void testCandidate(const BallPool& balls, int ballIndex, int colliderId,
+                       float deltaTime);
+    void testPair(const BallState& ball, int ballIndex, int colliderId,
+                  float deltaTime);
+    int moveBall(BallState& ball, int ballIndex, float deltaTime);
+    int findNextHit(const BallState& ball, float deltaTime, float elapsed,
+                    int touching, float& outTime, Vec2& outNormal);
+
+    std::vector<Collider> mColliders;
+    EdgeMode mEdges[EDGE_COUNT];
+    bool mBroadphase = true;
+    CollisionWorldStats mStats;
+
+    // Per step scratch, kept to avoid reallocating
+    std::vector<int> mOrder; // Ball indices by swept min x, kept between steps
+    std::vector<float> mBallMinX, mBallMaxX, mBallMinY, mBallMaxY;
+    std::vector<int> mColliderOrder, mActive;
+    std::vector<float> mColliderMinX, mColliderMaxX;
+    std::vector<float> mColliderMinY, mColliderMaxY;
+    std::vector<float> mHitTime; // Earliest slab hit per ball, -1 if none
+    std::vector<int> mHitCollider;
+    std::vector<Vec2> mHitNormal;
+};
+
+#endif // COLLISION_WORLD_H
@@ -8,4 +8,21 @@ constexpr int SCREEN_WIDTH = 1600 / 2;
 constexpr int SCREEN_HEIGHT = 900 / 2;
 constexpr int FPS = 120;
 
-#endif // CONSTANTS_H
\ No newline at end of file
+// Fixed simulation rate, independent of FPS (override with --tick-rate)
+constexpr int SIM_TICK_RATE = 240;
+// Most real time the simulation may owe, in seconds. Past it the backlog is
+// dropped so a long hitch can't spiral; under it every tick runs, whatever
+// the tick rate and FPS
+constexpr float MAX_TICK_BACKLOG = 0.25f;
+
+// Shared by the game and the headless simulation so both start identically
+constexpr float PADDLE_MARGIN = 25.0f; // Paddle centre distance from the edge
+constexpr float PADDLE_WIDTH = 25.0f;
+constexpr float PADDLE_HEIGHT = 100.0f;
+constexpr float PADDLE_SPEED = 200.0f; // Was Entity::DEFAULT_SPEED
+constexpr float BALL_SIZE = 20.0f;
+constexpr float BALL_SLOW_SPEED = 100.0f; // 67 mode
+constexpr float BALL_FAST_SPEED = 250.0f; // 1-3 balls
+constexpr int BALL_POOL_CAPACITY = 10000; // Most balls any mode uses
+
+#endif // CONSTANTS_H
@@ -0,0 +1,89 @@
+#include "Ecs.h"
+
+/**
+ * @brief Makes a new entity with no components, reusing a destroyed slot
+ * when there is one
+ */
+EntityId EcsWorld::create() {
+    mAlive++;
+    if (!mFreeSlots.empty()) {
+        uint32_t index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+        return {index, mGenerations[index]};
+    }
+    mGenerations.push_back(0);
+    return {static_cast<uint32_t>(mGenerations.size() - 1), 0};
+}
+
+/**
+ * @brief Removes every component of entity and frees its slot. Ids still
+ * held to it stop being alive
+ */
+void EcsWorld::destroy(EntityId entity) {
+    if (!isAlive(entity)) return;
+    transforms.remove(entity);
+    motions.remove(entity);
+    colliders.remove(entity);
+    sprites.remove(entity);
+    animations.remove(entity);
+    mGenerations[entity.index]++;
+    mFreeSlots.push_back(entity.index);
+    mAlive--;
+}
+
+bool EcsWorld::isAlive(EntityId entity) const {
+    return entity.index < mGenerations.size()
+        && mGenerations[entity.index] == entity.generation;
+}
+
+/**
+ * @brief Finds or builds the clip table for animationAtlas, so entities
+ * playing the same animation share one copy however many are created.
+ * Tables live as long as the world
+ * @return its index, for AnimationState::clips
+ */
+int EcsWorld::addClips(
+    const std::map<Direction, std::vector<int>>& animationAtlas) {
+    auto found = mClipIndices.find(animationAtlas);
+    if (found != mClipIndices.end()) return found->second;
+    int index = static_cast<int>(mClips.size());
+    mClips.push_back(AnimationClips(animationAtlas));
+    mClipIndices[animationAtlas] = index;
+    return index;
+}
+
+/**
+ * @brief Moves every entity with motion by speed * movement, as
+ * Entity::update() did
+ */
+void moveSystem(EcsWorld& world, float deltaTime) {
+    const Motion* motions = world.motions.data();
+    const uint32_t* owners = world.motions.entities();
+    for (int i = 0; i < world.motions.size(); i++) {
+        TransformComponent* transform = world.transforms.find(owners[i]);
+        if (!transform) continue;
+        const Motion& motion = motions[i];
+        transform->position.x += motion.speed * motion.movement.x * deltaTime;
+        transform->position.y += motion.speed * motion.movement.y * deltaTime;
+    }
+}
+
+/**
+ * @brief Steps every animation that's moving or set to always animate, as
+ * Entity::update() did
+ */
+void animationSystem(EcsWorld& world, float deltaTime) {
+    AnimationState* animations = world.animations.data();
+    const uint32_t* owners = world.animations.entities();
+    for (int i = 0; i < world.animations.size(); i++) {
+        AnimationState& animation = animations[i];
+        if (!animation.alwaysAnimate) {
+            const Motion* motion = world.motions.find(owners[i]);
+            if (!motion
+                || (motion->movement.x == 0.0f && motion->movement.y == 0.0f))
+                continue;
+        }
+        animation.animator.update(world.getClips(animation.clips),
+                                  animation.direction, deltaTime);
+    }
+}
@@ -0,0 +1,161 @@
+// Entity-component storage. An entity is just an id; each kind of component
+// lives in its own sparse set, packed tightly so systems walk flat arrays
+// instead of calling virtual update() on scattered heap objects. Raylib-free,
+// so the systems run headless too
+
+#ifndef ECS_H
+#define ECS_H
+
+#include "Animation.h"
+#include "Physics.h"
+#include <assert.h>
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+// Slot index plus a generation, so an id to a destroyed entity stays invalid
+// after the slot is reused
+struct EntityId {
+    uint32_t index;
+    uint32_t generation;
+};
+
+constexpr EntityId NO_ENTITY = {UINT32_MAX, 0};
+
+// Components of one kind, packed in a dense array. mSparse maps an entity's
+// index to its slot in the dense arrays, or -1 if it has no such component.
+// mGenerations keeps the generation of the id that added it, so an id to a
+// destroyed entity never reaches the components of the one reusing its slot
+template <typename T> class SparseSet {
+public:
+    T& add(EntityId entity, const T& component) {
+        if (entity.index >= mSparse.size()) {
+            mSparse.resize(entity.index + 1, -1);
+            mGenerations.resize(entity.index + 1, 0);
+        }
+        assert(mSparse[entity.index] < 0 || has(entity));
+        mGenerations[entity.index] = entity.generation;
+        if (mSparse[entity.index] >= 0) {
+            mDense[mSparse[entity.index]] = component;
+        } else {
+            mSparse[entity.index] = static_cast<int>(mDense.size());
+            mDense.push_back(component);
+            mEntities.push_back(entity.index);
+        }
+        return mDense[mSparse[entity.index]];
+    }
+
+    // Moves the last component into the gap, so the array stays packed
+    void remove(EntityId entity) {
+        if (!has(entity)) return;
+        int slot = mSparse[entity.index];
+        mDense[slot] = mDense.back();
+        mEntities[slot] = mEntities.back();
+        mSparse[mEntities[slot]] = slot;
+        mDense.pop_back();
+        mEntities.pop_back();
+        mSparse[entity.index] = -1;
+    }
+
+    bool has(EntityId entity) const {
+        return entity.index < mSparse.size() && mSparse[entity.index] >= 0
+            && mGenerations[entity.index] == entity.generation;
+    }
+
+    // Only for an entity that has() one
+    T& get(EntityId entity) {
+        assert(has(entity));
+        return mDense[mSparse[entity.index]];
+    }
+
+    const T& get(EntityId entity) const {
+        assert(has(entity));
+        return mDense[mSparse[entity.index]];
+    }
+
+    // Component for an entity index, or nullptr. For systems walking another
+    // set's entities(), which only ever holds live ones
+    T* find(uint32_t index) {
+        if (index >= mSparse.size() || mSparse[index] < 0) return nullptr;
+        return &mDense[mSparse[index]];
+    }
+
+    int size() const { return static_cast<int>(mDense.size()); }
+
+    T* data() { return mDense.data(); }
+
+    const T* data() const { return mDense.data(); }
+
+    // Entity index owning each dense slot
+    const uint32_t* entities() const { return mEntities.data(); }
+
+    static constexpr size_t BYTES_PER_ENTITY =
+        sizeof(T) + 2 * sizeof(uint32_t) + sizeof(int);
+
+private:
+    std::vector<T> mDense;
+    std::vector<uint32_t> mEntities;
+    std::vector<int> mSparse;
+    std::vector<uint32_t> mGenerations; // Same indices as mSparse
+};
+
+// Not Transform, which raylib.h already defines
+struct TransformComponent {
+    Vec2 position;
+    Vec2 scale;
+    float angle = 0.0f;
+};
+
+struct Motion {
+    Vec2 movement;
+    float speed;
+};
+
+struct BoxCollider {
+    Vec2 dimensions;
+};
+
+struct Sprite {
+    int texture;           // TextureHandle from TextureCache
+    bool atlas = false;    // Draws one frame of a sprite sheet
+    bool flipped = false;  // Mirrored horizontally
+    Vec2 sheetDimensions;  // Rows and columns, for atlases
+};
+
+struct AnimationState {
+    int clips;                  // Index into EcsWorld's clip table
+    Animator animator;
+    Direction direction = DOWN;
+    bool alwaysAnimate = false; // Animates even when not moving
+};
+
+class EcsWorld {
+public:
+    EntityId create();
+    void destroy(EntityId entity);
+    bool isAlive(EntityId entity) const;
+
+    int addClips(const std::map<Direction, std::vector<int>>& animationAtlas);
+
+    const AnimationClips& getClips(int index) const { return mClips[index]; }
+
+    int getEntityCount() const { return mAlive; }
+
+    SparseSet<TransformComponent> transforms;
+    SparseSet<Motion> motions;
+    SparseSet<BoxCollider> colliders;
+    SparseSet<Sprite> sprites;
+    SparseSet<AnimationState> animations;
+
+private:
+    std::vector<uint32_t> mGenerations; // Per slot, bumped on destroy
+    std::vector<uint32_t> mFreeSlots;
+    std::vector<AnimationClips> mClips; // Shared by every animated entity
+    std::map<std::map<Direction, std::vector<int>>, int> mClipIndices;
+    int mAlive = 0;
+};
+
+void moveSystem(EcsWorld& world, float deltaTime);
+void animationSystem(EcsWorld& world, float deltaTime);
+
+#endif // ECS_H
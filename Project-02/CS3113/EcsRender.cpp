@@ -0,0 +1,95 @@
+#include "EcsRender.h"
+
+/**
+ * @brief Makes an entity drawn with a whole texture, as the old Entity
+ * constructor with a texture path did. The texture comes from TextureCache
+ */
+EntityId createSprite(EcsWorld& world, Vector2 position, Vector2 scale,
+                      const char* textureFilepath) {
+    EntityId entity = world.create();
+    TransformComponent transform;
+    transform.position = {position.x, position.y};
+    transform.scale = {scale.x, scale.y};
+    world.transforms.add(entity, transform);
+    world.colliders.add(entity, {{scale.x, scale.y}});
+    Sprite sprite;
+    sprite.texture = TextureCache::acquire(textureFilepath);
+    sprite.sheetDimensions = {1.0f, 1.0f};
+    world.sprites.add(entity, sprite);
+    return entity;
+}
+
+/**
+ * @brief Makes an entity drawn from a sprite sheet, as the old Entity
+ * constructor with an atlas did
+ */
+EntityId createAnimatedSprite(
+    EcsWorld& world, Vector2 position, Vector2 scale,
+    const char* textureFilepath, Vector2 spriteSheetDimensions,
+    const std::map<Direction, std::vector<int>>& animationAtlas,
+    int frameSpeed) {
+    EntityId entity = createSprite(world, position, scale, textureFilepath);
+    Sprite& sprite = world.sprites.get(entity);
+    sprite.atlas = true;
+    sprite.sheetDimensions = {spriteSheetDimensions.x,
+                              spriteSheetDimensions.y};
+    AnimationState animation;
+    animation.clips = world.addClips(animationAtlas);
+    animation.animator.setFrameSpeed(frameSpeed);
+    world.animations.add(entity, animation);
+    return entity;
+}
+
+// Releases the sprite's texture, then the entity
+void destroySprite(EcsWorld& world, EntityId entity) {
+    if (!world.isAlive(entity)) return;
+    if (world.sprites.has(entity))
+        TextureCache::release(world.sprites.get(entity).texture);
+    world.destroy(entity);
+}
+
+// Same rectangles as the old Entity::getDrawArea()
+static void getDrawArea(const EcsWorld& world, EntityId entity,
+                        Rectangle& textureArea, Rectangle& destinationArea,
+                        Vector2& originOffset) {
+    const TransformComponent& transform = world.transforms.get(entity);
+    const Sprite& sprite = world.sprites.get(entity);
+    Rectangle region = TextureCache::getRegion(sprite.texture);
+    if (sprite.atlas) {
+        const AnimationState& animation = world.animations.get(entity);
+        int frame = animation.animator.getFrame(
+            world.getClips(animation.clips), animation.direction);
+        textureArea = getUVRectangle(region, frame, sprite.sheetDimensions.x,
+                                     sprite.sheetDimensions.y);
+    } else {
+        // Negative width flips horizontally, staying inside the region
+        textureArea = {region.x, region.y,
+                       sprite.flipped ? -region.width : region.width,
+                       region.height};
+    }
+    destinationArea = {transform.position.x, transform.position.y,
+                       transform.scale.x, transform.scale.y};
+    originOffset = {transform.scale.x / 2.0f, transform.scale.y / 2.0f};
+}
+
+// Adds one entity's sprite to batch
+void queueSprite(const EcsWorld& world, EntityId entity, SpriteBatch& batch) {
+    const Texture2D& texture =
+        TextureCache::get(world.sprites.get(entity).texture);
+    Rectangle textureArea, destinationArea;
+    Vector2 originOffset;
+    getDrawArea(world, entity, textureArea, destinationArea, originOffset);
+    batch.draw(texture, textureArea, destinationArea, originOffset,
+               world.transforms.get(entity).angle, WHITE);
+}
+
+// Draws one entity's sprite straight away, outside any batch
+void drawSprite(const EcsWorld& world, EntityId entity) {
+    const Texture2D& texture =
+        TextureCache::get(world.sprites.get(entity).texture);
+    Rectangle textureArea, destinationArea;
+    Vector2 originOffset;
+    getDrawArea(world, entity, textureArea, destinationArea, originOffset);
+    DrawTexturePro(texture, textureArea, destinationArea, originOffset,
+                   world.transforms.get(entity).angle, WHITE);
+}
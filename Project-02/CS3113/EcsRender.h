@@ -0,0 +1,23 @@
+// Drawing for EcsWorld sprites, kept apart from Ecs.h so the components and
+// systems stay raylib-free
+
+#ifndef ECS_RENDER_H
+#define ECS_RENDER_H
+
+#include "Ecs.h"
+#include "SpriteBatch.h"
+#include "TextureCache.h"
+
+EntityId createSprite(EcsWorld& world, Vector2 position, Vector2 scale,
+                      const char* textureFilepath);
+EntityId createAnimatedSprite(
+    EcsWorld& world, Vector2 position, Vector2 scale,
+    const char* textureFilepath, Vector2 spriteSheetDimensions,
+    const std::map<Direction, std::vector<int>>& animationAtlas,
+    int frameSpeed);
+void destroySprite(EcsWorld& world, EntityId entity);
+
+void queueSprite(const EcsWorld& world, EntityId entity, SpriteBatch& batch);
+void drawSprite(const EcsWorld& world, EntityId entity);
+
+#endif // ECS_RENDER_H
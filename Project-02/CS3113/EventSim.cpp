@@ -0,0 +1,286 @@
+#include "EventSim.h"
+#include <math.h>
+
+constexpr double NEVER = INFINITY;
+
+/**
+ * @brief Entry time of a ball into a fixed paddle, expanded by the radius:
+ * the slab test from sweepCollision() without the one-frame limit
+ * @param ball
+ * @param velocityX, velocityY ball velocity in pixels per second
+ * @param paddle
+ * @param outNormal face of the paddle that is hit
+ * @return seconds until the hit, negative if already inside, or NEVER
+ */
+static double paddleEntryTime(const BallState& ball, double velocityX,
+                              double velocityY, const PaddleState& paddle,
+                              Vec2& outNormal) {
+    double rectLeft = paddle.position.x - paddle.colliderDimensions.x / 2.0
+                    - ball.radius;
+    double rectRight = paddle.position.x + paddle.colliderDimensions.x / 2.0
+                     + ball.radius;
+    double rectTop = paddle.position.y - paddle.colliderDimensions.y / 2.0
+                   - ball.radius;
+    double rectBottom = paddle.position.y + paddle.colliderDimensions.y / 2.0
+                      + ball.radius;
+    double tEntryX = -NEVER, tExitX = NEVER, tEntryY = -NEVER, tExitY = NEVER;
+    if (fabs(velocityX) < PHYSICS_EPSILON) { // Must already be in the slab
+        if (ball.position.x < rectLeft || ball.position.x > rectRight)
+            return NEVER;
+    } else {
+        tEntryX = (rectLeft - ball.position.x) / velocityX;
+        tExitX = (rectRight - ball.position.x) / velocityX;
+        if (tEntryX > tExitX) std::swap(tEntryX, tExitX);
+    }
+    if (fabs(velocityY) < PHYSICS_EPSILON) {
+        if (ball.position.y < rectTop || ball.position.y > rectBottom)
+            return NEVER;
+    } else {
+        tEntryY = (rectTop - ball.position.y) / velocityY;
+        tExitY = (rectBottom - ball.position.y) / velocityY;
+        if (tEntryY > tExitY) std::swap(tEntryY, tExitY);
+    }
+    double tEntry = std::max(tEntryX, tEntryY);
+    double tExit = std::min(tExitX, tExitY);
+    // A ball already inside gets a negative time, which sweepCollision()
+    // would clamp to 0. Only a paddle moved onto a ball gets there, so
+    // setPaddles() resolves it rather than predict(), which would hit it
+    // "now" over and over and stop the clock
+    if (tEntry > tExit || tExit <= 0.0) return NEVER;
+    // Same face choice as sweepCollision()
+    if (tEntryY > tEntryX)
+        outNormal = {0.0f, velocityY > 0 ? -1.0f : 1.0f};
+    else
+        outNormal = {velocityX > 0 ? -1.0f : 1.0f, 0.0f};
+    return tEntry;
+}
+
+EventSim::EventSim(uint32_t seed) : mRng {seed} {
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++)
+        mPaddles[side] = makePaddle(side);
+}
+
+/**
+ * @brief Moves the paddles and re-predicts every ball, since any pending
+ * paddle hit (or miss) may have changed. A ball the paddles moved onto
+ * bounces off them now. Old events stay queued but are skipped by version;
+ * the queue is rebuilt once they outnumber live ones. Paddle movement is
+ * ignored
+ */
+void EventSim::setPaddles(const PaddleState paddles[2]) {
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+        mPaddles[side] = paddles[side];
+        mPaddles[side].movement = {0.0f, 0.0f};
+    }
+    for (int i = 0; i < size(); i++) {
+        if (!mBalls[i].active) continue;
+        moveTo(mBalls[i], mTime);
+        resolveOverlap(i);
+    }
+    if (mQueue.size() > 2 * mBalls.size() + 64) {
+        rebuildQueue();
+        return;
+    }
+    for (int i = 0; i < size(); i++) {
+        mBalls[i].version++;
+        predict(i);
+    }
+}
+
+/**
+ * @brief Replaces the balls with `count` fresh serves from the centre
+ * @param count
+ * @param baseSpeed
+ */
+void EventSim::setBallCount(int count, float baseSpeed) {
+    std::vector<BallState> balls(count);
+    for (BallState& ball : balls) {
+        ball.baseSpeed = baseSpeed;
+        ball.radius = BALL_SIZE / 2.0f;
+        resetBall(ball, mRng);
+    }
+    setBalls(balls);
+}
+
+/**
+ * @brief Replaces the balls with the given states, as of the current time
+ * @param balls
+ */
+void EventSim::setBalls(const std::vector<BallState>& balls) {
+    mBalls.resize(balls.size());
+    for (size_t i = 0; i < balls.size(); i++) {
+        KinematicBall& ball = mBalls[i];
+        ball.state = balls[i];
+        ball.time = mTime;
+        ball.version = 0;
+        ball.ignorePaddle = NO_PADDLE;
+        ball.paddleTime = -NEVER;
+        ball.active = true;
+    }
+    rebuildQueue();
+}
+
+/**
+ * @brief Handles every event up to `time` in time order, then moves the
+ * clock there. Balls are only moved when they have an event
+ * @param time seconds since the simulation started
+ */
+void EventSim::advanceTo(double time) {
+    while (!mQueue.empty() && mQueue.top().time <= time) {
+        SimEvent event = mQueue.top();
+        mQueue.pop();
+        handle(event);
+    }
+    mTime = std::max(mTime, time);
+}
+
+/**
+ * @return ball i where it is at the current time
+ */
+BallState EventSim::getBall(int i) const {
+    BallState state = mBalls[i].state;
+    if (!mBalls[i].active) return state;
+    double elapsed = mTime - mBalls[i].time;
+    state.position.x += state.movement.x * state.speed * elapsed;
+    state.position.y += state.movement.y * state.speed * elapsed;
+    return state;
+}
+
+void EventSim::moveTo(KinematicBall& ball, double time) {
+    double elapsed = time - ball.time;
+    ball.state.position.x += ball.state.movement.x * ball.state.speed * elapsed;
+    ball.state.position.y += ball.state.movement.y * ball.state.speed * elapsed;
+    ball.time = time;
+}
+
+/**
+ * @brief Works out ball i's next event and queues it: whichever comes first
+ * of the wall it's heading for, either paddle, or the edge it's heading for
+ */
+void EventSim::predict(int i) {
+    KinematicBall& ball = mBalls[i];
+    if (!ball.active) return;
+    const BallState& state = ball.state;
+    double velocityX = state.movement.x * state.speed;
+    double velocityY = state.movement.y * state.speed;
+
+    SimEvent event = {NEVER, i, ball.version, EVENT_WALL, {0.0f, 0.0f}};
+    if (velocityY > 0.0)
+        event.time = (SCREEN_HEIGHT - state.radius - state.position.y)
+                   / velocityY;
+    else if (velocityY < 0.0)
+        event.time = (state.radius - state.position.y) / velocityY;
+    if (velocityX != 0.0) {
+        double exitTime =
+            velocityX > 0.0 ?
+                (SCREEN_WIDTH + state.radius - state.position.x) / velocityX :
+                (-state.radius - state.position.x) / velocityX;
+        if (exitTime < event.time) {
+            event.time = exitTime;
+            event.type = EVENT_EXIT;
+        }
+    }
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+        if (side == ball.ignorePaddle) continue;
+        Vec2 normal;
+        double hitTime = paddleEntryTime(state, velocityX, velocityY,
+                                         mPaddles[side], normal);
+        if (hitTime < 0.0) continue; // Inside; see resolveOverlap()
+        if (hitTime <= event.time) { // Paddle wins ties, like moveBall()
+            event.time = hitTime;
+            event.type = side == LEFT_PADDLE ? EVENT_PADDLE_LEFT :
+                                               EVENT_PADDLE_RIGHT;
+            event.normal = normal;
+        }
+    }
+    if (event.time == NEVER) return; // Not moving
+    event.time = ball.time + std::max(event.time, 0.0);
+    mQueue.push(event);
+}
+
+/**
+ * @brief Bounces ball i off any paddle it is inside, as moveBall() does when
+ * sweepCollision() clamps the entry time to 0, and pushes it out with
+ * depenetrate(). Only runs once per paddle move, so the clock can't stall
+ */
+void EventSim::resolveOverlap(int i) {
+    KinematicBall& ball = mBalls[i];
+    BallState& state = ball.state;
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+        Vec2 normal;
+        double hitTime = paddleEntryTime(state, state.movement.x * state.speed,
+                                         state.movement.y * state.speed,
+                                         mPaddles[side], normal);
+        if (hitTime >= 0.0) continue; // Not inside
+        resolveCollision(state, mPaddles[side], side, normal, 0.0f, 0.0f);
+        depenetrate(state, mPaddles[side], 0.0f);
+        ball.ignorePaddle = side;
+        ball.paddleTime = mTime;
+        mStats.paddleHits++;
+        if (mEventLog) {
+            SimEvent event = {mTime, i, ball.version,
+                              side == LEFT_PADDLE ? EVENT_PADDLE_LEFT :
+                                                    EVENT_PADDLE_RIGHT,
+                              normal};
+            mEventLog->push_back(event);
+        }
+    }
+}
+
+void EventSim::handle(const SimEvent& event) {
+    KinematicBall& ball = mBalls[event.ball];
+    if (event.version != ball.version) { // Ball was rescheduled since
+        mStats.staleEvents++;
+        return;
+    }
+    mStats.events++;
+    moveTo(ball, event.time);
+    BallState& state = ball.state;
+    switch (event.type) {
+    case EVENT_WALL :
+        state.position.y = state.movement.y > 0.0f ?
+                               SCREEN_HEIGHT - state.radius :
+                               state.radius;
+        state.movement.y = -state.movement.y;
+        // A paddle flush with the wall leaves no gap, and the ball would
+        // bounce between the two without time moving on
+        if (event.time > ball.paddleTime) ball.ignorePaddle = NO_PADDLE;
+        mStats.wallBounces++;
+        break;
+    case EVENT_PADDLE_LEFT :
+    case EVENT_PADDLE_RIGHT : {
+        int side = event.type == EVENT_PADDLE_LEFT ? LEFT_PADDLE :
+                                                     RIGHT_PADDLE;
+        // Paddles are fixed, so the impact time within a "frame" is moot
+        resolveCollision(state, mPaddles[side], side, event.normal, 0.0f,
+                         0.0f);
+        ball.ignorePaddle = side;
+        ball.paddleTime = event.time;
+        mStats.paddleHits++;
+        break;
+    }
+    case EVENT_EXIT :
+        mScores[state.movement.x > 0.0f ? LEFT_PADDLE : RIGHT_PADDLE]++;
+        mStats.exits++;
+        if (mServeAfterScore) {
+            resetBall(state, mRng);
+        } else {
+            ball.active = false;
+        }
+        ball.ignorePaddle = NO_PADDLE;
+        break;
+    }
+    if (mEventLog) mEventLog->push_back(event);
+    ball.version++;
+    predict(event.ball);
+}
+
+// Drops every queued event, stale ones included, and predicts each ball again
+void EventSim::rebuildQueue() {
+    mQueue = std::priority_queue<SimEvent, std::vector<SimEvent>, LaterEvent>();
+    for (int i = 0; i < size(); i++) {
+        mBalls[i].version++;
+        predict(i);
+    }
+    mStats.rebuilds++;
+}
@@ -0,0 +1,98 @@
+// Event-driven ball simulator. Between contacts a ball moves in a straight
+// line, so instead of stepping every ball every tick this predicts each
+// ball's next wall bounce, paddle hit or exit and jumps straight to it.
+// Paddles are treated as fixed between setPaddles() calls
+
+#ifndef EVENT_SIM_H
+#define EVENT_SIM_H
+
+#include "Physics.h"
+#include <queue>
+#include <stdint.h>
+#include <vector>
+
+enum SimEventType : uint8_t {
+    EVENT_WALL,         // Top or bottom edge bounce
+    EVENT_PADDLE_LEFT,  // Slab hit on the left paddle
+    EVENT_PADDLE_RIGHT, // Slab hit on the right paddle
+    EVENT_EXIT,         // Left the screen; the other side scores
+};
+
+struct SimEvent {
+    double time;
+    int ball;
+    uint32_t version; // Ball's version when predicted; stale if it has moved on
+    SimEventType type;
+    Vec2 normal; // Paddle face hit, for EVENT_PADDLE_*
+};
+
+struct EventSimStats {
+    uint64_t events = 0;      // Events handled
+    uint64_t staleEvents = 0; // Popped after their ball was rescheduled
+    uint64_t wallBounces = 0;
+    uint64_t paddleHits = 0;
+    uint64_t exits = 0;
+    uint64_t rebuilds = 0;    // Queue rebuilt to drop stale events
+};
+
+class EventSim {
+public:
+    explicit EventSim(uint32_t seed = 67);
+
+    void setPaddles(const PaddleState paddles[2]);
+    void setBallCount(int count, float baseSpeed = BALL_FAST_SPEED);
+    void setBalls(const std::vector<BallState>& balls);
+    void setServeAfterScore(bool serve) { mServeAfterScore = serve; }
+    void setEventLog(std::vector<SimEvent>* log) { mEventLog = log; }
+
+    void advanceTo(double time);
+
+    double getTime() const { return mTime; }
+
+    int size() const { return static_cast<int>(mBalls.size()); }
+
+    BallState getBall(int i) const;
+
+    bool isActive(int i) const { return mBalls[i].active; }
+
+    int getLeftScore() const { return mScores[LEFT_PADDLE]; }
+
+    int getRightScore() const { return mScores[RIGHT_PADDLE]; }
+
+    const EventSimStats& getStats() const { return mStats; }
+
+private:
+    struct KinematicBall {
+        BallState state;    // Position as of `time`
+        double time;
+        uint32_t version;   // Bumped whenever its pending event is replaced
+        int ignorePaddle;   // Paddle just hit, skipped until a wall bounce
+        double paddleTime;  // When ignorePaddle was hit
+        bool active;        // False once scored with serving off
+    };
+
+    // Earliest event on top of the std::priority_queue
+    struct LaterEvent {
+        bool operator()(const SimEvent& a, const SimEvent& b) const {
+            return a.time > b.time;
+        }
+    };
+
+    void predict(int i);
+    void resolveOverlap(int i);
+    void handle(const SimEvent& event);
+    void moveTo(KinematicBall& ball, double time);
+    void rebuildQueue();
+
+    Rng mRng;
+    PaddleState mPaddles[2];
+    std::vector<KinematicBall> mBalls;
+    std::priority_queue<SimEvent, std::vector<SimEvent>, LaterEvent> mQueue;
+    std::vector<SimEvent>* mEventLog = nullptr; // Not owned
+    double mTime = 0.0;
+    int mScores[2] = {0, 0};
+    bool mServeAfterScore = true;
+    EventSimStats mStats;
+};
+
+#endif // EVENT_SIM_H
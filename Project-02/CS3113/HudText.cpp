@@ -0,0 +1,69 @@
+#include "HudText.h"
+#include <stdio.h>
+#include <string.h>
+
+int HudText::sRedraws = 0;
+
+HudText::HudText(int fontSize, Color colour) :
+    mFontSize {fontSize}, mColour {colour}, mTarget {} { }
+
+HudText::~HudText() {
+    if (mHasTarget) UnloadRenderTexture(mTarget);
+}
+
+/**
+ * @brief Changes the text, rasterising it again only if it differs. Call
+ * between frames, not inside BeginDrawing()
+ * @param text at most MAX_LENGTH characters are kept
+ */
+void HudText::setText(const char* text) {
+    if (!mHasNumber && strncmp(mText, text, MAX_LENGTH) == 0) return;
+    mHasNumber = false;
+    strncpy(mText, text, MAX_LENGTH);
+    mText[MAX_LENGTH] = '\0';
+    rasterise();
+}
+
+/**
+ * @brief Shows an integer. An unchanged value costs one compare, with no
+ * formatting
+ * @param value
+ */
+void HudText::setNumber(int value) {
+    if (mHasNumber && mNumber == value) return;
+    mHasNumber = true;
+    mNumber = value;
+    snprintf(mText, sizeof(mText), "%d", value);
+    rasterise();
+}
+
+// Lays out and draws mText into the render texture, growing it if needed
+void HudText::rasterise() {
+    sRedraws++;
+    mWidth = MeasureText(mText, mFontSize);
+    if (!mHasTarget || mTarget.texture.width < mWidth) {
+        if (mHasTarget) UnloadRenderTexture(mTarget);
+        mTarget = LoadRenderTexture(mWidth > 0 ? mWidth : 1, mFontSize);
+        mHasTarget = true;
+    }
+    BeginTextureMode(mTarget);
+    ClearBackground(BLANK);
+    DrawText(mText, 0, 0, mFontSize, mColour);
+    EndTextureMode();
+}
+
+/**
+ * @brief Blits the cached text with its top left corner at (x, y)
+ */
+void HudText::draw(int x, int y) const {
+    if (!mHasTarget || mWidth == 0) return;
+    // Render textures are stored upside down, so flip the source
+    Rectangle source = {0.0f, 0.0f, static_cast<float>(mWidth),
+                        -static_cast<float>(mFontSize)};
+    DrawTextureRec(mTarget.texture, source,
+                   {static_cast<float>(x), static_cast<float>(y)}, WHITE);
+}
+
+void HudText::drawCentred(int centreX, int y) const {
+    draw(centreX - mWidth / 2, y);
+}
@@ -0,0 +1,43 @@
+// A line of HUD text kept in its own render texture. The text is only laid
+// out and rasterised again when it changes, so drawing it is a single blit
+
+#ifndef HUD_TEXT_H
+#define HUD_TEXT_H
+
+#include "cs3113.h"
+
+class HudText {
+public:
+    static constexpr int MAX_LENGTH = 63;
+
+    HudText(int fontSize, Color colour);
+    ~HudText();
+    HudText(const HudText&) = delete;
+    HudText& operator=(const HudText&) = delete;
+
+    void setText(const char* text);
+    void setNumber(int value);
+    void draw(int x, int y) const;
+    void drawCentred(int centreX, int y) const;
+
+    int getWidth() const { return mWidth; }
+
+    // Times any HudText was rasterised, for checking steady frames don't
+    static int getRedrawCount() { return sRedraws; }
+
+private:
+    void rasterise();
+
+    int mFontSize;
+    Color mColour;
+    char mText[MAX_LENGTH + 1] = "";
+    bool mHasNumber = false; // mText holds mNumber, so it can be compared
+    int mNumber = 0;
+    int mWidth = 0;          // MeasureText() of mText
+    RenderTexture2D mTarget; // Only as wide as the widest text so far
+    bool mHasTarget = false;
+
+    static int sRedraws;
+};
+
+#endif // HUD_TEXT_H
@@ -0,0 +1,169 @@
+#include "Interceptor.h"
+#include <algorithm>
+
+// Stale entries allowed beyond two per ball before the heap is rebuilt
+static const int HEAP_SLACK = 64;
+
+// Heap order: earliest arrival on top, ties to the lower ball index
+static bool arrivesLater(const Intercept& a, const Intercept& b) {
+    return a.time > b.time || (a.time == b.time && a.ball > b.ball);
+}
+
+/**
+ * @brief Works out when ball reaches the face of paddle and where, with the
+ * top and bottom walls folded in: a ball bouncing between them travels a
+ * straight line through mirrored copies of the court
+ * @param ball
+ * @param paddle
+ * @param side PaddleSide of paddle, which says which face it defends
+ * @param outSeconds from now
+ * @param outY ball's centre when it arrives
+ * @param outDirY its vertical direction then, +1 down or -1 up
+ * @return false if the ball is heading away or already past the face
+ */
+bool predictIntercept(const BallState& ball, const PaddleState& paddle,
+                      int side, float& outSeconds, float& outY,
+                      float& outDirY) {
+    float velX = ball.movement.x * ball.speed;
+    float halfWidth = paddle.colliderDimensions.x / 2.0f;
+    float distance;
+    if (side == RIGHT_PADDLE) {
+        if (velX <= 0.0f) return false;
+        distance =
+            paddle.position.x - halfWidth - ball.radius - ball.position.x;
+    } else {
+        if (velX >= 0.0f) return false;
+        distance =
+            ball.position.x - ball.radius - paddle.position.x - halfWidth;
+    }
+    if (distance < 0.0f) return false;
+    float seconds = distance / fabsf(velX);
+    // Distance down the unfolded court, wrapped to one there-and-back
+    float span = SCREEN_HEIGHT - 2.0f * ball.radius;
+    float velY = ball.movement.y * ball.speed;
+    float travelled = fmodf(ball.position.y - ball.radius + velY * seconds,
+                            2.0f * span);
+    if (travelled < 0.0f) travelled += 2.0f * span;
+    bool mirrored = travelled > span; // On its way back up
+    outSeconds = seconds;
+    outY = ball.radius + (mirrored ? 2.0f * span - travelled : travelled);
+    outDirY = (velY >= 0.0f) != mirrored ? 1.0f : -1.0f;
+    return true;
+}
+
+/**
+ * @brief Where the paddle's centre should be to meet a ball AI_AIM_OFFSET
+ * from its centre, on the side that keeps the ball going the way it was
+ * @param paddle
+ * @param ballY
+ * @param dirY the ball's vertical direction as it arrives
+ * @return the paddle's target height
+ */
+float aimAt(const PaddleState& paddle, float ballY, float dirY) {
+    return ballY - dirY * AI_AIM_OFFSET * paddle.scale.y / 2.0f;
+}
+
+/**
+ * @brief Allocates for a pool of up to balls, so updates never allocate
+ * @param balls
+ */
+void Interceptor::reserve(int balls) {
+    mHeap.reserve(2 * balls + HEAP_SLACK);
+    if (static_cast<int>(mStamps.size()) < balls) mStamps.resize(balls, 0);
+}
+
+/**
+ * @brief Predicts every ball from scratch, e.g. when the AI is turned on or
+ * the ball count changes
+ * @param balls
+ * @param paddle the paddle this AI moves
+ * @param now seconds on the simulation clock
+ */
+void Interceptor::rebuild(const BallPool& balls, const PaddleState& paddle,
+                          double now) {
+    mRadius = balls.getRadius();
+    mHeap.clear();
+    reserve(balls.size());
+    Intercept intercept;
+    for (int i = 0; i < balls.size(); i++) {
+        mStamps[i]++;
+        if (predict(balls, i, paddle, now, intercept))
+            mHeap.push_back(intercept);
+    }
+    std::make_heap(mHeap.begin(), mHeap.end(), arrivesLater);
+}
+
+/**
+ * @brief Predicts again only the balls that turned since the last update.
+ * Their old entries stay in the heap until next() drops them
+ * @param balls
+ * @param paddle the paddle this AI moves
+ * @param now seconds on the simulation clock
+ */
+void Interceptor::update(const BallPool& balls, const PaddleState& paddle,
+                         double now) {
+    const std::vector<int>& turned = balls.getTurned();
+    if (balls.allTurned()
+        || mHeap.size() + turned.size()
+               > static_cast<size_t>(2 * balls.size() + HEAP_SLACK)) {
+        rebuild(balls, paddle, now);
+        return;
+    }
+    Intercept intercept;
+    for (int i : turned) {
+        mStamps[i]++;
+        if (!predict(balls, i, paddle, now, intercept)) continue;
+        mHeap.push_back(intercept);
+        std::push_heap(mHeap.begin(), mHeap.end(), arrivesLater);
+    }
+}
+
+/**
+ * @brief Finds the next ball the paddle can still get to. Out of date entries
+ * and balls too far away to reach in time are dropped on the way. A ball due
+ * before now that hasn't turned is predicted again from where it is, which
+ * drops it if it's already past the face, so the paddle stops chasing it
+ * @param balls
+ * @param paddle the paddle this AI moves
+ * @param now seconds on the simulation clock
+ * @param out the earliest reachable arrival
+ * @return false if no ball is on its way to a place the paddle can reach
+ */
+bool Interceptor::next(const BallPool& balls, const PaddleState& paddle,
+                       double now, Intercept& out) {
+    float halfHeight = paddle.scale.y / 2.0f;
+    while (!mHeap.empty()) {
+        Intercept top = mHeap.front();
+        bool current = top.stamp == mStamps[top.ball];
+        float reach = halfHeight + mRadius
+                    + paddle.speed
+                          * static_cast<float>(std::max(0.0, top.time - now));
+        if (current && top.time >= now
+            && fabsf(top.y - paddle.position.y) <= reach) {
+            out = top;
+            return true;
+        }
+        std::pop_heap(mHeap.begin(), mHeap.end(), arrivesLater);
+        mHeap.pop_back();
+        if (current && top.time < now
+            && predict(balls, top.ball, paddle, now, top)) {
+            mHeap.push_back(top);
+            std::push_heap(mHeap.begin(), mHeap.end(), arrivesLater);
+        }
+    }
+    return false;
+}
+
+// Predicts one ball; false if it isn't coming this way
+bool Interceptor::predict(const BallPool& balls, int index,
+                          const PaddleState& paddle, double now,
+                          Intercept& out) {
+    float seconds;
+    if (!predictIntercept(balls.get(index), paddle, mSide, seconds, out.y,
+                          out.dirY))
+        return false;
+    out.time = now + seconds;
+    out.ball = index;
+    out.stamp = mStamps[index];
+    return true;
+}
@@ -0,0 +1,55 @@
+// Predictive paddle AI. Works out when each ball will reach a paddle and
+// where, folding its bounces off the top and bottom walls, and keeps the
+// arrivals in a min-heap ordered by time. A ball is only predicted again when
+// its course changes (BallPool::getTurned()), and entries it leaves behind
+// are dropped lazily when they reach the top, so the AI costs O(log n) per
+// turned ball instead of a scan over every ball each tick. Raylib-free
+
+#ifndef INTERCEPTOR_H
+#define INTERCEPTOR_H
+
+#include "BallPool.h"
+#include "Physics.h"
+#include <stdint.h>
+#include <vector>
+
+// Where on the paddle the AI meets the ball, as a fraction of its half
+// length. Off centre so returns come back at an angle, not flat
+constexpr float AI_AIM_OFFSET = 0.5f;
+
+struct Intercept {
+    double time;    // Seconds on the simulation clock when the ball arrives
+    float y;        // Ball's centre then
+    float dirY;     // Its vertical direction then, +1 down or -1 up
+    int ball;       // Index in the BallPool
+    uint32_t stamp; // Out of date unless it matches the ball's stamp
+};
+
+bool predictIntercept(const BallState& ball, const PaddleState& paddle,
+                      int side, float& outSeconds, float& outY,
+                      float& outDirY);
+float aimAt(const PaddleState& paddle, float ballY, float dirY);
+
+class Interceptor {
+public:
+    explicit Interceptor(int side = RIGHT_PADDLE) : mSide {side} { }
+
+    void reserve(int balls);
+    void rebuild(const BallPool& balls, const PaddleState& paddle, double now);
+    void update(const BallPool& balls, const PaddleState& paddle, double now);
+    bool next(const BallPool& balls, const PaddleState& paddle, double now,
+              Intercept& out);
+
+    int size() const { return static_cast<int>(mHeap.size()); }
+
+private:
+    bool predict(const BallPool& balls, int index, const PaddleState& paddle,
+                 double now, Intercept& out);
+
+    int mSide;
+    float mRadius = 0.0f;
+    std::vector<Intercept> mHeap;  // Earliest arrival at the front
+    std::vector<uint32_t> mStamps; // Per ball, bumped when it turns
+};
+
+#endif // INTERCEPTOR_H
@@ -0,0 +1,151 @@
+#include "NetTransport.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+typedef int socklen_t;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define closesocket ::close
+#endif
+
+static sockaddr_in localhost(uint16_t port) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+NetTransport::~NetTransport() {
+    close();
+}
+
+/**
+ * @brief Binds a non-blocking UDP socket to localhost:localPort that talks to
+ * localhost:peerPort
+ * @return false if the socket can't be made or the port is taken
+ */
+bool NetTransport::open(uint16_t localPort, uint16_t peerPort) {
+    close();
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) return false;
+#endif
+    mSocket = static_cast<intptr_t>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+    if (mSocket < 0) return false;
+    sockaddr_in address = localhost(localPort);
+    bool ok = bind(mSocket, reinterpret_cast<sockaddr*>(&address),
+                   sizeof(address))
+           == 0;
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ok = ok && ioctlsocket(mSocket, FIONBIO, &nonBlocking) == 0;
+#else
+    ok = ok && fcntl(mSocket, F_SETFL, fcntl(mSocket, F_GETFL) | O_NONBLOCK)
+                   == 0;
+#endif
+    if (!ok) {
+        close();
+        return false;
+    }
+    mPeerPort = peerPort;
+    mDelayed.clear();
+    mStats = NetStats();
+    return true;
+}
+
+void NetTransport::close() {
+    if (mSocket < 0) return;
+    closesocket(mSocket);
+    mSocket = -1;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+/**
+ * @brief Simulates a worse connection on everything sent from now on
+ * @param latency seconds each packet is held before it goes out
+ * @param jitter up to this many extra seconds, picked per packet
+ * @param lossRate fraction of packets dropped, from 0 to 1
+ * @param seed for the jitter and loss, so test runs repeat
+ */
+void NetTransport::setConditions(float latency, float jitter, float lossRate,
+                                 uint32_t seed) {
+    mLatency = latency;
+    mJitter = jitter;
+    mLossRate = lossRate;
+    mRng.setSeed(seed);
+}
+
+/**
+ * @brief Queues a datagram for the peer. It goes out once its simulated
+ * latency has passed, on a later send() or receive()
+ * @param data
+ * @param size at most NET_MAX_PACKET bytes
+ * @param now seconds on the caller's clock
+ */
+void NetTransport::send(const uint8_t* data, int size, double now) {
+    if (mSocket < 0 || size <= 0 || size > NET_MAX_PACKET) return;
+    mStats.packetsSent++;
+    mStats.bytesSent += size;
+    if (mLossRate > 0.0f && mRng.range(0, 9999) < mLossRate * 10000.0f) {
+        mStats.packetsDropped++;
+        flush(now);
+        return;
+    }
+    DelayedPacket packet;
+    packet.releaseTime =
+        now + mLatency + mJitter * static_cast<float>(mRng.range(0, 1000))
+                             / 1000.0f;
+    packet.size = size;
+    memcpy(packet.data, data, size);
+    mDelayed.push_back(packet);
+    flush(now);
+}
+
+// Sends every delayed packet whose time has come, earliest first
+void NetTransport::flush(double now) {
+    while (!mDelayed.empty()) {
+        size_t earliest = 0;
+        for (size_t i = 1; i < mDelayed.size(); i++)
+            if (mDelayed[i].releaseTime < mDelayed[earliest].releaseTime)
+                earliest = i;
+        DelayedPacket& packet = mDelayed[earliest];
+        if (packet.releaseTime > now) return;
+        sockaddr_in peer = localhost(mPeerPort);
+        sendto(mSocket, reinterpret_cast<const char*>(packet.data),
+               packet.size, 0, reinterpret_cast<sockaddr*>(&peer),
+               sizeof(peer));
+        mDelayed.erase(mDelayed.begin() + earliest);
+    }
+}
+
+/**
+ * @brief Reads one datagram from the peer without waiting
+ * @param buffer
+ * @param capacity
+ * @param now seconds on the caller's clock, to release delayed sends
+ * @return the datagram's size, or 0 if none has arrived
+ */
+int NetTransport::receive(uint8_t* buffer, int capacity, double now) {
+    if (mSocket < 0) return 0;
+    flush(now);
+    for (;;) {
+        sockaddr_in from;
+        socklen_t fromSize = sizeof(from);
+        int size = static_cast<int>(
+            recvfrom(mSocket, reinterpret_cast<char*>(buffer), capacity, 0,
+                     reinterpret_cast<sockaddr*>(&from), &fromSize));
+        if (size <= 0) return 0;
+        if (ntohs(from.sin_port) != mPeerPort) continue; // Not our peer
+        mStats.packetsReceived++;
+        return size;
+    }
+}
@@ -0,0 +1,59 @@
+// Unreliable datagrams between two processes on this machine over UDP
+// localhost. Outgoing packets can be delayed, jittered and dropped on purpose
+// to test netcode against a bad connection without one
+
+#ifndef NET_TRANSPORT_H
+#define NET_TRANSPORT_H
+
+#include "Physics.h"
+#include <stdint.h>
+#include <vector>
+
+constexpr int NET_MAX_PACKET = 512; // Bytes; larger sends are refused
+
+struct NetStats {
+    uint64_t packetsSent = 0;    // Handed to send(), dropped ones included
+    uint64_t packetsDropped = 0; // Thrown away by the simulated loss
+    uint64_t packetsReceived = 0;
+    uint64_t bytesSent = 0;
+};
+
+class NetTransport {
+public:
+    NetTransport() = default;
+    ~NetTransport();
+    NetTransport(const NetTransport&) = delete;
+    NetTransport& operator=(const NetTransport&) = delete;
+
+    bool open(uint16_t localPort, uint16_t peerPort);
+    void close();
+    void setConditions(float latency, float jitter, float lossRate,
+                       uint32_t seed = 67);
+
+    void send(const uint8_t* data, int size, double now);
+    int receive(uint8_t* buffer, int capacity, double now);
+
+    bool isOpen() const { return mSocket >= 0; }
+
+    const NetStats& getStats() const { return mStats; }
+
+private:
+    struct DelayedPacket {
+        double releaseTime;
+        int size;
+        uint8_t data[NET_MAX_PACKET];
+    };
+
+    void flush(double now);
+
+    intptr_t mSocket = -1;
+    uint16_t mPeerPort = 0;
+    float mLatency = 0.0f; // Seconds added to every packet
+    float mJitter = 0.0f;  // Up to this many more seconds, so packets reorder
+    float mLossRate = 0.0f;
+    Rng mRng;
+    std::vector<DelayedPacket> mDelayed; // Waiting out their latency
+    NetStats mStats;
+};
+
+#endif // NET_TRANSPORT_H
@@ -0,0 +1,444 @@
+#include "Physics.h"
+#include "Telemetry.h"
+#include <algorithm>
+
+// Local copy of the clamp in cs3113.h, which can't be included headless
+template <typename T>
+static T clampValue(T val, T mn, T mx) {
+    return std::min(std::max(val, mn), mx);
+}
+
+/**
+ * @brief Moves the ball for one step: swept collision against both paddles
+ *        and the screen edges, then depenetration as a safety net
+ * @param ball
+ * @param paddles left and right paddle, indexed by PaddleSide
+ * @param deltaTime
+ * @param maxContacts see moveBall()
+ * @return the PaddleSide that scored this step, or NO_PADDLE
+ */
+int stepBall(BallState& ball, const PaddleState paddles[2], float deltaTime,
+             int maxContacts) {
+    // Calculate swept collision normal vectors
+    Vec2 normalLeft, normalRight;
+    float tLeft =
+        sweepCollision(ball, paddles[LEFT_PADDLE], normalLeft, deltaTime);
+    float tRight =
+        sweepCollision(ball, paddles[RIGHT_PADDLE], normalRight, deltaTime);
+    bool hitPaddle;
+    return moveBall(ball, paddles, deltaTime, tLeft, normalLeft, tRight,
+                    normalRight, hitPaddle, maxContacts);
+}
+
+/**
+ * @brief The rest of stepBall() once both sweeps are known, so batched sweeps
+ *        from sweepBatch() can share it. Walks the step contact by contact:
+ *        moves to the earliest paddle hit or wall bounce, resolves it, then
+ *        sweeps the rest of the step again from there. A step without
+ *        contacts costs no more sweeps than before
+ * @param tLeft, normalLeft sweepCollision() result for the left paddle
+ * @param tRight, normalRight sweepCollision() result for the right paddle
+ * @param outHitPaddle set to whether a paddle was hit this step
+ * @param maxContacts contacts resolved before the rest of the step is moved
+ *        unswept; 1 is the old first-contact-only behaviour
+ * @return the PaddleSide that scored this step, or NO_PADDLE
+ */
+int moveBall(BallState& ball, const PaddleState paddles[2], float deltaTime,
+             float tLeft, Vec2 normalLeft, float tRight, Vec2 normalRight,
+             bool& outHitPaddle, int maxContacts) {
+    float elapsed = 0.0f;       // Fraction of the step already moved
+    int lastPaddle = NO_PADDLE; // Paddle hit most recently this step
+    for (int contact = 0;; contact++) {
+        float remaining = 1.0f - elapsed;
+        float stepTime = deltaTime * remaining;
+        // Determine which paddle hit first, if any. A paddle just resolved
+        // is still touching at t = 0, which isn't a new hit
+        if (contact > 0 && lastPaddle == LEFT_PADDLE && tLeft == 0.0f)
+            tLeft = -1.0f;
+        if (contact > 0 && lastPaddle == RIGHT_PADDLE && tRight == 0.0f)
+            tRight = -1.0f;
+        int sweptPaddle = NO_PADDLE;
+        Vec2 contactNormal = {0.0f, 0.0f};
+        float tImpact = -1.0f;
+        if (tLeft >= 0.0f
+            && (tRight < 0.0f || tLeft <= tRight)) { // Left paddle hit first
+            sweptPaddle = LEFT_PADDLE;
+            tImpact = tLeft;
+            contactNormal = normalLeft;
+        } else if (tRight >= 0.0f) { // Right paddle hit first
+            sweptPaddle = RIGHT_PADDLE;
+            tImpact = tRight;
+            contactNormal = normalRight;
+        }
+        // Top or bottom edge, if the ball reaches one this step
+        float tWall = boundaryTime(
+            ball.position.y, ball.movement.y * ball.speed * stepTime,
+            ball.radius, SCREEN_HEIGHT - ball.radius);
+        bool wallFirst =
+            tWall >= 0.0f && (sweptPaddle == NO_PADDLE || tWall < tImpact);
+        if (sweptPaddle == NO_PADDLE && !wallFirst) break;
+        if (contact == maxContacts) {
+            TELEMETRY_COUNT(TM_CONTACT_CAP);
+            break;
+        }
+        if (contact > 0) TELEMETRY_COUNT(TM_EXTRA_CONTACT);
+        if (wallFirst) { // Bounce off the edge and carry on
+            ball.position.x += ball.movement.x * ball.speed * stepTime * tWall;
+            ball.position.y = ball.movement.y < 0.0f ?
+                                  ball.radius :
+                                  SCREEN_HEIGHT - ball.radius;
+            ball.movement.y = -ball.movement.y;
+            elapsed += remaining * tWall;
+        } else {
+            ball.position.x += ball.movement.x * ball.speed * stepTime
+                             * tImpact; // Move to contact point
+            ball.position.y += ball.movement.y * ball.speed * stepTime
+                             * tImpact; // Move to contact point
+            elapsed += remaining * tImpact;
+            resolveCollision(ball, paddles[sweptPaddle], sweptPaddle,
+                             contactNormal, elapsed,
+                             deltaTime); // Resolve collision at contact point
+            TELEMETRY_COUNT(sweptPaddle == LEFT_PADDLE ? TM_HIT_LEFT :
+                                                         TM_HIT_RIGHT);
+            lastPaddle = sweptPaddle;
+        }
+        // Sweep what's left of the step from the paddles' positions now
+        PaddleState moved[2] = {paddles[LEFT_PADDLE], paddles[RIGHT_PADDLE]};
+        for (PaddleState& paddle : moved) {
+            paddle.position.x +=
+                paddle.movement.x * paddle.speed * deltaTime * elapsed;
+            paddle.position.y +=
+                paddle.movement.y * paddle.speed * deltaTime * elapsed;
+        }
+        stepTime = deltaTime * (1.0f - elapsed);
+        tLeft = sweepCollision(ball, moved[LEFT_PADDLE], normalLeft, stepTime);
+        tRight =
+            sweepCollision(ball, moved[RIGHT_PADDLE], normalRight, stepTime);
+    }
+    // Continue moving for remainder of frame
+    float remaining = 1.0f - elapsed;
+    ball.position.x += ball.movement.x * ball.speed * deltaTime * remaining;
+    ball.position.y += ball.movement.y * ball.speed * deltaTime * remaining;
+    // Screen edge clamp, for a ball that ran out of contacts
+    if (ball.position.y - ball.radius < 0) {
+        ball.position.y = ball.radius;
+        ball.movement.y = -ball.movement.y;
+    } else if (ball.position.y + ball.radius > SCREEN_HEIGHT) {
+        ball.position.y = SCREEN_HEIGHT - ball.radius;
+        ball.movement.y = -ball.movement.y;
+    }
+    // Depenetrate hit paddle
+    outHitPaddle = lastPaddle != NO_PADDLE;
+    if (outHitPaddle)
+        depenetrate(ball, paddles[lastPaddle], deltaTime);
+    // Scoring
+    if (ball.position.x - ball.radius > SCREEN_WIDTH) return LEFT_PADDLE;
+    if (ball.position.x + ball.radius < 0) return RIGHT_PADDLE;
+    return NO_PADDLE;
+}
+
+/**
+ * @brief When a ball moving by displacement this step first reaches low or
+ * high along one axis. Use -INFINITY or INFINITY for a side with no bound
+ * @param position
+ * @param displacement
+ * @param low, high
+ * @return fraction of the step in [0, 1], or -1 if it stays between them
+ */
+float boundaryTime(float position, float displacement, float low,
+                   float high) {
+    if (displacement < 0.0f && position + displacement < low)
+        return std::max(0.0f, (low - position) / displacement);
+    if (displacement > 0.0f && position + displacement > high)
+        return std::max(0.0f, (high - position) / displacement);
+    return -1.0f;
+}
+
+/**
+ * @brief Performs a sweep collision check using the slab method
+ * @param ball
+ * @param paddle
+ * @param outNormal normal vector of impact
+ * @param deltaTime
+ * @return the time of impact with the paddle
+ */
+float sweepCollision(const BallState& ball, const PaddleState& paddle,
+                     Vec2& outNormal, float deltaTime) {
+    // Get paddle position and collider
+    Vec2 paddlePos = paddle.position;
+    Vec2 paddleCol = paddle.colliderDimensions;
+    // Calculate paddle collider bounds expanded by ball radius
+    float rectLeft = paddlePos.x - paddleCol.x / 2.0f - ball.radius;
+    float rectRight = paddlePos.x + paddleCol.x / 2.0f + ball.radius;
+    float rectTop = paddlePos.y - paddleCol.y / 2.0f - ball.radius;
+    float rectBottom = paddlePos.y + paddleCol.y / 2.0f + ball.radius;
+    // Compute paddle velocity
+    Vec2 paddleVel = {paddle.movement.x * paddle.speed * deltaTime,
+                      paddle.movement.y * paddle.speed * deltaTime};
+    // Compute relative velocity of the ball with respect to the paddle
+    Vec2 relVel = {ball.movement.x * ball.speed * deltaTime - paddleVel.x,
+                   ball.movement.y * ball.speed * deltaTime - paddleVel.y};
+    // Epsilon is from raymath and its 0.000001f to prevent floating point errs
+    if (fabsf(relVel.x) < PHYSICS_EPSILON
+        && fabsf(relVel.y) < PHYSICS_EPSILON) {
+        TELEMETRY_COUNT(TM_STILL_EARLY_OUT);
+        return -1.0f;
+    }
+    // Initialize entry and exit times for "slab test"
+    // Note: This took a crap ton of googling, reading, and trial and error to
+    // figure out
+    float tEntryX = -INFINITY, tExitX = INFINITY, tEntryY = -INFINITY,
+          tExitY = INFINITY;
+    if (fabsf(relVel.x) < PHYSICS_EPSILON) { // Near 0 horizontal velocity
+        if (ball.position.x < rectLeft || ball.position.x > rectRight) {
+            TELEMETRY_COUNT(TM_STILL_EARLY_OUT);
+            return -1.0f;
+        }
+    }
+    if (fabsf(relVel.y) < PHYSICS_EPSILON) { // Near 0 vertical velocity
+        if (ball.position.y < rectTop || ball.position.y > rectBottom) {
+            TELEMETRY_COUNT(TM_STILL_EARLY_OUT);
+            return -1.0f;
+        }
+    }
+    // Compute horizontal entry and exit times
+    tEntryX = (rectLeft - ball.position.x) / relVel.x;
+    tExitX = (rectRight - ball.position.x) / relVel.x;
+    if (tEntryX > tExitX) std::swap(tEntryX, tExitX);
+    // Compute vertical entry and exit times
+    tEntryY = (rectTop - ball.position.y) / relVel.y;
+    tExitY = (rectBottom - ball.position.y) / relVel.y;
+    if (tEntryY > tExitY) std::swap(tEntryY, tExitY);
+    // Compute overall entry and exit times
+    float tEntry = std::max(tEntryX, tEntryY);
+    float tExit = std::min(tExitX, tExitY);
+    // If no collision this frame, return -1
+    if (tEntry > tExit || // No collision at all (ignore)
+        tExit < 0.0f ||   // Collision in the past (ignore)
+        tEntry > 1.0f)    // Collision in the future (ignore)
+        return -1.0f;
+    // Determine collision normal based on which axis we hit first
+    if (tEntryY > tEntryX) // Hit horizontal face, normal is vertical
+        outNormal = {0.0f, relVel.y > 0 ? -1.0f : 1.0f};
+    else                   // Hit vertical face, normal is horizontal
+        outNormal = {relVel.x > 0 ? -1.0f : 1.0f, 0.0f};
+    if (tEntry < 0.0f && tExit > 0.0f) {
+        tEntry = 0.0f; // Clamp to 0 if collision at start of frame
+        TELEMETRY_COUNT(TM_CLAMPED_ENTRY);
+    }
+    return tEntry; // Return time of impact
+}
+
+/**
+ * @brief Resolves bounce direction and speed after a collision with one of
+ * the two classic paddles, the left one facing right and the right one left.
+ * Assumes position corrected by the caller
+ * @param ball
+ * @param paddle
+ * @param paddleIndex PaddleSide of the paddle, remembered as lastCollision
+ * @param normal
+ * @param tImpact
+ * @param deltaTime
+ */
+void resolveCollision(BallState& ball, const PaddleState& paddle,
+                      int paddleIndex, Vec2 normal, float tImpact,
+                      float deltaTime) {
+    Vec2 facing = {paddleIndex == LEFT_PADDLE ? 1.0f : -1.0f, 0.0f};
+    resolvePaddleHit(ball, paddle, paddleIndex, facing, normal, tImpact,
+                     deltaTime);
+}
+
+/**
+ * @brief Resolves bounce direction and speed after hitting a paddle that
+ * faces any of the four screen directions. Assumes position corrected by the
+ * caller
+ * @param ball
+ * @param paddle
+ * @param paddleId remembered as lastCollision; a new id speeds the ball up
+ * @param facing direction the paddle sends the ball, along x or y
+ * @param normal face of the paddle that was hit
+ * @param tImpact
+ * @param deltaTime
+ */
+void resolvePaddleHit(BallState& ball, const PaddleState& paddle, int paddleId,
+                      Vec2 facing, Vec2 normal, float tImpact,
+                      float deltaTime) {
+    // "Along" is the axis the paddle faces, "across" is the paddle's length
+    bool facesX = fabsf(facing.x) > 0.5f;
+    float& moveAlong = facesX ? ball.movement.x : ball.movement.y;
+    float& moveAcross = facesX ? ball.movement.y : ball.movement.x;
+    if (fabsf(facesX ? normal.y : normal.x) > 0.5f) {
+        // End face: reflect movement across the paddle
+        moveAcross = -moveAcross;
+    } else {
+        // Front or back face: apply hit offset based on paddle position at
+        // tImpact
+        float paddleHalfLength = (facesX ? paddle.scale.y : paddle.scale.x)
+                               / 2.0f;
+        // Compute paddle position at time of impact
+        float paddleAcrossAtImpact =
+            (facesX ? paddle.position.y : paddle.position.x)
+            + (facesX ? paddle.movement.y : paddle.movement.x) * paddle.speed
+                  * deltaTime * tImpact;
+        float ballAcross = facesX ? ball.position.y : ball.position.x;
+        float hitOffset =
+            clampValue((ballAcross - paddleAcrossAtImpact) / paddleHalfLength,
+                       -1.0f, 1.0f);
+        moveAcross = hitOffset;
+        // Normalise movement
+        float magnitude = sqrtf(ball.movement.x * ball.movement.x
+                                + ball.movement.y * ball.movement.y);
+        ball.movement.x /= magnitude;
+        ball.movement.y /= magnitude;
+    }
+    // Force direction along the facing axis based on paddle center
+    float facingSign = (facesX ? facing.x : facing.y) > 0.0f ? 1.0f : -1.0f;
+    float ballAlong = facesX ? ball.position.x : ball.position.y;
+    float paddleAlong = facesX ? paddle.position.x : paddle.position.y;
+    bool behindPaddle = facingSign > 0.0f ? ballAlong < paddleAlong :
+                                            ballAlong > paddleAlong;
+    moveAlong = behindPaddle ? -facingSign : facingSign;
+    // If new collision, speed up
+    if (paddleId != ball.lastCollision) {
+        ball.speedMultiplier += 0.1f;
+        ball.lastCollision = paddleId;
+    }
+    // Truncated to a whole number, as Entity's integer mSpeed was
+    ball.speed = static_cast<float>(
+        static_cast<int>(ball.baseSpeed * ball.speedMultiplier));
+}
+
+/**
+ * @brief Corrects residual overlap between paddle and the ball. Does not count
+ * as a collision
+ * @param ball
+ * @param paddle
+ * @param deltaTime
+ */
+void depenetrate(BallState& ball, const PaddleState& paddle, float deltaTime) {
+    // Compute paddle position at end of frame
+    Vec2 paddlePos = {
+        paddle.position.x + paddle.movement.x * paddle.speed * deltaTime,
+        paddle.position.y + paddle.movement.y * paddle.speed * deltaTime};
+    Vec2 paddleCol = paddle.colliderDimensions;
+    // Calculate paddle collider bounds
+    float rectLeft = paddlePos.x - paddleCol.x / 2.0f;
+    float rectRight = paddlePos.x + paddleCol.x / 2.0f;
+    float rectTop = paddlePos.y - paddleCol.y / 2.0f;
+    float rectBottom = paddlePos.y + paddleCol.y / 2.0f;
+    // Find closest point on paddle bounds to ball center
+    float pointX = clampValue(ball.position.x, rectLeft, rectRight);
+    float pointY = clampValue(ball.position.y, rectTop, rectBottom);
+    // Check if closest point is inside ball radius
+    float distX = ball.position.x - pointX;
+    float distY = ball.position.y - pointY;
+    float distSq = distX * distX + distY * distY;
+    // Case 1: No overlap at all: return
+    if (distSq >= ball.radius * ball.radius) return;
+    // Case 2: Ball center inside paddle bounds: push out along shallowest axis
+    if (distSq == 0.0f) {
+        TELEMETRY_COUNT(TM_DEPEN_INSIDE);
+        // Calculate overlap on each side
+        float overlapLeft = ball.position.x - rectLeft;
+        float overlapRight = rectRight - ball.position.x;
+        float overlapTop = ball.position.y - rectTop;
+        float overlapBottom = rectBottom - ball.position.y;
+        // Find minimum overlap: calculate minimum translation vector (mtv)
+        // RIP Music Television 24/7 music channels
+        float minOverlap = overlapLeft; // left
+        Vec2 mtv = {-(minOverlap + ball.radius), 0.0f};
+        if (overlapRight < minOverlap) { // right
+            minOverlap = overlapRight;
+            mtv = {minOverlap + ball.radius, 0.0f};
+        }
+        if (overlapTop < minOverlap) { // up
+            minOverlap = overlapTop;
+            mtv = {0.0f, -(minOverlap + ball.radius)};
+        }
+        if (overlapBottom < minOverlap) { // down
+            mtv = {0.0f, overlapBottom + ball.radius};
+        }
+        // Adjust position by mtv
+        ball.position.x += mtv.x;
+        ball.position.y += mtv.y;
+    } else { // Case 3: Center outside paddle but still overlapping
+        TELEMETRY_COUNT(TM_DEPEN_OVERLAP);
+        float dist =
+            sqrtf(distSq); // Distance from ball center to closest point
+        float penetration = ball.radius - dist; // How much to push ball out
+        ball.position.x += (distX / dist) * penetration;
+        ball.position.y += (distY / dist) * penetration;
+    }
+}
+
+/**
+ * @brief Resets the ball's position and speed and serves it at an angle
+ * @param ball
+ * @param angleDegrees serve angle, in [-45, 45]
+ * @param towardsRight serve direction
+ */
+void resetBall(BallState& ball, int angleDegrees, bool towardsRight) {
+    ball.position = {SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+    ball.speedMultiplier = 1.0f;
+    ball.speed = ball.baseSpeed;
+    ball.lastCollision = NO_PADDLE;
+    // Convert angle to movement vector
+    float angle = angleDegrees * PHYSICS_DEG2RAD;
+    float dirX = towardsRight ? 1.0f : -1.0f;
+    ball.movement = {dirX * cosf(angle), sinf(angle)};
+}
+
+/**
+ * @brief Resets the ball with a random serve drawn from rng, in the same
+ * order the old Ball::reset() drew from GetRandomValue()
+ */
+void resetBall(BallState& ball, Rng& rng) {
+    int angleDegrees = rng.range(-45, 45);
+    bool towardsRight = rng.range(0, 1) != 0;
+    resetBall(ball, angleDegrees, towardsRight);
+}
+
+/**
+ * @brief A still paddle at the middle of its edge of the screen
+ * @param side LEFT_PADDLE or RIGHT_PADDLE
+ */
+PaddleState makePaddle(int side) {
+    PaddleState paddle;
+    paddle.position = {side == LEFT_PADDLE ? PADDLE_MARGIN :
+                                             SCREEN_WIDTH - PADDLE_MARGIN,
+                       SCREEN_HEIGHT / 2};
+    paddle.movement = {0.0f, 0.0f};
+    paddle.colliderDimensions = {PADDLE_WIDTH, PADDLE_HEIGHT};
+    paddle.scale = {PADDLE_WIDTH, PADDLE_HEIGHT};
+    paddle.speed = PADDLE_SPEED;
+    return paddle;
+}
+
+/**
+ * @brief Moves the paddle, clamps it to screen edges and resets movement
+ * @param paddle
+ * @param deltaTime
+ */
+void stepPaddle(PaddleState& paddle, float deltaTime) {
+    paddle.position.x += paddle.speed * paddle.movement.x * deltaTime;
+    paddle.position.y += paddle.speed * paddle.movement.y * deltaTime;
+    float halfHeight = paddle.scale.y / 2.0f;
+    // Clamp to screen edges
+    paddle.position.y =
+        clampValue(paddle.position.y, halfHeight, SCREEN_HEIGHT - halfHeight);
+    paddle.movement = {0.0f, 0.0f};
+}
+
+/**
+ * @brief Moves the paddle towards a target height at up to full speed, but
+ * no further than the target, so it stops there without a deadzone or jitter
+ * @param paddle
+ * @param targetY
+ * @param deltaTime of the tick the movement is for
+ */
+void steerPaddle(PaddleState& paddle, float targetY, float deltaTime) {
+    float fullStep = paddle.speed * deltaTime;
+    if (fullStep <= 0.0f) return;
+    paddle.movement.y =
+        clampValue((targetY - paddle.position.y) / fullStep, -1.0f, 1.0f);
+}
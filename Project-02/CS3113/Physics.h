@@ -0,0 +1,92 @@
+// Raylib-free physics core. Simulation, BallPool, CollisionWorld and EventSim
+// all run the same swept AABB code from here, so it must not include cs3113.h
+
+#ifndef PHYSICS_H
+#define PHYSICS_H
+
+#include "Constants.h"
+#include <math.h>
+#include <stdint.h>
+
+// Same layout as raylib's Vector2, without needing raylib.h
+struct Vec2 {
+    float x;
+    float y;
+};
+
+constexpr float PHYSICS_EPSILON = 0.000001f; // Same value as raymath EPSILON
+constexpr float PHYSICS_DEG2RAD = 3.14159265358979323846f / 180.0f;
+
+// Most paddle hits and wall bounces one ball step resolves before moving
+// the rest of the way unswept
+constexpr int CCD_MAX_CONTACTS = 8;
+
+// Paddle indices; also used to report which side scored
+enum PaddleSide { NO_PADDLE = -1, LEFT_PADDLE = 0, RIGHT_PADDLE = 1 };
+
+struct PaddleState {
+    Vec2 position;
+    Vec2 movement;
+    Vec2 colliderDimensions;
+    Vec2 scale;
+    float speed;
+};
+
+struct BallState {
+    Vec2 position;
+    Vec2 movement;
+    float speed;
+    float baseSpeed;
+    float speedMultiplier;
+    float radius;
+    int lastCollision; // PaddleSide of the last paddle hit
+};
+
+// Small deterministic generator so headless runs are reproducible.
+// range() has the same inclusive bounds as raylib's GetRandomValue()
+class Rng {
+public:
+    explicit Rng(uint32_t seed = 67) { setSeed(seed); }
+
+    void setSeed(uint32_t seed) { mState = seed ? seed : 0x9E3779B9u; }
+
+    uint32_t next() {
+        // xorshift32
+        mState ^= mState << 13;
+        mState ^= mState >> 17;
+        mState ^= mState << 5;
+        return mState;
+    }
+
+    int range(int min, int max) {
+        return min + static_cast<int>(next() % (uint32_t)(max - min + 1));
+    }
+
+private:
+    uint32_t mState;
+};
+
+float sweepCollision(const BallState& ball, const PaddleState& paddle,
+                     Vec2& outNormal, float deltaTime);
+void resolveCollision(BallState& ball, const PaddleState& paddle,
+                      int paddleIndex, Vec2 normal, float tImpact,
+                      float deltaTime);
+void resolvePaddleHit(BallState& ball, const PaddleState& paddle, int paddleId,
+                      Vec2 facing, Vec2 normal, float tImpact,
+                      float deltaTime);
+void depenetrate(BallState& ball, const PaddleState& paddle, float deltaTime);
+int stepBall(BallState& ball, const PaddleState paddles[2], float deltaTime,
+             int maxContacts = CCD_MAX_CONTACTS);
+int moveBall(BallState& ball, const PaddleState paddles[2], float deltaTime,
+             float tLeft, Vec2 normalLeft, float tRight, Vec2 normalRight,
+             bool& outHitPaddle, int maxContacts = CCD_MAX_CONTACTS);
+float boundaryTime(float position, float displacement, float low,
+                   float high);
+void resetBall(BallState& ball, int angleDegrees, bool towardsRight);
+void resetBall(BallState& ball, Rng& rng);
+
+PaddleState makePaddle(int side);
+void stepPaddle(PaddleState& paddle, float deltaTime);
+void steerPaddle(PaddleState& paddle, float targetY, float deltaTime);
+
+#endif // PHYSICS_H
@@ -0,0 +1,109 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <stdio.h>
+
+// Per thread, so a Simulation ticking on a SimThread doesn't write into the
+// render thread's frame
+static thread_local bool sEnabled = false;
+static float sCurrent[PHASE_COUNT];                   // Frame being timed (ms)
+static float sHistory[PROFILER_HISTORY][PHASE_COUNT]; // Ring of past frames
+static int sNext = 0;                    // Ring slot endFrame() writes next
+static int sFrames = 0;                  // Frames in the ring so far
+static float sScratch[PROFILER_HISTORY]; // Partially sorted for percentiles
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "frame",  "input",    "update", "ai",     "balls", "paddles",
+    "render", "entities", "text",   "switch", "upload"};
+
+void Profiler::setEnabled(bool enabled) { sEnabled = enabled; }
+
+bool Profiler::isEnabled() { return sEnabled; }
+
+/**
+ * @brief Pushes the phase times collected since the last call into the ring,
+ * overwriting the oldest frame once it's full
+ */
+void Profiler::endFrame() {
+    if (!sEnabled) return;
+    std::copy(sCurrent, sCurrent + PHASE_COUNT, sHistory[sNext]);
+    std::fill(sCurrent, sCurrent + PHASE_COUNT, 0.0f);
+    sNext = (sNext + 1) % PROFILER_HISTORY;
+    sFrames = std::min(sFrames + 1, PROFILER_HISTORY);
+}
+
+/**
+ * @brief Adds to a phase of the current frame. Phases that run more than once
+ * a frame (the Simulation's, once per tick) are summed
+ */
+void Profiler::add(ProfilePhase phase, double seconds) {
+    sCurrent[phase] += static_cast<float>(seconds * 1000.0);
+}
+
+int Profiler::getFrameCount() { return sFrames; }
+
+/**
+ * @param phase
+ * @param framesAgo 0 for the last finished frame
+ * @return the phase's time in that frame in milliseconds, 0 if not recorded
+ */
+float Profiler::getMilliseconds(ProfilePhase phase, int framesAgo) {
+    if (framesAgo < 0 || framesAgo >= sFrames) return 0.0f;
+    int slot = (sNext - 1 - framesAgo + PROFILER_HISTORY) % PROFILER_HISTORY;
+    return sHistory[slot][phase];
+}
+
+/**
+ * @brief Nearest-rank percentile of a phase over the frames in the ring
+ * @param phase
+ * @param percentile 0 to 100
+ * @return milliseconds, 0 if nothing has been recorded
+ */
+float Profiler::getPercentile(ProfilePhase phase, float percentile) {
+    if (sFrames == 0) return 0.0f;
+    for (int i = 0; i < sFrames; i++) sScratch[i] = sHistory[i][phase];
+    int rank = static_cast<int>(percentile / 100.0f * (sFrames - 1) + 0.5f);
+    rank = std::max(0, std::min(sFrames - 1, rank));
+    std::nth_element(sScratch, sScratch + rank, sScratch + sFrames);
+    return sScratch[rank];
+}
+
+/**
+ * @param phase
+ * @return the phase's slowest frame in the ring in milliseconds, so rare
+ * spikes like mode switches show up even when they're under 1% of frames
+ */
+float Profiler::getMaximum(ProfilePhase phase) {
+    float maximum = 0.0f;
+    for (int i = 0; i < sFrames; i++)
+        maximum = std::max(maximum, sHistory[i][phase]);
+    return maximum;
+}
+
+const char* Profiler::getPhaseName(ProfilePhase phase) {
+    return PHASE_NAMES[phase];
+}
+
+/**
+ * @brief Writes the ring, oldest frame first, one row per frame and one
+ * column of milliseconds per phase
+ * @param filepath
+ * @return false if the file couldn't be opened
+ */
+bool Profiler::writeCsv(const char* filepath) {
+    FILE* file = fopen(filepath, "w");
+    if (!file) return false;
+    fprintf(file, "frame");
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+        fprintf(file, ",%s_ms", PHASE_NAMES[phase]);
+    fprintf(file, "\n");
+    for (int frame = 0; frame < sFrames; frame++) {
+        fprintf(file, "%d", frame);
+        for (int phase = 0; phase < PHASE_COUNT; phase++)
+            fprintf(file, ",%.4f",
+                    getMilliseconds(static_cast<ProfilePhase>(phase),
+                                    sFrames - 1 - frame));
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    return true;
+}
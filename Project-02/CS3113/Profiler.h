@@ -0,0 +1,66 @@
+// Per-phase frame timings kept in a fixed ring buffer. Raylib-free so the
+// Simulation can time its own phases; main.cpp draws the overlay
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+
+enum ProfilePhase {
+    PHASE_FRAME,    // Whole main loop iteration, including the FPS wait
+    PHASE_INPUT,    // processInput()
+    PHASE_UPDATE,   // update()
+    PHASE_AI,       // Simulation AI, summed over the frame's ticks
+    PHASE_BALLS,    // Ball update and ball-ball collisions, summed
+    PHASE_PADDLES,  // Paddle steps, summed
+    PHASE_RENDER,   // render() up to EndDrawing()
+    PHASE_ENTITIES, // Paddles and balls through the SpriteBatch
+    PHASE_TEXT,     // renderAllText()
+    PHASE_SWITCH,   // Commands: ball count and other mode switches
+    PHASE_UPLOAD,   // Texture uploads from the AssetLoader
+    PHASE_COUNT
+};
+
+constexpr int PROFILER_HISTORY = 1200; // Frames kept (10 s at 120 FPS)
+
+class Profiler {
+public:
+    // Only affects the calling thread; other threads' scopes stay off
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    static void endFrame();
+    static void add(ProfilePhase phase, double seconds);
+
+    static int getFrameCount();
+    static float getMilliseconds(ProfilePhase phase, int framesAgo);
+    static float getPercentile(ProfilePhase phase, float percentile);
+    static float getMaximum(ProfilePhase phase);
+    static const char* getPhaseName(ProfilePhase phase);
+
+    static bool writeCsv(const char* filepath);
+};
+
+// Adds the time until the end of its scope to a phase. Does nothing, not
+// even reading the clock, while the profiler is off
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase phase) :
+        mPhase {phase}, mActive {Profiler::isEnabled()} {
+        if (mActive) mStart = std::chrono::steady_clock::now();
+    }
+
+    ~ProfileScope() {
+        if (!mActive) return;
+        Profiler::add(mPhase, std::chrono::duration<double>(
+                                  std::chrono::steady_clock::now() - mStart)
+                                  .count());
+    }
+
+private:
+    ProfilePhase mPhase;
+    bool mActive;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+#endif // PROFILER_H
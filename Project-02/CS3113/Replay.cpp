@@ -0,0 +1,259 @@
+#include "Replay.h"
+
+// File layout, all little-endian:
+//   "PONGRPL" + version byte, uint32 seed, uint32 tick rate (Hz)
+//   then items until REPLAY_END:
+//     0x00-0x0F  tick run: the byte is the InputBits, then a varint count
+//     0x80 | ReplayEventType, then a varint value
+static const uint8_t REPLAY_MAGIC[7] = {'P', 'O', 'N', 'G', 'R', 'P', 'L'};
+// 2: the AI predicts intercepts, so version 1 single player logs would desync
+// 3: the AI re-predicts balls it missed, so version 2 ones would too
+static const uint8_t REPLAY_VERSION = 3;
+static const uint8_t REPLAY_EVENT_FLAG = 0x80;
+static const uint8_t REPLAY_INPUT_MAX = 0x0F; // Every InputBits set
+static const uint8_t REPLAY_END = 0xFF;
+static const int REPLAY_HEADER_SIZE = 16;
+
+static void writeUint32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint32_t readUint32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= (uint32_t)in[i] << (8 * i);
+    return value;
+}
+
+/**
+ * @brief Whether a command read from a log is one a writer could have
+ * recorded: a known type, and a ball count the pool can hold
+ * @param event
+ */
+static bool isValidEvent(const ReplayEvent& event) {
+    switch (event.type) {
+    case REPLAY_BALL_COUNT :
+        return event.value >= 1 && event.value <= (uint32_t)BALL_POOL_CAPACITY;
+    case REPLAY_SINGLE_PLAYER :
+    case REPLAY_BALL_COLLISIONS :
+    case REPLAY_RESET :
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Runs a command on the Simulation the same way main.cpp does
+ * @param simulation
+ * @param event
+ */
+void applyReplayEvent(Simulation& simulation, const ReplayEvent& event) {
+    switch (event.type) {
+    case REPLAY_BALL_COUNT :
+        simulation.setBallCount(static_cast<int>(event.value));
+        break;
+    case REPLAY_SINGLE_PLAYER :
+        simulation.setAI(RIGHT_PADDLE, event.value != 0);
+        break;
+    case REPLAY_BALL_COLLISIONS :
+        simulation.setBallCollisions(event.value != 0);
+        break;
+    case REPLAY_RESET : // Back to a single ball, 2 player mode
+        simulation.resetMatch();
+        simulation.setBallCount(1);
+        simulation.setAI(RIGHT_PADDLE, false);
+        break;
+    }
+}
+
+/**
+ * @brief Starts a log, replacing any file at filepath
+ * @return false if the file couldn't be opened
+ */
+bool ReplayWriter::open(const char* filepath, uint32_t seed,
+                        uint32_t tickRate) {
+    close();
+    mFile = fopen(filepath, "wb");
+    if (!mFile) return false;
+    uint8_t header[REPLAY_HEADER_SIZE];
+    for (int i = 0; i < 7; i++) header[i] = REPLAY_MAGIC[i];
+    header[7] = REPLAY_VERSION;
+    writeUint32(header + 8, seed);
+    writeUint32(header + 12, tickRate);
+    fwrite(header, 1, sizeof(header), mFile);
+    mRunLength = 0;
+    mTicks = 0;
+    return true;
+}
+
+void ReplayWriter::event(const ReplayEvent& event) {
+    if (!mFile) return;
+    flushRun(); // Keeps the event between the same two ticks
+    writeByte(REPLAY_EVENT_FLAG | event.type);
+    writeVarint(event.value);
+}
+
+/**
+ * @brief Records the input of one tick. Repeats of the previous tick's input
+ * only grow the pending run
+ * @param input InputBits
+ */
+void ReplayWriter::tick(uint8_t input) {
+    if (!mFile) return;
+    if (mRunLength > 0 && input == mRunInput && mRunLength < UINT32_MAX) {
+        mRunLength++;
+    } else {
+        flushRun();
+        mRunInput = input;
+        mRunLength = 1;
+    }
+    mTicks++;
+}
+
+// Writes the pending run and the end marker
+void ReplayWriter::close() {
+    if (!mFile) return;
+    flushRun();
+    writeByte(REPLAY_END);
+    fclose(mFile);
+    mFile = nullptr;
+}
+
+void ReplayWriter::flushRun() {
+    if (mRunLength == 0) return;
+    writeByte(mRunInput);
+    writeVarint(mRunLength);
+    mRunLength = 0;
+}
+
+void ReplayWriter::writeByte(uint8_t byte) { fputc(byte, mFile); }
+
+// 7 bits per byte, low bits first, top bit set on all but the last byte
+void ReplayWriter::writeVarint(uint32_t value) {
+    while (value >= 0x80) {
+        writeByte((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    writeByte((uint8_t)value);
+}
+
+/**
+ * @brief Loads a whole log into memory and checks its header
+ * @return false if the file is missing or isn't a replay this version reads
+ */
+bool ReplayReader::open(const char* filepath) {
+    FILE* file = fopen(filepath, "rb");
+    if (!file) return false;
+    mData.clear();
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        mData.insert(mData.end(), buffer, buffer + read);
+    fclose(file);
+
+    if (mData.size() < REPLAY_HEADER_SIZE) return false;
+    for (int i = 0; i < 7; i++)
+        if (mData[i] != REPLAY_MAGIC[i]) return false;
+    if (mData[7] != REPLAY_VERSION) return false;
+    mSeed = readUint32(&mData[8]);
+    mTickRate = readUint32(&mData[12]);
+    mCursor = REPLAY_HEADER_SIZE;
+    mRunLeft = 0;
+    mHasEvent = false;
+    mEnded = false;
+    mTick = 0;
+    return mTickRate > 0;
+}
+
+/**
+ * @brief Hands out the next command if it comes before the next tick
+ * @param event
+ * @return false if a tick (or the end of the log) comes first
+ */
+bool ReplayReader::nextEvent(ReplayEvent& event) {
+    if (mRunLeft == 0 && !mHasEvent) readItem();
+    if (!mHasEvent) return false;
+    event = mEvent;
+    mHasEvent = false;
+    return true;
+}
+
+/**
+ * @brief Hands out the next tick's input. Commands due before it have to be
+ * taken with nextEvent() first
+ * @param input InputBits
+ * @return false if a command (or the end of the log) comes first
+ */
+bool ReplayReader::nextTick(uint8_t& input) {
+    if (mRunLeft == 0 && !mHasEvent) readItem();
+    if (mRunLeft == 0) return false;
+    input = mRunInput;
+    mRunLeft--;
+    mTick++;
+    return true;
+}
+
+bool ReplayReader::isFinished() {
+    if (mRunLeft == 0 && !mHasEvent) readItem();
+    return mRunLeft == 0 && !mHasEvent;
+}
+
+// Reads one run or event. A truncated or corrupt log just ends early:
+// unknown tags and commands, and ball counts the pool can't hold, stop it
+bool ReplayReader::readItem() {
+    if (mEnded || mCursor >= mData.size()) {
+        mEnded = true;
+        return false;
+    }
+    uint8_t tag = mData[mCursor++];
+    uint32_t value;
+    if (tag == REPLAY_END || !readVarint(value)) {
+        mEnded = true;
+        return false;
+    }
+    if (tag & REPLAY_EVENT_FLAG) {
+        mEvent.type = static_cast<ReplayEventType>(tag & ~REPLAY_EVENT_FLAG);
+        mEvent.value = value;
+        if (!isValidEvent(mEvent)) {
+            mEnded = true;
+            return false;
+        }
+        mHasEvent = true;
+    } else if (tag > REPLAY_INPUT_MAX) { // Not an InputBits combination
+        mEnded = true;
+        return false;
+    } else {
+        mRunInput = tag;
+        mRunLeft = value;
+    }
+    return true;
+}
+
+bool ReplayReader::readVarint(uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (mCursor >= mData.size()) return false;
+        uint8_t byte = mData[mCursor++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Plays the rest of a log into a Simulation as fast as it will go
+ * @param reader
+ * @param simulation built with the log's seed and tick rate
+ * @return ticks played
+ */
+uint64_t playReplay(ReplayReader& reader, Simulation& simulation) {
+    uint64_t ticks = 0;
+    ReplayEvent event;
+    uint8_t input;
+    while (true) {
+        while (reader.nextEvent(event)) applyReplayEvent(simulation, event);
+        if (!reader.nextTick(input)) break;
+        simulation.step(input);
+        ticks++;
+    }
+    return ticks;
+}
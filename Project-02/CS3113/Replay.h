@@ -0,0 +1,85 @@
+// Compact binary match logs: the seed and tick rate, then every tick's
+// InputBits run-length encoded, with game commands in between. Playing a log
+// back into a Simulation built from its header gives the same match
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "Simulation.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Commands that change the Simulation between ticks
+enum ReplayEventType : uint8_t {
+    REPLAY_BALL_COUNT = 1,      // value: ball count
+    REPLAY_SINGLE_PLAYER = 2,   // value: 1 for AI right paddle
+    REPLAY_BALL_COLLISIONS = 3, // value: 1 for ball-ball collisions
+    REPLAY_RESET = 4,           // value unused
+};
+
+struct ReplayEvent {
+    ReplayEventType type;
+    uint32_t value;
+};
+
+void applyReplayEvent(Simulation& simulation, const ReplayEvent& event);
+
+class ReplayWriter {
+public:
+    ReplayWriter() { }
+
+    ~ReplayWriter() { close(); }
+
+    bool open(const char* filepath, uint32_t seed, uint32_t tickRate);
+    void event(const ReplayEvent& event);
+    void tick(uint8_t input);
+    void close();
+
+    uint64_t getTicks() const { return mTicks; }
+
+private:
+    void flushRun();
+    void writeByte(uint8_t byte);
+    void writeVarint(uint32_t value);
+
+    FILE* mFile = nullptr;
+    uint8_t mRunInput = 0;   // Input repeated by the pending run
+    uint32_t mRunLength = 0; // Ticks in the pending run, 0 if none
+    uint64_t mTicks = 0;
+};
+
+class ReplayReader {
+public:
+    bool open(const char* filepath);
+
+    uint32_t getSeed() const { return mSeed; }
+
+    uint32_t getTickRate() const { return mTickRate; }
+
+    bool nextEvent(ReplayEvent& event);
+    bool nextTick(uint8_t& input);
+
+    bool isFinished();
+
+    uint64_t getTick() const { return mTick; }
+
+private:
+    bool readItem();
+    bool readVarint(uint32_t& value);
+
+    std::vector<uint8_t> mData;
+    size_t mCursor = 0;
+    uint32_t mSeed = 0;
+    uint32_t mTickRate = 0;
+    uint8_t mRunInput = 0;
+    uint32_t mRunLeft = 0; // Ticks left in the current run
+    bool mHasEvent = false; // mEvent read but not handed out yet
+    ReplayEvent mEvent;
+    bool mEnded = false;
+    uint64_t mTick = 0;
+};
+
+uint64_t playReplay(ReplayReader& reader, Simulation& simulation);
+
+#endif // REPLAY_H
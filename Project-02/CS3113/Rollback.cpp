@@ -0,0 +1,174 @@
+#include "Rollback.h"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+typedef std::chrono::steady_clock Clock;
+
+// Input packet: magic, our inputs acknowledged as received (count), first
+// tick carried, number of inputs, then one InputBits byte per tick. Every
+// packet repeats all inputs the peer hasn't acknowledged, so a lost packet
+// is covered by the next one
+static const uint8_t PACKET_MAGIC[2] = {'R', 'B'};
+static const int PACKET_HEADER = 11;
+
+static const uint64_t NO_ROLLBACK = UINT64_MAX;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void writeU32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<uint8_t>(value >> 8 * i);
+}
+
+static uint32_t readU32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= static_cast<uint32_t>(in[i]) << 8 * i;
+    return value;
+}
+
+/**
+ * @brief Takes over stepping simulation, which must start in the same state
+ * on both peers
+ * @param simulation
+ * @param transport already open to the peer
+ * @param localSide PaddleSide this peer's player controls
+ */
+RollbackSession::RollbackSession(Simulation& simulation,
+                                 NetTransport& transport, int localSide) :
+    mSimulation {simulation}, mTransport {transport},
+    mRollbackFrom {NO_ROLLBACK}, mSnapshots(ROLLBACK_WINDOW) {
+    uint8_t left = INPUT_LEFT_UP | INPUT_LEFT_DOWN;
+    uint8_t right = INPUT_RIGHT_UP | INPUT_RIGHT_DOWN;
+    mLocalMask = localSide == LEFT_PADDLE ? left : right;
+    mRemoteMask = localSide == LEFT_PADDLE ? right : left;
+    memset(mLocalInputs, 0, sizeof(mLocalInputs));
+    memset(mRemoteInputs, 0, sizeof(mRemoteInputs));
+    memset(mPredicted, 0, sizeof(mPredicted));
+}
+
+/**
+ * @brief Runs the next tick with this player's input, after rolling back any
+ * ticks the peer's newly arrived inputs prove wrong. Stalls instead if the
+ * peer is so far behind that its inputs could land outside the window
+ * @param localInput InputBits held; bits for the other paddle are ignored
+ * @param now seconds on the caller's clock, for the transport
+ * @return false if the tick had to wait for the peer
+ */
+bool RollbackSession::advance(uint8_t localInput, double now) {
+    receive(now);
+    rollback();
+    // The peer may be ahead of us, so compare without subtracting
+    if (mTick >= mRemoteCount + ROLLBACK_WINDOW
+        || mTick >= mPeerCount + ROLLBACK_WINDOW) {
+        mStats.stalls++;
+        sendInputs(now);
+        return false;
+    }
+    mLocalInputs[mTick % ROLLBACK_INPUT_RING] = localInput & mLocalMask;
+    simulate(mTick);
+    mTick++;
+    mStats.ticks++;
+    sendInputs(now);
+    return true;
+}
+
+/**
+ * @brief Handles the peer's packets and resends unacknowledged inputs without
+ * stepping, e.g. while paused or once a match is over
+ */
+void RollbackSession::poll(double now) {
+    receive(now);
+    rollback();
+    sendInputs(now);
+}
+
+/**
+ * @brief A score only counting ticks stepped with the peer's real input, so a
+ * point a rollback could still take back isn't shown as a win
+ */
+int RollbackSession::getConfirmedScore(int side) const {
+    if (isSynchronized()) {
+        return side == LEFT_PADDLE ? mSimulation.getLeftScore() :
+                                     mSimulation.getRightScore();
+    }
+    // The snapshot before the first guessed tick holds the confirmed state
+    return mSnapshots[mRemoteCount % ROLLBACK_WINDOW].scores[side];
+}
+
+// Reads every packet that has arrived, noting the earliest wrong guess
+void RollbackSession::receive(double now) {
+    uint8_t packet[NET_MAX_PACKET];
+    int size;
+    while ((size = mTransport.receive(packet, sizeof(packet), now)) > 0) {
+        if (size < PACKET_HEADER || packet[0] != PACKET_MAGIC[0]
+            || packet[1] != PACKET_MAGIC[1])
+            continue;
+        uint64_t acknowledged = readU32(packet + 2);
+        uint64_t start = readU32(packet + 6);
+        int count = std::min<int>(packet[10], size - PACKET_HEADER);
+        mPeerCount = std::max(mPeerCount, std::min(acknowledged, mTick));
+        for (int i = 0; i < count; i++) {
+            uint64_t tick = start + i;
+            if (tick != mRemoteCount) continue; // Already have it
+            if (tick >= mTick + ROLLBACK_WINDOW) break; // No room yet
+            uint8_t input = packet[PACKET_HEADER + i] & mRemoteMask;
+            int slot = tick % ROLLBACK_INPUT_RING;
+            if (tick < mTick && mPredicted[slot] != input) {
+                mStats.mispredictions++;
+                mRollbackFrom = std::min(mRollbackFrom, tick);
+            }
+            mRemoteInputs[slot] = input;
+            mRemoteCount++;
+        }
+    }
+}
+
+// Loads the snapshot before the first wrong guess and steps back up to now
+void RollbackSession::rollback() {
+    if (mRollbackFrom == NO_ROLLBACK) return;
+    uint64_t from = mRollbackFrom;
+    mRollbackFrom = NO_ROLLBACK;
+    int depth = static_cast<int>(mTick - from);
+    Clock::time_point start = Clock::now();
+    mSimulation.load(mSnapshots[from % ROLLBACK_WINDOW]);
+    mStats.loadSeconds += secondsSince(start);
+    start = Clock::now();
+    for (uint64_t tick = from; tick < mTick; tick++) simulate(tick);
+    mStats.resimulateSeconds += secondsSince(start);
+    mStats.rollbacks++;
+    mStats.resimulatedTicks += depth;
+    mStats.maxDepth = std::max(mStats.maxDepth, depth);
+}
+
+// Saves the state before tick, then steps it with the best inputs known
+void RollbackSession::simulate(uint64_t tick) {
+    Clock::time_point start = Clock::now();
+    mSimulation.save(mSnapshots[tick % ROLLBACK_WINDOW]);
+    mStats.saveSeconds += secondsSince(start);
+    uint8_t remote = remoteInput(tick);
+    mPredicted[tick % ROLLBACK_INPUT_RING] = remote;
+    mSimulation.step(mLocalInputs[tick % ROLLBACK_INPUT_RING] | remote);
+}
+
+// The peer's input for tick if it has arrived, otherwise its latest one
+uint8_t RollbackSession::remoteInput(uint64_t tick) const {
+    if (tick < mRemoteCount) return mRemoteInputs[tick % ROLLBACK_INPUT_RING];
+    if (mRemoteCount == 0) return 0;
+    return mRemoteInputs[(mRemoteCount - 1) % ROLLBACK_INPUT_RING];
+}
+
+void RollbackSession::sendInputs(double now) {
+    uint8_t packet[PACKET_HEADER + ROLLBACK_WINDOW];
+    int count = static_cast<int>(mTick - mPeerCount); // Under the window
+    packet[0] = PACKET_MAGIC[0];
+    packet[1] = PACKET_MAGIC[1];
+    writeU32(packet + 2, static_cast<uint32_t>(mRemoteCount));
+    writeU32(packet + 6, static_cast<uint32_t>(mPeerCount));
+    packet[10] = static_cast<uint8_t>(count);
+    for (int i = 0; i < count; i++)
+        packet[PACKET_HEADER + i] =
+            mLocalInputs[(mPeerCount + i) % ROLLBACK_INPUT_RING];
+    mTransport.send(packet, PACKET_HEADER + count, now);
+}
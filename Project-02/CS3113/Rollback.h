@@ -0,0 +1,67 @@
+// Rollback netcode for a two-player match between processes. Each peer steps
+// its Simulation straight away with its own input and a guess at the other
+// player's (their last known input), keeping a snapshot of the state before
+// every recent tick. When the real input arrives and differs from the guess,
+// the peer loads the snapshot from that tick and simulates forward again
+
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+#include "NetTransport.h"
+#include "Simulation.h"
+
+constexpr int ROLLBACK_WINDOW = 64; // Ticks that can be undone, 267 ms at 240
+constexpr int ROLLBACK_INPUT_RING = 2 * ROLLBACK_WINDOW; // Past and ahead
+
+struct RollbackStats {
+    uint64_t ticks = 0;            // Ticks simulated for the first time
+    uint64_t stalls = 0;           // advance() calls that waited on the peer
+    uint64_t mispredictions = 0;   // Remote inputs that differed from a guess
+    uint64_t rollbacks = 0;
+    uint64_t resimulatedTicks = 0;
+    int maxDepth = 0;              // Most ticks undone by one rollback
+    double saveSeconds = 0.0;      // Spent taking snapshots
+    double loadSeconds = 0.0;      // Spent restoring snapshots
+    double resimulateSeconds = 0.0; // Spent stepping ticks again
+};
+
+class RollbackSession {
+public:
+    RollbackSession(Simulation& simulation, NetTransport& transport,
+                    int localSide);
+
+    bool advance(uint8_t localInput, double now);
+    void poll(double now);
+
+    int getConfirmedScore(int side) const;
+
+    // Every tick so far was simulated with the peer's real input
+    bool isSynchronized() const { return mRemoteCount >= mTick; }
+
+    uint64_t getTick() const { return mTick; }
+
+    const RollbackStats& getStats() const { return mStats; }
+
+private:
+    void receive(double now);
+    void rollback();
+    void simulate(uint64_t tick);
+    void sendInputs(double now);
+    uint8_t remoteInput(uint64_t tick) const;
+
+    Simulation& mSimulation;
+    NetTransport& mTransport;
+    uint8_t mLocalMask;  // InputBits this peer's player controls
+    uint8_t mRemoteMask; // InputBits the other player controls
+    uint64_t mTick = 0;        // Next tick to simulate, counted from the start
+    uint64_t mRemoteCount = 0; // Peer inputs received, contiguous from tick 0
+    uint64_t mPeerCount = 0;   // Our inputs the peer has acknowledged
+    uint64_t mRollbackFrom;    // Earliest tick stepped with a wrong guess
+    uint8_t mLocalInputs[ROLLBACK_INPUT_RING];
+    uint8_t mRemoteInputs[ROLLBACK_INPUT_RING];
+    uint8_t mPredicted[ROLLBACK_INPUT_RING]; // Remote input each tick used
+    std::vector<SimSnapshot> mSnapshots; // State before each recent tick
+    RollbackStats mStats;
+};
+
+#endif // ROLLBACK_H
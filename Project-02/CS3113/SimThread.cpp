@@ -0,0 +1,196 @@
+#include "SimThread.h"
+#include <algorithm>
+#include <chrono>
+
+static constexpr uint64_t INPUT_TIME_MASK = (1ull << 40) - 1; // Microseconds
+
+void LatencyRing::add(float milliseconds) {
+    mSamples[mNext] = milliseconds;
+    mNext = (mNext + 1) % LATENCY_SAMPLES;
+    mCount = std::min(mCount + 1, LATENCY_SAMPLES);
+}
+
+/**
+ * @brief Nearest-rank percentile of the samples in the ring, like
+ * Profiler::getPercentile()
+ * @param percentile 0 to 100
+ * @return milliseconds, 0 if there are no samples
+ */
+float LatencyRing::getPercentile(float percentile) {
+    if (mCount == 0) return 0.0f;
+    std::copy(mSamples, mSamples + mCount, mScratch);
+    int rank = static_cast<int>(percentile / 100.0f * (mCount - 1) + 0.5f);
+    rank = std::max(0, std::min(mCount - 1, rank));
+    std::nth_element(mScratch, mScratch + rank, mScratch + mCount);
+    return mScratch[rank];
+}
+
+float LatencyRing::getMaximum() const {
+    float maximum = 0.0f;
+    for (int i = 0; i < mCount; i++) maximum = std::max(maximum, mSamples[i]);
+    return maximum;
+}
+
+// Current paddle and ball positions of a Simulation
+static void readPositions(const Simulation& simulation, Vec2 paddles[2],
+                          std::vector<Vec2>& balls) {
+    paddles[LEFT_PADDLE] = simulation.getPaddle(LEFT_PADDLE).position;
+    paddles[RIGHT_PADDLE] = simulation.getPaddle(RIGHT_PADDLE).position;
+    const BallPool& pool = simulation.getBalls();
+    balls.resize(pool.size());
+    for (int i = 0; i < pool.size(); i++)
+        balls[i] = {pool.getPositionsX()[i], pool.getPositionsY()[i]};
+}
+
+/**
+ * @brief Sizes every frame buffer for the biggest mode up front, so
+ * publishing never allocates
+ * @param simulation stepped only by this thread between start() and stop()
+ */
+SimThread::SimThread(Simulation& simulation) : mSimulation {simulation} {
+    for (int i = 0; i < 3; i++) {
+        FrameState& frame = mFrames.getBuffer(i);
+        frame.balls.reserve(BALL_POOL_CAPACITY);
+        frame.previousBalls.reserve(BALL_POOL_CAPACITY);
+    }
+}
+
+double SimThread::now() {
+    static const std::chrono::steady_clock::time_point EPOCH =
+        std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                         - EPOCH)
+        .count();
+}
+
+/**
+ * @brief Publishes the Simulation as it is, then starts ticking it. Starts
+ * paused, like the game
+ */
+void SimThread::start() {
+    if (mRunning.load()) return;
+    publish(false);
+    mRunning.store(true, std::memory_order_release);
+    mThread = std::thread(&SimThread::run, this);
+}
+
+void SimThread::stop() {
+    if (!mRunning.exchange(false)) return;
+    mThread.join();
+}
+
+/**
+ * @brief Sets the InputBits the next ticks use. Only a change counts as new
+ * input for the latency figures
+ * @param input
+ * @param now SimThread::now() when the input was sampled
+ */
+void SimThread::setInput(uint8_t input, double now) {
+    if (input == mLastInput && mInputSequence != 0) return;
+    mLastInput = input;
+    mInputSequence++;
+    uint64_t micros = static_cast<uint64_t>(now * 1e6) & INPUT_TIME_MASK;
+    mInput.store(static_cast<uint64_t>(mInputSequence) << 48
+                     | static_cast<uint64_t>(input) << 40 | micros,
+                 std::memory_order_release);
+}
+
+/**
+ * @brief Queues a command for the simulation thread to apply before its
+ * next tick, in order
+ * @return false if the ring is full
+ */
+bool SimThread::pushCommand(const ReplayEvent& event) {
+    uint32_t head = mCommandHead.load(std::memory_order_relaxed);
+    if (head - mCommandTail.load(std::memory_order_acquire) == COMMAND_SLOTS)
+        return false;
+    mCommands[head % COMMAND_SLOTS] = event;
+    mCommandHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+// Applies queued commands. Returns true if there were any
+bool SimThread::applyCommands() {
+    uint32_t tail = mCommandTail.load(std::memory_order_relaxed);
+    uint32_t head = mCommandHead.load(std::memory_order_acquire);
+    if (tail == head) return false;
+    for (; tail != head; tail++) {
+        const ReplayEvent& event = mCommands[tail % COMMAND_SLOTS];
+        applyReplayEvent(mSimulation, event);
+        // resetGame() pauses too; don't tick the fresh match before the
+        // main thread's setPaused() arrives
+        if (event.type == REPLAY_RESET) setPaused(true);
+    }
+    mCommandTail.store(tail, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Fills the write buffer with the Simulation's state and hands it to
+ * the render thread
+ * @param stepped false if nothing moved, so there's nothing to interpolate
+ */
+void SimThread::publish(bool stepped) {
+    FrameState& frame = mFrames.getWriteBuffer();
+    readPositions(mSimulation, frame.paddles, frame.balls);
+    if (!stepped) {
+        frame.previousPaddles[LEFT_PADDLE] = frame.paddles[LEFT_PADDLE];
+        frame.previousPaddles[RIGHT_PADDLE] = frame.paddles[RIGHT_PADDLE];
+        frame.previousBalls = frame.balls; // Capacity is reserved
+    }
+    frame.tick = mSimulation.getTick();
+    frame.time = now();
+    frame.deltaTime = mSimulation.getDeltaTime();
+    frame.scores[LEFT_PADDLE] = mSimulation.getLeftScore();
+    frame.scores[RIGHT_PADDLE] = mSimulation.getRightScore();
+    frame.ballCount = mSimulation.getBalls().size();
+    frame.inputSequence = mUsedSequence;
+    frame.inputTime = mUsedInputTime;
+    frame.commands = mCommandTail.load(std::memory_order_relaxed);
+    mFrames.publish();
+}
+
+/**
+ * @brief The simulation thread: ticks on a fixed schedule, sleeping until
+ * each tick is due, and drops the backlog once it's MAX_TICK_BACKLOG, like
+ * update() on the main thread
+ */
+void SimThread::run() {
+    const double tickTime = mSimulation.getDeltaTime();
+    double next = now();
+    while (mRunning.load(std::memory_order_acquire)) {
+        if (applyCommands()) publish(false);
+        if (mPaused.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(
+                std::chrono::duration<double>(tickTime));
+            next = now(); // Start a fresh schedule on unpause
+            continue;
+        }
+        double start = now();
+        if (start < next) {
+            std::this_thread::sleep_for(
+                std::chrono::duration<double>(next - start));
+            start = now();
+        }
+        double lateness = start - next;
+        if (lateness > MAX_TICK_BACKLOG) {
+            mDroppedTicks += static_cast<uint64_t>(lateness / tickTime);
+            next = start;
+        }
+        mTickLateness.add(static_cast<float>(lateness * 1000.0));
+
+        uint64_t input = mInput.load(std::memory_order_acquire);
+        uint16_t sequence = static_cast<uint16_t>(input >> 48);
+        if (sequence != mUsedSequence) { // New input since the last tick
+            mUsedSequence = sequence;
+            mUsedInputTime = (input & INPUT_TIME_MASK) / 1e6;
+            mInputLatency.add(
+                static_cast<float>((start - mUsedInputTime) * 1000.0));
+        }
+        FrameState& frame = mFrames.getWriteBuffer();
+        readPositions(mSimulation, frame.previousPaddles, frame.previousBalls);
+        mSimulation.step(static_cast<uint8_t>(input >> 40));
+        publish(true);
+        next += tickTime;
+    }
+}
@@ -0,0 +1,120 @@
+// Runs a Simulation on its own thread at its fixed tick rate, so a slow
+// frame can't hold up physics or input. Every tick is published as a
+// FrameState through a TripleBuffer; the render thread takes the newest one
+// without blocking. Input, commands and pausing go the other way through
+// atomics and a fixed ring, so neither thread takes a lock. Raylib-free
+
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "Replay.h"
+#include "Simulation.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+// What the render thread needs from one tick: the positions before and
+// after it, for interpolation, and the input it used, for latency
+struct FrameState {
+    uint64_t tick = 0;
+    double time = 0.0; // SimThread::now() when the tick finished
+    float deltaTime = 0.0f;
+    Vec2 paddles[2] = {{0.0f, 0.0f}, {0.0f, 0.0f}};
+    Vec2 previousPaddles[2] = {{0.0f, 0.0f}, {0.0f, 0.0f}};
+    int scores[2] = {0, 0};
+    int ballCount = 0;
+    std::vector<Vec2> balls;         // ballCount positions after the tick
+    std::vector<Vec2> previousBalls; // And before it
+    uint16_t inputSequence = 0; // Newest input change a tick has used
+    double inputTime = 0.0;     // When that input was sampled
+    uint32_t commands = 0;      // Commands applied so far
+};
+
+// Last LATENCY_SAMPLES millisecond samples, for percentiles
+class LatencyRing {
+public:
+    static constexpr int LATENCY_SAMPLES = 4096;
+
+    void add(float milliseconds);
+    float getPercentile(float percentile);
+    float getMaximum() const;
+
+    int getCount() const { return mCount; }
+
+private:
+    float mSamples[LATENCY_SAMPLES];
+    float mScratch[LATENCY_SAMPLES]; // Partially sorted for percentiles
+    int mNext = 0;
+    int mCount = 0;
+};
+
+class SimThread {
+public:
+    static constexpr int COMMAND_SLOTS = 64;
+    explicit SimThread(Simulation& simulation);
+    ~SimThread() { stop(); }
+
+    void start();
+    void stop();
+
+    // Main thread only
+    void setInput(uint8_t input, double now);
+    bool pushCommand(const ReplayEvent& event);
+
+    // Commands pushed so far; a frame with this many applied reflects them
+    uint32_t getCommandsPushed() const {
+        return mCommandHead.load(std::memory_order_relaxed);
+    }
+
+    void setPaused(bool paused) {
+        mPaused.store(paused, std::memory_order_relaxed);
+    }
+
+    // Render thread only: the newest frame, and the same one again until
+    // the next fetch
+    bool fetchFrame() { return mFrames.fetch(); }
+
+    const FrameState& getFrame() const { return mFrames.getReadBuffer(); }
+
+    // Safe once stop() has returned
+    LatencyRing& getTickLateness() { return mTickLateness; }
+
+    LatencyRing& getInputLatency() { return mInputLatency; }
+
+    uint64_t getDroppedTicks() const { return mDroppedTicks; }
+
+    // Seconds on the clock FrameState and setInput() times use
+    static double now();
+
+private:
+    void run();
+    bool applyCommands();
+    void publish(bool stepped);
+
+    Simulation& mSimulation;
+    std::thread mThread;
+    std::atomic<bool> mRunning {false};
+    std::atomic<bool> mPaused {true};
+    TripleBuffer<FrameState> mFrames;
+
+    // Input: sequence << 48 | bits << 40 | sample time in microseconds
+    std::atomic<uint64_t> mInput {0};
+    uint8_t mLastInput = 0;      // Main thread's last setInput() bits
+    uint16_t mInputSequence = 0; // Main thread's count of input changes
+
+    // Single producer, single consumer ring of commands
+    ReplayEvent mCommands[COMMAND_SLOTS];
+    std::atomic<uint32_t> mCommandHead {0}; // Next slot to write
+    std::atomic<uint32_t> mCommandTail {0}; // Next slot to read
+
+    // Simulation thread only
+    uint16_t mUsedSequence = 0;
+    double mUsedInputTime = 0.0;
+    LatencyRing mTickLateness; // Tick start past its schedule (ms)
+    LatencyRing mInputLatency; // Input sampled to tick using it (ms)
+    uint64_t mDroppedTicks = 0;
+};
+
+#endif // SIM_THREAD_H
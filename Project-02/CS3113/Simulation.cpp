@@ -0,0 +1,150 @@
+#include "Simulation.h"
+#include "Profiler.h"
+
+Simulation::Simulation(uint32_t seed, float tickRate) :
+    mDeltaTime {1.0f / tickRate}, mRng {seed} {
+    // Allocate for the biggest mode now, so switching modes never allocates
+    mBalls.reserve(BALL_POOL_CAPACITY);
+    mBallGrid.reserve(BALL_POOL_CAPACITY);
+    for (Interceptor& interceptor : mInterceptors)
+        interceptor.reserve(BALL_POOL_CAPACITY);
+    resetMatch();
+    setBallCount(1);
+}
+
+/**
+ * @brief Zeroes the scores and puts both paddles back at the middle of their
+ * edge of the screen. Balls are left alone
+ */
+void Simulation::resetMatch() {
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+        mPaddles[side] = makePaddle(side);
+        mScores[side] = 0;
+    }
+}
+
+/**
+ * @brief Sets the number of balls and resets all of them, like setBallCount()
+ * in main.cpp
+ * @param count
+ */
+void Simulation::setBallCount(int count) {
+    mBalls.resize(count);
+    // Slow down balls for 67 mode and anything bigger
+    mBalls.setBaseSpeed(count >= 67 ? BALL_SLOW_SPEED : BALL_FAST_SPEED);
+    mBalls.resetAll(mRng);
+    planIntercepts();
+}
+
+/**
+ * @brief Hands a paddle to the AI or back to input. The AI predicts every
+ * ball when it takes over, then follows them as they turn
+ * @param side
+ * @param enabled
+ */
+void Simulation::setAI(int side, bool enabled) {
+    mAI[side] = enabled;
+    if (enabled) mInterceptors[side].rebuild(mBalls, mPaddles[side], getTime());
+}
+
+/**
+ * @brief Advances the game by one fixed tick, in the same order as update()
+ * in main.cpp: AI, balls, then paddles
+ * @param input InputBits held this tick, ignored for AI controlled paddles
+ */
+void Simulation::step(uint8_t input) {
+    if (input & INPUT_LEFT_UP) mPaddles[LEFT_PADDLE].movement.y = -1.0f;
+    if (input & INPUT_LEFT_DOWN) mPaddles[LEFT_PADDLE].movement.y = 1.0f;
+    if (input & INPUT_RIGHT_UP) mPaddles[RIGHT_PADDLE].movement.y = -1.0f;
+    if (input & INPUT_RIGHT_DOWN) mPaddles[RIGHT_PADDLE].movement.y = 1.0f;
+    {
+        ProfileScope scope(PHASE_AI);
+        if (mAI[LEFT_PADDLE]) runAI(LEFT_PADDLE);
+        if (mAI[RIGHT_PADDLE]) runAI(RIGHT_PADDLE);
+    }
+    {
+        ProfileScope scope(PHASE_BALLS);
+        int pointsBefore = mScores[LEFT_PADDLE] + mScores[RIGHT_PADDLE];
+        mBalls.update(mDeltaTime, mPaddles, mScores[LEFT_PADDLE],
+                      mScores[RIGHT_PADDLE], mRng, mWorkers);
+        mRallies +=
+            mScores[LEFT_PADDLE] + mScores[RIGHT_PADDLE] - pointsBefore;
+        if (mBallCollisions) mBallGrid.collide(mBalls);
+    }
+    {
+        ProfileScope scope(PHASE_PADDLES);
+        stepPaddle(mPaddles[LEFT_PADDLE], mDeltaTime);
+        stepPaddle(mPaddles[RIGHT_PADDLE], mDeltaTime);
+    }
+    mTick++;
+    {
+        ProfileScope scope(PHASE_AI);
+        planIntercepts();
+    }
+}
+
+/**
+ * @brief Copies the whole game state into snapshot, for rolling back to later
+ * @param snapshot
+ */
+void Simulation::save(SimSnapshot& snapshot) const {
+    snapshot.rng = mRng;
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+        snapshot.paddles[side] = mPaddles[side];
+        snapshot.scores[side] = mScores[side];
+        snapshot.ai[side] = mAI[side];
+        if (mAI[side]) snapshot.intercepts[side] = mInterceptors[side];
+    }
+    snapshot.ballCollisions = mBallCollisions;
+    snapshot.tick = mTick;
+    snapshot.rallies = mRallies;
+    snapshot.baseSpeed = mBalls.getBaseSpeed();
+    snapshot.ballCount = mBalls.size();
+    snapshot.balls.resize(mBalls.stateSize());
+    mBalls.saveState(snapshot.balls.data());
+}
+
+/**
+ * @brief Puts the game back exactly as it was when snapshot was saved
+ * @param snapshot
+ */
+void Simulation::load(const SimSnapshot& snapshot) {
+    mRng = snapshot.rng;
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+        mPaddles[side] = snapshot.paddles[side];
+        mScores[side] = snapshot.scores[side];
+        mAI[side] = snapshot.ai[side];
+    }
+    mBallCollisions = snapshot.ballCollisions;
+    mTick = snapshot.tick;
+    mRallies = snapshot.rallies;
+    mBalls.setBaseSpeed(snapshot.baseSpeed);
+    mBalls.loadState(snapshot.balls.data(), snapshot.ballCount);
+    // The saved predictions, not new ones from these positions, so a rollback
+    // steers exactly as the first run did
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++)
+        if (mAI[side]) mInterceptors[side] = snapshot.intercepts[side];
+    mBalls.clearTurned();
+}
+
+/**
+ * @brief Moves a paddle to meet the next ball it can reach, or back to the
+ * middle if none is coming
+ * @param side
+ */
+void Simulation::runAI(int side) {
+    PaddleState& paddle = mPaddles[side];
+    Intercept next;
+    float targetY = SCREEN_HEIGHT / 2.0f;
+    if (mInterceptors[side].next(mBalls, paddle, getTime(), next))
+        targetY = aimAt(paddle, next.y, next.dirY);
+    steerPaddle(paddle, targetY, mDeltaTime);
+}
+
+// Brings the AI's predictions up to date with the balls that turned
+void Simulation::planIntercepts() {
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++)
+        if (mAI[side])
+            mInterceptors[side].update(mBalls, mPaddles[side], getTime());
+    mBalls.clearTurned();
+}
@@ -0,0 +1,94 @@
+// Headless game state: paddles, balls and scores stepped on a fixed dt with
+// no window, textures or global RNG. Used by the benchmarks in bench/
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "BallGrid.h"
+#include "BallPool.h"
+#include "Interceptor.h"
+#include "Physics.h"
+
+// Per-tick paddle input, one bit per key
+enum InputBits : uint8_t {
+    INPUT_LEFT_UP = 1 << 0,
+    INPUT_LEFT_DOWN = 1 << 1,
+    INPUT_RIGHT_UP = 1 << 2,
+    INPUT_RIGHT_DOWN = 1 << 3,
+};
+
+// Everything step() reads or changes. The fields are plain data copied by
+// assignment and the balls are raw bytes from BallPool::saveState(), so saving
+// into a snapshot that has held as many balls before doesn't allocate
+struct SimSnapshot {
+    Rng rng;
+    PaddleState paddles[2];
+    int scores[2];
+    bool ai[2];
+    bool ballCollisions;
+    uint64_t tick;
+    uint64_t rallies;
+    float baseSpeed;
+    int ballCount;
+    std::vector<uint8_t> balls;
+    Interceptor intercepts[2]; // Only saved for AI controlled paddles
+};
+
+class Simulation {
+public:
+    explicit Simulation(uint32_t seed = 67, float tickRate = FPS);
+
+    void setBallCount(int count);
+    void resetMatch();
+    void setAI(int side, bool enabled);
+
+    void setBallCollisions(bool enabled) { mBallCollisions = enabled; }
+
+    // Splits the ball update across workers; nullptr runs it on this thread
+    void setWorkerPool(WorkerPool* workers) { mWorkers = workers; }
+    void step(uint8_t input = 0);
+
+    void save(SimSnapshot& snapshot) const;
+    void load(const SimSnapshot& snapshot);
+
+    float getDeltaTime() const { return mDeltaTime; }
+
+    const PaddleState& getPaddle(int side) const { return mPaddles[side]; }
+
+    const BallPool& getBalls() const { return mBalls; }
+
+    int getLeftScore() const { return mScores[LEFT_PADDLE]; }
+
+    int getRightScore() const { return mScores[RIGHT_PADDLE]; }
+
+    uint64_t getTick() const { return mTick; }
+
+    uint64_t getRallies() const { return mRallies; }
+
+    // Seconds of game time at the current tick
+    double getTime() const { return mTick * static_cast<double>(mDeltaTime); }
+
+    const Interceptor& getInterceptor(int side) const {
+        return mInterceptors[side];
+    }
+
+private:
+    void runAI(int side);
+    void planIntercepts();
+
+    float mDeltaTime;
+    Rng mRng;
+    PaddleState mPaddles[2];
+    BallPool mBalls;
+    BallGrid mBallGrid;
+    bool mBallCollisions = false;
+    WorkerPool* mWorkers = nullptr; // Not owned
+    int mScores[2] = {0, 0};
+    bool mAI[2] = {false, false};
+    Interceptor mInterceptors[2] = {Interceptor(LEFT_PADDLE),
+                                    Interceptor(RIGHT_PADDLE)};
+    uint64_t mTick = 0;
+    uint64_t mRallies = 0; // Points played to completion
+};
+
+#endif // SIMULATION_H
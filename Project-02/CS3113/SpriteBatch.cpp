@@ -0,0 +1,128 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+// Quads per rlBegin(), kept well under rlgl's default 8192 quad batch
+constexpr int QUADS_PER_BEGIN = 1024;
+
+/**
+ * @brief Allocates room for a frame of sprites up front, so the first frame
+ * with that many doesn't grow the queue
+ * @param sprites
+ */
+void SpriteBatch::reserve(int sprites) {
+    mSprites.reserve(sprites);
+    mOrder.reserve(sprites);
+}
+
+void SpriteBatch::begin() {
+    mSprites.clear();
+}
+
+/**
+ * @brief Queues a sprite, with the same arguments as DrawTexturePro()
+ */
+void SpriteBatch::draw(const Texture2D& texture, Rectangle source,
+                       Rectangle destination, Vector2 origin, float rotation,
+                       Color tint) {
+    if (texture.id == 0) return;
+    mSprites.push_back({texture, source, destination, origin, rotation, tint});
+}
+
+/**
+ * @brief Submits the queued sprites, one texture group at a time. Sprites
+ * sharing a texture keep their queued order
+ */
+void SpriteBatch::end() {
+    int count = static_cast<int>(mSprites.size());
+    mOrder.resize(count);
+    for (int i = 0; i < count; i++) mOrder[i] = i;
+    const std::vector<Sprite>& sprites = mSprites;
+    std::stable_sort(mOrder.begin(), mOrder.end(), [&sprites](int a, int b) {
+        return sprites[a].texture.id < sprites[b].texture.id;
+    });
+
+    mSpriteCount = count;
+    mTextureBinds = 0;
+    int i = 0;
+    while (i < count) {
+        unsigned int textureId = mSprites[mOrder[i]].texture.id;
+        rlSetTexture(textureId);
+        mTextureBinds++;
+        // Every sprite with this texture, in chunks of QUADS_PER_BEGIN
+        while (i < count && mSprites[mOrder[i]].texture.id == textureId) {
+            int chunk = 0;
+            while (i + chunk < count && chunk < QUADS_PER_BEGIN
+                   && mSprites[mOrder[i + chunk]].texture.id == textureId)
+                chunk++;
+            rlCheckRenderBatchLimit(4 * chunk);
+            rlBegin(RL_QUADS);
+            rlNormal3f(0.0f, 0.0f, 1.0f);
+            for (int j = 0; j < chunk; j++) submit(mSprites[mOrder[i + j]]);
+            rlEnd();
+            i += chunk;
+        }
+    }
+    rlSetTexture(0);
+}
+
+/**
+ * @brief Emits one quad the same way DrawTexturePro() does, including
+ * flipping on negative source sizes and rotating about origin
+ */
+void SpriteBatch::submit(const Sprite& sprite) const {
+    float width = static_cast<float>(sprite.texture.width);
+    float height = static_cast<float>(sprite.texture.height);
+    Rectangle source = sprite.source;
+    Rectangle dest = sprite.destination;
+    bool flipX = false;
+    // Negative source width/height flip the sprite
+    if (source.width < 0) {
+        flipX = true;
+        source.width *= -1;
+    }
+    if (source.height < 0) source.y -= source.height;
+
+    Vector2 topLeft, topRight, bottomLeft, bottomRight;
+    if (sprite.rotation == 0.0f) { // Skip the trig for unrotated sprites
+        float x = dest.x - sprite.origin.x;
+        float y = dest.y - sprite.origin.y;
+        topLeft = {x, y};
+        topRight = {x + dest.width, y};
+        bottomLeft = {x, y + dest.height};
+        bottomRight = {x + dest.width, y + dest.height};
+    } else { // Rotate corners about origin
+        float sinRotation = sinf(sprite.rotation * DEG2RAD);
+        float cosRotation = cosf(sprite.rotation * DEG2RAD);
+        float x = dest.x;
+        float y = dest.y;
+        float dx = -sprite.origin.x;
+        float dy = -sprite.origin.y;
+        topLeft = {x + dx * cosRotation - dy * sinRotation,
+                   y + dx * sinRotation + dy * cosRotation};
+        topRight = {x + (dx + dest.width) * cosRotation - dy * sinRotation,
+                    y + (dx + dest.width) * sinRotation + dy * cosRotation};
+        bottomLeft = {x + dx * cosRotation - (dy + dest.height) * sinRotation,
+                      y + dx * sinRotation + (dy + dest.height) * cosRotation};
+        bottomRight = {
+            x + (dx + dest.width) * cosRotation
+                - (dy + dest.height) * sinRotation,
+            y + (dx + dest.width) * sinRotation
+                + (dy + dest.height) * cosRotation};
+    }
+    // UV coordinates of the source rectangle's edges
+    float left = source.x / width;
+    float right = (source.x + source.width) / width;
+    float top = source.y / height;
+    float bottom = (source.y + source.height) / height;
+    if (flipX) std::swap(left, right);
+
+    rlColor4ub(sprite.tint.r, sprite.tint.g, sprite.tint.b, sprite.tint.a);
+    rlTexCoord2f(left, top);
+    rlVertex2f(topLeft.x, topLeft.y);
+    rlTexCoord2f(left, bottom);
+    rlVertex2f(bottomLeft.x, bottomLeft.y);
+    rlTexCoord2f(right, bottom);
+    rlVertex2f(bottomRight.x, bottomRight.y);
+    rlTexCoord2f(right, top);
+    rlVertex2f(topRight.x, topRight.y);
+}
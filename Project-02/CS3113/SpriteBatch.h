@@ -0,0 +1,40 @@
+// Collects a frame's sprites and submits them to rlgl grouped by texture, so
+// each texture is bound once per frame instead of once per DrawTexturePro()
+
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "cs3113.h"
+
+class SpriteBatch {
+public:
+    void reserve(int sprites);
+    void begin();
+    void draw(const Texture2D& texture, Rectangle source,
+              Rectangle destination, Vector2 origin, float rotation,
+              Color tint);
+    void end();
+
+    int getSpriteCount() const { return mSpriteCount; }
+
+    int getTextureBinds() const { return mTextureBinds; }
+
+private:
+    struct Sprite {
+        Texture2D texture;
+        Rectangle source;
+        Rectangle destination;
+        Vector2 origin;
+        float rotation;
+        Color tint;
+    };
+
+    void submit(const Sprite& sprite) const;
+
+    std::vector<Sprite> mSprites; // Capacity kept between frames
+    std::vector<int> mOrder;      // mSprites indices sorted by texture
+    int mSpriteCount = 0;         // Sprites submitted by the last end()
+    int mTextureBinds = 0;        // Texture groups submitted by the last end()
+};
+
+#endif // SPRITE_BATCH_H
@@ -0,0 +1,223 @@
+#include "SweepKernel.h"
+#include "Telemetry.h"
+
+// Every lane follows the exact operation order of sweepCollision(), and the
+// select() based min/max/swap mirror std::min/std::max/std::swap even for NaN
+// and infinite slab times, so results match the scalar path bit for bit.
+// Don't build with -mfma or -ffast-math: contracting only one of the two
+// paths into fused multiply-adds would break that
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SWEEP_LANES 8
+typedef __m256 Lanes;
+
+static inline Lanes load(const float* p) { return _mm256_loadu_ps(p); }
+
+static inline void store(float* p, Lanes v) { _mm256_storeu_ps(p, v); }
+
+static inline Lanes broadcast(float v) { return _mm256_set1_ps(v); }
+
+static inline Lanes sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+
+static inline Lanes mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+
+static inline Lanes div(Lanes a, Lanes b) { return _mm256_div_ps(a, b); }
+
+static inline Lanes magnitude(Lanes a) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); // Clear the sign bit
+}
+
+static inline Lanes both(Lanes a, Lanes b) { return _mm256_and_ps(a, b); }
+
+static inline Lanes either(Lanes a, Lanes b) { return _mm256_or_ps(a, b); }
+
+static inline Lanes less(Lanes a, Lanes b) {
+    return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+}
+
+static inline Lanes greater(Lanes a, Lanes b) {
+    return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+}
+
+static inline Lanes select(Lanes mask, Lanes a, Lanes b) {
+    return _mm256_blendv_ps(b, a, mask);
+}
+
+static inline int laneBits(Lanes mask) { return _mm256_movemask_ps(mask); }
+
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SWEEP_LANES 4
+typedef __m128 Lanes;
+
+static inline Lanes load(const float* p) { return _mm_loadu_ps(p); }
+
+static inline void store(float* p, Lanes v) { _mm_storeu_ps(p, v); }
+
+static inline Lanes broadcast(float v) { return _mm_set1_ps(v); }
+
+static inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+
+static inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+
+static inline Lanes div(Lanes a, Lanes b) { return _mm_div_ps(a, b); }
+
+static inline Lanes magnitude(Lanes a) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); // Clear the sign bit
+}
+
+static inline Lanes both(Lanes a, Lanes b) { return _mm_and_ps(a, b); }
+
+static inline Lanes either(Lanes a, Lanes b) { return _mm_or_ps(a, b); }
+
+static inline Lanes less(Lanes a, Lanes b) { return _mm_cmplt_ps(a, b); }
+
+static inline Lanes greater(Lanes a, Lanes b) { return _mm_cmpgt_ps(a, b); }
+
+static inline Lanes select(Lanes mask, Lanes a, Lanes b) {
+    // No blendv before SSE4.1
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline int laneBits(Lanes mask) { return _mm_movemask_ps(mask); }
+
+#else
+#define SWEEP_LANES 1
+#endif
+
+int sweepLanes() {
+    return SWEEP_LANES;
+}
+
+#if SWEEP_LANES > 1
+// Lanes set in a mask, for the telemetry counters
+static inline uint64_t countLanes(Lanes mask) {
+    uint64_t count = 0;
+    for (int bits = laneBits(mask); bits; bits &= bits - 1) count++;
+    return count;
+}
+#endif
+
+/**
+ * @brief Scalar fallback for one ball, used for the tail of a batch and on
+ * targets without SSE2
+ */
+static void sweepOne(const float* posX, const float* posY, const float* moveX,
+                     const float* moveY, const float* speed, float radius,
+                     int i, const PaddleState& paddle, float deltaTime,
+                     float* outTime, float* outNormalX, float* outNormalY) {
+    BallState ball;
+    ball.position = {posX[i], posY[i]};
+    ball.movement = {moveX[i], moveY[i]};
+    ball.speed = speed[i];
+    ball.radius = radius;
+    Vec2 normal = {0.0f, 0.0f};
+    outTime[i] = sweepCollision(ball, paddle, normal, deltaTime);
+    outNormalX[i] = normal.x;
+    outNormalY[i] = normal.y;
+}
+
+/**
+ * @brief Runs the sweepCollision() slab test for count balls against one
+ * paddle. Misses get a time of -1 and a zero normal
+ * @param posX, posY, moveX, moveY, speed BallPool arrays
+ * @param radius shared ball radius
+ * @param count
+ * @param paddle
+ * @param deltaTime
+ * @param outTime time of impact per ball, or -1
+ * @param outNormalX, outNormalY contact normal per ball
+ */
+void sweepBatch(const float* posX, const float* posY, const float* moveX,
+                const float* moveY, const float* speed, float radius,
+                int count, const PaddleState& paddle, float deltaTime,
+                float* outTime, float* outNormalX, float* outNormalY) {
+    int i = 0;
+#if SWEEP_LANES > 1
+    // Paddle bounds and velocity are the same for every ball
+    Vec2 paddlePos = paddle.position;
+    Vec2 paddleCol = paddle.colliderDimensions;
+    const Lanes rectLeft =
+        broadcast(paddlePos.x - paddleCol.x / 2.0f - radius);
+    const Lanes rectRight =
+        broadcast(paddlePos.x + paddleCol.x / 2.0f + radius);
+    const Lanes rectTop = broadcast(paddlePos.y - paddleCol.y / 2.0f - radius);
+    const Lanes rectBottom =
+        broadcast(paddlePos.y + paddleCol.y / 2.0f + radius);
+    const Lanes paddleVelX =
+        broadcast(paddle.movement.x * paddle.speed * deltaTime);
+    const Lanes paddleVelY =
+        broadcast(paddle.movement.y * paddle.speed * deltaTime);
+    const Lanes dt = broadcast(deltaTime);
+    const Lanes epsilon = broadcast(PHYSICS_EPSILON);
+    const Lanes zero = broadcast(0.0f);
+    const Lanes one = broadcast(1.0f);
+    const Lanes minusOne = broadcast(-1.0f);
+    // Counted per batch rather than per lane, so the loop stays branch free
+    // while telemetry is off
+    const bool counting = PHYSICS_TELEMETRY && Telemetry::isEnabled();
+    uint64_t stillEarlyOuts = 0, clampedEntries = 0;
+
+    for (; i + SWEEP_LANES <= count; i += SWEEP_LANES) {
+        Lanes px = load(posX + i), py = load(posY + i);
+        Lanes ballSpeed = load(speed + i);
+        // Relative velocity of the balls with respect to the paddle
+        Lanes relVelX =
+            sub(mul(mul(load(moveX + i), ballSpeed), dt), paddleVelX);
+        Lanes relVelY =
+            sub(mul(mul(load(moveY + i), ballSpeed), dt), paddleVelY);
+        // Near 0 velocity early outs, as lane masks
+        Lanes stillX = less(magnitude(relVelX), epsilon);
+        Lanes stillY = less(magnitude(relVelY), epsilon);
+        Lanes miss = both(stillX, stillY);
+        miss = either(miss, both(stillX, either(less(px, rectLeft),
+                                                greater(px, rectRight))));
+        miss = either(miss, both(stillY, either(less(py, rectTop),
+                                                greater(py, rectBottom))));
+        if (counting) stillEarlyOuts += countLanes(miss);
+        // Horizontal and vertical entry and exit times, swapped if reversed
+        Lanes entryX = div(sub(rectLeft, px), relVelX);
+        Lanes exitX = div(sub(rectRight, px), relVelX);
+        Lanes swapX = greater(entryX, exitX);
+        Lanes tEntryX = select(swapX, exitX, entryX);
+        Lanes tExitX = select(swapX, entryX, exitX);
+        Lanes entryY = div(sub(rectTop, py), relVelY);
+        Lanes exitY = div(sub(rectBottom, py), relVelY);
+        Lanes swapY = greater(entryY, exitY);
+        Lanes tEntryY = select(swapY, exitY, entryY);
+        Lanes tExitY = select(swapY, entryY, exitY);
+        // std::max(tEntryX, tEntryY) and std::min(tExitX, tExitY)
+        Lanes tEntry = select(less(tEntryX, tEntryY), tEntryY, tEntryX);
+        Lanes tExit = select(less(tExitY, tExitX), tExitY, tExitX);
+        // No collision, collision in the past or in the future
+        miss = either(miss, greater(tEntry, tExit));
+        miss = either(miss, less(tExit, zero));
+        miss = either(miss, greater(tEntry, one));
+        // Normal from whichever axis was hit first
+        Lanes hitY = greater(tEntryY, tEntryX);
+        Lanes normalX =
+            select(hitY, zero, select(greater(relVelX, zero), minusOne, one));
+        Lanes normalY =
+            select(hitY, select(greater(relVelY, zero), minusOne, one), zero);
+        // Clamp to 0 if collision at start of frame
+        Lanes started = both(less(tEntry, zero), greater(tExit, zero));
+        tEntry = select(started, zero, tEntry);
+        if (counting) // Clamped sweeps that weren't a miss
+            clampedEntries +=
+                countLanes(started) - countLanes(both(started, miss));
+
+        store(outTime + i, select(miss, minusOne, tEntry));
+        store(outNormalX + i, select(miss, zero, normalX));
+        store(outNormalY + i, select(miss, zero, normalY));
+    }
+    if (counting) {
+        Telemetry::add(TM_STILL_EARLY_OUT, stillEarlyOuts);
+        Telemetry::add(TM_CLAMPED_ENTRY, clampedEntries);
+    }
+#endif
+    for (; i < count; i++) {
+        sweepOne(posX, posY, moveX, moveY, speed, radius, i, paddle, deltaTime,
+                 outTime, outNormalX, outNormalY);
+    }
+}
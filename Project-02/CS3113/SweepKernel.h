@@ -0,0 +1,17 @@
+// Batched slab test: sweepCollision() for a run of BallPool balls against one
+// paddle, 8 balls at a time with AVX2, 4 with SSE2, or one at a time otherwise
+
+#ifndef SWEEP_KERNEL_H
+#define SWEEP_KERNEL_H
+
+#include "Physics.h"
+
+// Balls handled per SIMD instruction by sweepBatch() in this build
+int sweepLanes();
+
+void sweepBatch(const float* posX, const float* posY, const float* moveX,
+                const float* moveY, const float* speed, float radius,
+                int count, const PaddleState& paddle, float deltaTime,
+                float* outTime, float* outNormalX, float* outNormalY);
+
+#endif // SWEEP_KERNEL_H
@@ -0,0 +1,101 @@
+#include "Telemetry.h"
+#include <stdio.h>
+#include <string>
+
+std::atomic<bool> Telemetry::sEnabled {false};
+std::atomic<uint64_t> Telemetry::sTotals[TM_COUNT];
+
+static uint64_t sFrameStart[TM_COUNT]; // Totals when the frame began
+static uint64_t sFrame[TM_COUNT];      // Counts in the last finished frame
+
+// Metric family, help text and label of each counter, for the exposition
+struct CounterInfo {
+    const char* metric;
+    const char* help;
+    const char* label; // Empty for an unlabelled metric
+};
+
+static const CounterInfo COUNTER_INFO[TM_COUNT] = {
+    {"pong_ccd_swept_hits", "Swept paddle hits resolved", "paddle=\"left\""},
+    {"pong_ccd_swept_hits", "Swept paddle hits resolved", "paddle=\"right\""},
+    {"pong_ccd_clamped_entries", "Sweeps starting inside, tEntry clamped to 0",
+     ""},
+    {"pong_ccd_depenetrations", "Overlaps corrected after a hit",
+     "case=\"inside\""},
+    {"pong_ccd_depenetrations", "Overlaps corrected after a hit",
+     "case=\"overlap\""},
+    {"pong_ccd_still_early_outs",
+     "Sweeps skipped for near zero relative velocity", ""},
+    {"pong_ccd_extra_contacts", "Hits and bounces after the first in a step",
+     ""},
+    {"pong_ccd_contact_caps", "Steps that ran out of contacts", ""}};
+
+void Telemetry::setEnabled(bool enabled) {
+    sEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Closes the current frame: what each counter gained since the last
+ * call becomes the per-frame value
+ */
+void Telemetry::endFrame() {
+    for (int counter = 0; counter < TM_COUNT; counter++) {
+        uint64_t total = sTotals[counter].load(std::memory_order_relaxed);
+        sFrame[counter] = total - sFrameStart[counter];
+        sFrameStart[counter] = total;
+    }
+}
+
+uint64_t Telemetry::getTotal(TelemetryCounter counter) {
+    return sTotals[counter].load(std::memory_order_relaxed);
+}
+
+uint64_t Telemetry::getFrame(TelemetryCounter counter) {
+    return sFrame[counter];
+}
+
+void Telemetry::reset() {
+    for (int counter = 0; counter < TM_COUNT; counter++) {
+        sTotals[counter].store(0, std::memory_order_relaxed);
+        sFrameStart[counter] = 0;
+        sFrame[counter] = 0;
+    }
+}
+
+/**
+ * @brief Writes every counter in Prometheus text exposition format, as a
+ * cumulative _total counter and a last frame gauge. Writes a temporary file
+ * and renames it over filepath, so a scraper never reads half a file
+ * @param filepath
+ * @return false if the file couldn't be written
+ */
+bool Telemetry::writePrometheus(const char* filepath) {
+    std::string temporary = std::string(filepath) + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "w");
+    if (!file) return false;
+    for (int pass = 0; pass < 2; pass++) { // Totals, then last frame
+        const char* suffix = pass == 0 ? "_total" : "_last_frame";
+        for (int counter = 0; counter < TM_COUNT; counter++) {
+            const CounterInfo& info = COUNTER_INFO[counter];
+            // Labelled series of one metric are adjacent; write HELP and
+            // TYPE once, before the first of them
+            if (counter == 0
+                || std::string(info.metric) != COUNTER_INFO[counter - 1].metric)
+                fprintf(file, "# HELP %s%s %s%s\n# TYPE %s%s %s\n",
+                        info.metric, suffix, info.help,
+                        pass == 0 ? "" : ", last frame", info.metric, suffix,
+                        pass == 0 ? "counter" : "gauge");
+            uint64_t value =
+                pass == 0 ? getTotal(static_cast<TelemetryCounter>(counter)) :
+                            sFrame[counter];
+            fprintf(file, "%s%s%s%s%s %llu\n", info.metric, suffix,
+                    info.label[0] ? "{" : "", info.label,
+                    info.label[0] ? "}" : "", (unsigned long long)value);
+        }
+    }
+    bool written = fclose(file) == 0;
+#ifdef _WIN32
+    remove(filepath); // rename() won't replace an existing file on Windows
+#endif
+    return written && rename(temporary.c_str(), filepath) == 0;
+}
@@ -0,0 +1,64 @@
+// Cumulative and per-frame counters for the collision code's outcomes,
+// exported as a Prometheus text file. Raylib-free like the Profiler. Off
+// unless enabled at runtime, and compiled out with -DPHYSICS_TELEMETRY=0
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <stdint.h>
+
+#ifndef PHYSICS_TELEMETRY
+#define PHYSICS_TELEMETRY 1
+#endif
+
+enum TelemetryCounter {
+    TM_HIT_LEFT,        // moveBall() hits on the left paddle
+    TM_HIT_RIGHT,       // moveBall() hits on the right paddle
+    TM_CLAMPED_ENTRY,   // Sweeps that started inside, tEntry clamped to 0
+    TM_DEPEN_INSIDE,    // depenetrate() case 2: centre inside the paddle
+    TM_DEPEN_OVERLAP,   // depenetrate() case 3: centre outside, overlapping
+    TM_STILL_EARLY_OUT, // Sweeps skipped for near 0 relative velocity
+    TM_EXTRA_CONTACT,   // Hits and bounces after the first in a step
+    TM_CONTACT_CAP,     // Steps that ran out of contacts, rest unswept
+    TM_COUNT
+};
+
+class Telemetry {
+public:
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled() {
+        return sEnabled.load(std::memory_order_relaxed);
+    }
+
+    static void add(TelemetryCounter counter, uint64_t amount) {
+        sTotals[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    static void endFrame();
+    static uint64_t getTotal(TelemetryCounter counter);
+    static uint64_t getFrame(TelemetryCounter counter);
+    static void reset();
+
+    static bool writePrometheus(const char* filepath);
+
+private:
+    static std::atomic<bool> sEnabled;
+    static std::atomic<uint64_t> sTotals[TM_COUNT];
+};
+
+// Counts one event. While telemetry is off this is one relaxed load and a
+// predictable branch; with PHYSICS_TELEMETRY 0 it's nothing at all
+#if PHYSICS_TELEMETRY
+#define TELEMETRY_COUNT(counter)                                              \
+    do {                                                                      \
+        if (Telemetry::isEnabled()) Telemetry::add(counter, 1);               \
+    } while (0)
+#else
+#define TELEMETRY_COUNT(counter)                                              \
+    do {                                                                      \
+    } while (0)
+#endif
+
+#endif // TELEMETRY_H
@@ -0,0 +1,225 @@
+#include "TextureCache.h"
+
+struct CacheEntry {
+    std::string filepath;
+    Texture2D texture;
+    int refCount;
+    size_t bytes;
+    double loadSeconds;
+    AssetRequest request; // Until the loader uploads it, else NO_ASSET
+    TextureHandle atlas;  // Entry whose texture this is a region of
+    Rectangle region;     // Only for atlas regions
+};
+
+static std::vector<CacheEntry> sEntries;
+static std::vector<TextureHandle> sFreeSlots; // Released entries to reuse
+static std::map<std::string, TextureHandle> sHandles;
+static TextureCacheStats sStats;
+static AssetLoader* sLoader = nullptr;
+static const AssetPack* sPack = nullptr;
+static std::vector<TextureHandle> sPending; // Entries the loader still has
+static const Texture2D sNoTexture = {0, 0, 0, 0, 0};
+
+// Fills in a loaded entry's size and counts the load
+static void finishLoad(CacheEntry& entry, double seconds) {
+    const Texture2D& texture = entry.texture;
+    entry.bytes = static_cast<size_t>(
+        GetPixelDataSize(texture.width, texture.height, texture.format));
+    entry.loadSeconds = seconds;
+    sStats.loads++;
+    sStats.loadSeconds += seconds;
+    sStats.residentBytes += entry.bytes;
+    sStats.peakBytes = std::max(sStats.peakBytes, sStats.residentBytes);
+    // Hits while it was loading shared a size of 0; count them now
+    sStats.sharedBytes += entry.bytes * (entry.refCount - 1);
+}
+
+/**
+ * @brief Returns a handle to the texture at filepath, loading it only if no
+ * one holds it yet. With a loader set, the load is only queued and get()
+ * returns an empty texture until update() uploads it. Every acquire must be
+ * paired with a release
+ * @param filepath
+ * @return a handle for get() and release()
+ */
+TextureHandle TextureCache::acquire(const char* filepath) {
+    std::map<std::string, TextureHandle>::iterator found =
+        sHandles.find(filepath);
+    if (found != sHandles.end()) { // Already loaded: share it
+        CacheEntry& entry = sEntries[found->second];
+        entry.refCount++;
+        sStats.hits++;
+        sStats.sharedBytes += entry.bytes;
+        sStats.savedSeconds += entry.loadSeconds;
+        return found->second;
+    }
+    CacheEntry entry = {filepath,   sNoTexture, 1,           0,
+                        0.0,        NO_ASSET,   NO_TEXTURE, {0, 0, 0, 0}};
+    TextureHandle handle;
+    if (sFreeSlots.empty()) {
+        handle = static_cast<TextureHandle>(sEntries.size());
+        sEntries.push_back(entry);
+    } else {
+        handle = sFreeSlots.back();
+        sFreeSlots.pop_back();
+        sEntries[handle] = entry;
+    }
+    sHandles[filepath] = handle;
+    const PackTexture* packed = sPack ? sPack->find(filepath) : nullptr;
+    if (packed && !sPack->isCurrent(*packed)) { // Edited since `make pack`
+        printf("TextureCache: %s changed since the pack was built, "
+               "loading the file\n", filepath);
+        sStats.packStale++;
+        packed = nullptr;
+    }
+    if (packed && packed->atlas != PACK_NO_ATLAS) {
+        // A sprite in the atlas: hold the atlas and draw part of it
+        TextureHandle atlas = acquire(sPack->get(packed->atlas).name.c_str());
+        CacheEntry& region = sEntries[handle]; // acquire() may have grown it
+        region.atlas = atlas;
+        region.texture = sEntries[atlas].texture;
+        region.region = {static_cast<float>(packed->x),
+                         static_cast<float>(packed->y),
+                         static_cast<float>(packed->width),
+                         static_cast<float>(packed->height)};
+        return handle;
+    }
+    if (packed) { // First user: already decoded, just upload
+        double start = GetTime();
+        Image image = {const_cast<void*>(sPack->getPixels(*packed)),
+                       static_cast<int>(packed->width),
+                       static_cast<int>(packed->height),
+                       static_cast<int>(packed->mipmaps),
+                       static_cast<int>(packed->format)};
+        sEntries[handle].texture = LoadTextureFromImage(image);
+        finishLoad(sEntries[handle], GetTime() - start);
+        sStats.packLoads++;
+        return handle;
+    }
+    if (sLoader) { // First user: queue the decode and upload
+        sEntries[handle].request = sLoader->request(filepath);
+        sPending.push_back(handle);
+        return handle;
+    }
+    // First user: decode and upload now
+    double start = GetTime();
+    sEntries[handle].texture = LoadTexture(filepath);
+    finishLoad(sEntries[handle], GetTime() - start);
+    return handle;
+}
+
+/**
+ * @brief Drops one reference, unloading the texture once no one holds it
+ * @param handle
+ */
+void TextureCache::release(TextureHandle handle) {
+    if (handle == NO_TEXTURE) return;
+    CacheEntry& entry = sEntries[handle];
+    if (--entry.refCount > 0) {
+        sStats.sharedBytes -= entry.bytes;
+        return;
+    }
+    // A new entry may have the path if this one was released while loading
+    std::map<std::string, TextureHandle>::iterator found =
+        sHandles.find(entry.filepath);
+    if (found != sHandles.end() && found->second == handle)
+        sHandles.erase(found);
+    if (entry.request != NO_ASSET) return; // update() frees it once loaded
+    TextureHandle atlas = entry.atlas;
+    if (atlas == NO_TEXTURE) {
+        UnloadTexture(entry.texture);
+        sStats.unloads++;
+        sStats.residentBytes -= entry.bytes;
+    }
+    entry.texture = sNoTexture;
+    entry.atlas = NO_TEXTURE;
+    sFreeSlots.push_back(handle);
+    release(atlas); // The atlas goes with its last region
+}
+
+/**
+ * @brief Loads new files through loader from now on. Set it before the
+ * first acquire, and keep it until the cache is empty
+ * @param loader nullptr to load on the spot again
+ */
+void TextureCache::setLoader(AssetLoader* loader) {
+    sLoader = loader;
+}
+
+/**
+ * @brief Uploads files the pack has from its mapping from now on, ahead of
+ * the loader. Textures keep their own copy, so the pack can close once
+ * nothing else will be acquired
+ * @param pack an open pack, or nullptr to stop using it
+ */
+void TextureCache::setPack(const AssetPack* pack) {
+    sPack = pack;
+}
+
+/**
+ * @brief Render thread, once a frame: has the loader upload what's decoded
+ * within the budget, then hands the new textures to their entries
+ * @param budgetSeconds
+ * @return textures still loading
+ */
+int TextureCache::update(double budgetSeconds) {
+    if (sPending.empty()) return 0;
+    sLoader->upload(budgetSeconds);
+    for (size_t i = 0; i < sPending.size();) {
+        TextureHandle handle = sPending[i];
+        CacheEntry& entry = sEntries[handle];
+        bool loaded = sLoader->isLoaded(entry.request);
+        if (!loaded && !sLoader->hasFailed(entry.request)) {
+            i++;
+            continue;
+        }
+        bool orphaned = entry.refCount == 0; // Released while it was loading
+        if (orphaned) entry.refCount = 1;
+        // A failed file stays empty and still counts, as with LoadTexture()
+        entry.texture = sLoader->getTexture(entry.request);
+        finishLoad(entry, sLoader->getLatency(entry.request));
+        entry.request = NO_ASSET;
+        sPending[i] = sPending.back();
+        sPending.pop_back();
+        if (orphaned) release(handle);
+    }
+    return static_cast<int>(sPending.size());
+}
+
+const Texture2D& TextureCache::get(TextureHandle handle) {
+    if (handle == NO_TEXTURE) return sNoTexture;
+    return sEntries[handle].texture;
+}
+
+/**
+ * @brief The part of get()'s texture this handle draws: its region of the
+ * atlas, or else the whole texture
+ * @param handle
+ * @return the source rectangle, in pixels
+ */
+Rectangle TextureCache::getRegion(TextureHandle handle) {
+    if (handle != NO_TEXTURE && sEntries[handle].atlas != NO_TEXTURE)
+        return sEntries[handle].region;
+    const Texture2D& texture = get(handle);
+    return {0.0f, 0.0f, static_cast<float>(texture.width),
+            static_cast<float>(texture.height)};
+}
+
+const TextureCacheStats& TextureCache::getStats() {
+    return sStats;
+}
+
+/**
+ * @brief Prints the load and memory counters, e.g. after switching ball count
+ * @param label what just happened
+ */
+void TextureCache::logStats(const char* label) {
+    printf("TextureCache [%s]: %d loads (%d from the pack, %d stale, %.2f "
+           "ms), %d shared hits (%.2f ms saved), %d unloads, %.1f KiB "
+           "resident (peak %.1f KiB), %.1f KiB saved\n",
+           label, sStats.loads, sStats.packLoads, sStats.packStale,
+           sStats.loadSeconds * 1000.0, sStats.hits,
+           sStats.savedSeconds * 1000.0, sStats.unloads,
+           sStats.residentBytes / 1024.0, sStats.peakBytes / 1024.0,
+           sStats.sharedBytes / 1024.0);
+}
@@ -0,0 +1,45 @@
+// Reference counted textures keyed by file path, so entities that share an
+// image share one GPU texture instead of each calling LoadTexture(). Files in
+// the AssetPack upload straight from it, and sprites packed into its atlas
+// share the atlas texture, each drawing its own region. With an AssetLoader
+// set, the rest load in the background
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "AssetLoader.h"
+#include "AssetPack.h"
+#include "cs3113.h"
+
+typedef int TextureHandle; // Slot in the cache, stable until released
+constexpr TextureHandle NO_TEXTURE = -1;
+
+struct TextureCacheStats {
+    int loads = 0;              // Textures loaded (decode + upload)
+    int packLoads = 0;          // Of those, uploaded from the AssetPack
+    int packStale = 0;          // Pack textures whose file has since changed
+    int hits = 0;               // Acquires served by an already loaded texture
+    int unloads = 0;            // UnloadTexture() calls
+    double loadSeconds = 0.0;   // Total time from acquire to loaded
+    double savedSeconds = 0.0;  // Load time hits would have spent reloading
+    size_t residentBytes = 0;   // GPU memory held by loaded textures
+    size_t peakBytes = 0;       // Highest residentBytes so far
+    size_t sharedBytes = 0;     // Memory per-entity loading would duplicate
+};
+
+class TextureCache {
+public:
+    static TextureHandle acquire(const char* filepath);
+    static void release(TextureHandle handle);
+
+    static void setLoader(AssetLoader* loader);
+    static void setPack(const AssetPack* pack);
+    static int update(double budgetSeconds = ASSET_UPLOAD_BUDGET);
+
+    static const Texture2D& get(TextureHandle handle);
+    static Rectangle getRegion(TextureHandle handle);
+    static const TextureCacheStats& getStats();
+    static void logStats(const char* label);
+};
+
+#endif // TEXTURE_CACHE_H
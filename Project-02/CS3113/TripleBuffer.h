@@ -0,0 +1,52 @@
+// Lock-free handoff of whole values from one writer thread to one reader.
+// The writer fills its own buffer and publishes it; the reader takes the
+// newest published buffer whenever it likes. Neither ever waits, and the
+// reader never sees a buffer the writer is still filling
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <stdint.h>
+
+template <typename T>
+class TripleBuffer {
+public:
+    // The writer's buffer, free to fill until publish()
+    T& getWriteBuffer() { return mBuffers[mWrite]; }
+
+    // Writer only: hands the filled buffer over, taking back whichever one
+    // the reader isn't using
+    void publish() {
+        mWrite = mMiddle.exchange(static_cast<uint8_t>(mWrite | FRESH),
+                                  std::memory_order_acq_rel)
+               & INDEX;
+    }
+
+    // Reader only: swaps in the newest published buffer, if there's one the
+    // reader hasn't seen. Returns false if nothing new was published
+    bool fetch() {
+        if (!(mMiddle.load(std::memory_order_relaxed) & FRESH)) return false;
+        mRead = mMiddle.exchange(static_cast<uint8_t>(mRead),
+                                 std::memory_order_acq_rel)
+              & INDEX;
+        return true;
+    }
+
+    // The reader's buffer, unchanged until its next fetch()
+    const T& getReadBuffer() const { return mBuffers[mRead]; }
+
+    // For setting all three up before the threads start
+    T& getBuffer(int index) { return mBuffers[index]; }
+
+private:
+    static constexpr uint8_t INDEX = 3; // Buffer index bits of mMiddle
+    static constexpr uint8_t FRESH = 4; // Set while mMiddle is unread
+
+    T mBuffers[3];
+    uint8_t mWrite = 0;                  // Writer's buffer
+    uint8_t mRead = 1;                   // Reader's buffer
+    std::atomic<uint8_t> mMiddle {2};    // The spare, plus FRESH
+};
+
+#endif // TRIPLE_BUFFER_H
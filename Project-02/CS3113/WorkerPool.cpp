@@ -0,0 +1,67 @@
+#include "WorkerPool.h"
+
+/**
+ * @param threads total threads running tasks, including the caller of run()
+ */
+WorkerPool::WorkerPool(int threads) {
+    for (int i = 1; i < threads; i++)
+        mThreads.push_back(std::thread(&WorkerPool::workerLoop, this));
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for (std::thread& thread : mThreads) thread.join();
+}
+
+int WorkerPool::defaultThreads() {
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 0 ? static_cast<int>(cores) : 1;
+}
+
+/**
+ * @brief Runs task(0) to task(tasks - 1) across the pool and returns once all
+ * of them are done. Tasks are handed out in order but may finish in any order
+ * @param tasks
+ * @param task
+ */
+void WorkerPool::run(int tasks, const std::function<void(int)>& task) {
+    if (mThreads.empty() || tasks <= 1) {
+        for (int i = 0; i < tasks; i++) task(i);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask = &task;
+        mTaskCount = tasks;
+        mNextTask = 0;
+        mBusy = static_cast<int>(mThreads.size());
+        mGeneration++;
+    }
+    mWake.notify_all();
+    runTasks(); // Help out instead of idling
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return mBusy == 0; });
+    mTask = nullptr;
+}
+
+void WorkerPool::runTasks() {
+    for (int i = mNextTask++; i < mTaskCount; i = mNextTask++) (*mTask)(i);
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mWake.wait(lock, [&] { return mStopping || mGeneration != seen; });
+        if (mStopping) return;
+        seen = mGeneration;
+        lock.unlock();
+        runTasks();
+        lock.lock();
+        if (--mBusy == 0) mDone.notify_one();
+    }
+}
@@ -0,0 +1,42 @@
+// Fixed set of worker threads that run numbered tasks in parallel. The
+// calling thread joins in, so a pool of size 1 just runs tasks inline
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+public:
+    explicit WorkerPool(int threads = defaultThreads());
+    ~WorkerPool();
+
+    void run(int tasks, const std::function<void(int)>& task);
+
+    int size() const { return static_cast<int>(mThreads.size()) + 1; }
+
+    static int defaultThreads();
+
+private:
+    void workerLoop();
+    void runTasks();
+
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWake; // New batch of tasks, or stopping
+    std::condition_variable mDone; // Last worker finished the batch
+    const std::function<void(int)>* mTask = nullptr;
+    int mTaskCount = 0;
+    std::atomic<int> mNextTask {0};
+    int mBusy = 0;            // Workers still running the current batch
+    uint64_t mGeneration = 0; // Bumped per batch so workers don't rerun one
+    bool mStopping = false;
+};
+
+#endif // WORKER_POOL_H
@@ -72,19 +72,30 @@ void Normalise(Vector2* vector) {
  */
 Rectangle getUVRectangle(const Texture2D* texture, int index, int rows,
                          int cols) {
+    return getUVRectangle({0.0f, 0.0f, (float)texture->width,
+                           (float)texture->height},
+                          index, rows, cols);
+}
+
+/**
+ * Same as above, but the sheet only takes up `region` of the texture, e.g. a
+ * sprite sheet packed into an atlas. Slices are offset by the region's
+ * top-left corner.
+ */
+Rectangle getUVRectangle(Rectangle region, int index, int rows, int cols) {
     float uCoord = (float)(index % cols) / (float)cols;
-    uCoord *= texture->width;
+    uCoord *= region.width;
 
     float vCoord = (float)(index / cols) / (float)rows;
-    vCoord *= texture->height;
+    vCoord *= region.height;
 
-    float sliceWidth = texture->width / (float)cols;
-    float sliceHeight = texture->height / (float)rows;
+    float sliceWidth = region.width / (float)cols;
+    float sliceHeight = region.height / (float)rows;
 
     return {
-        uCoord,     // top-left x-coord
-        vCoord,     // top-left y-coord
-        sliceWidth, // width of slice
-        sliceHeight // height of slice
+        region.x + uCoord, // top-left x-coord
+        region.y + vCoord, // top-left y-coord
+        sliceWidth,        // width of slice
+        sliceHeight        // height of slice
     };
 }
\ No newline at end of file
@@ -21,6 +21,7 @@ void Normalise(Vector2* vector);
 float GetLength(const Vector2 vector);
 Rectangle getUVRectangle(const Texture2D* texture, int index, int rows,
                          int cols);
+Rectangle getUVRectangle(Rectangle region, int index, int rows, int cols);
 
 // Added this dupe of std::clamp() which was added in C++17
 template <typename T>
@@ -0,0 +1,34 @@
+// Helpers shared by the benchmarks: a wall clock and a bit-for-bit
+// comparison of two simulations. Header only; every bench links SIM_SRCS
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include "../CS3113/Simulation.h"
+#include <chrono>
+#include <string.h>
+
+typedef std::chrono::steady_clock Clock;
+
+static inline double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// True if a and b would play on identically: same tick, scores, RNG state,
+// paddles and balls, compared through their snapshots
+static inline bool sameState(const Simulation& a, const Simulation& b) {
+    SimSnapshot x, y;
+    a.save(x);
+    b.save(y);
+    bool same = x.rng.next() == y.rng.next() && x.tick == y.tick
+             && x.rallies == y.rallies && x.ballCount == y.ballCount
+             && x.balls == y.balls;
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++)
+        same = same && x.scores[side] == y.scores[side]
+            && memcmp(&x.paddles[side], &y.paddles[side],
+                      sizeof(PaddleState))
+                   == 0;
+    return same;
+}
+
+#endif // BENCH_UTIL_H
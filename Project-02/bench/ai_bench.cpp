@@ -0,0 +1,120 @@
+// Paddle AI cost and accuracy. Steps a pool of balls between two still
+// paddles and times, per tick, the old AI (scan every ball for the closest
+// one in x) against the Interceptor (predict the balls that turned, then read
+// the heap). Then plays AI against AI on a Simulation and checks every tick
+// that the incremental heap picks the same ball as predicting every ball
+// from scratch would.
+// Usage: ./ai_bench [ticks=2000]
+
+#include "../CS3113/Simulation.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static volatile float gSink; // Keeps the targets from being optimised away
+
+// What Simulation::runAI() did before: the ball closest to the paddle in x
+static float closestBallY(const BallPool& balls, const PaddleState& paddle) {
+    const float* posX = balls.getPositionsX();
+    int closestBall = 0;
+    float closestDist = fabsf(posX[0] - paddle.position.x);
+    for (int i = 1; i < balls.size(); i++) {
+        float dist = fabsf(posX[i] - paddle.position.x);
+        if (dist < closestDist) {
+            closestDist = dist;
+            closestBall = i;
+        }
+    }
+    return balls.getPositionsY()[closestBall];
+}
+
+// Nanoseconds per tick of each AI over ticks steps of count balls
+static void timeAI(int count, int ticks) {
+    const float deltaTime = 1.0f / SIM_TICK_RATE;
+    PaddleState paddles[2] = {makePaddle(LEFT_PADDLE),
+                              makePaddle(RIGHT_PADDLE)};
+    BallPool balls(BALL_SIZE / 2.0f, count);
+    Rng rng(67);
+    balls.resize(count);
+    balls.setBaseSpeed(count >= 67 ? BALL_SLOW_SPEED : BALL_FAST_SPEED);
+    balls.resetAll(rng);
+    Interceptor interceptor(RIGHT_PADDLE);
+    interceptor.reserve(count);
+    interceptor.rebuild(balls, paddles[RIGHT_PADDLE], 0.0);
+    balls.clearTurned();
+    double scanSeconds = 0.0, heapSeconds = 0.0;
+    long long turned = 0;
+    int scores[2] = {0, 0};
+    Intercept next;
+    for (int tick = 1; tick <= ticks; tick++) {
+        balls.update(deltaTime, paddles, scores[LEFT_PADDLE],
+                     scores[RIGHT_PADDLE], rng);
+        turned += balls.allTurned() ? count : balls.getTurned().size();
+        Clock::time_point start = Clock::now();
+        gSink = closestBallY(balls, paddles[RIGHT_PADDLE]);
+        scanSeconds += secondsSince(start);
+        start = Clock::now();
+        interceptor.update(balls, paddles[RIGHT_PADDLE], tick * deltaTime);
+        if (interceptor.next(balls, paddles[RIGHT_PADDLE], tick * deltaTime,
+                             next))
+            gSink = next.y;
+        heapSeconds += secondsSince(start);
+        balls.clearTurned();
+    }
+    printf("  %6d %14.1f %14.1f %9.1fx %12.2f\n", count,
+           scanSeconds * 1e9 / ticks, heapSeconds * 1e9 / ticks,
+           scanSeconds / heapSeconds, (double)turned / ticks);
+}
+
+// AI against AI, comparing the Simulation's heap with a fresh one each tick.
+// Returns the ticks where they picked different balls
+static int crossCheck(int count, int ticks, bool ballCollisions) {
+    Simulation sim(67, SIM_TICK_RATE);
+    sim.setBallCount(count);
+    sim.setBallCollisions(ballCollisions);
+    sim.setAI(LEFT_PADDLE, true);
+    sim.setAI(RIGHT_PADDLE, true);
+    int mismatches = 0, compared = 0;
+    for (int tick = 0; tick < ticks; tick++) {
+        sim.step();
+        for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+            Interceptor incremental = sim.getInterceptor(side);
+            Interceptor fresh(side);
+            fresh.rebuild(sim.getBalls(), sim.getPaddle(side), sim.getTime());
+            Intercept a, b;
+            bool hasA = incremental.next(sim.getBalls(), sim.getPaddle(side),
+                                         sim.getTime(), a);
+            bool hasB = fresh.next(sim.getBalls(), sim.getPaddle(side),
+                                   sim.getTime(), b);
+            if (!hasA && !hasB) continue;
+            compared++;
+            // Equal arrival times can round either way; those aren't errors
+            bool same = hasA && hasB
+                     && (a.ball == b.ball || fabs(a.time - b.time) < 1e-4);
+            if (!same) mismatches++;
+        }
+    }
+    printf("  %6d balls%s: %d ticks, %d picks compared, %d differ, %d-%d\n",
+           count, ballCollisions ? " colliding" : "", ticks, compared,
+           mismatches, sim.getLeftScore(), sim.getRightScore());
+    return mismatches;
+}
+
+int main(int argc, char** argv) {
+    int ticks = argc > 1 ? atoi(argv[1]) : 2000;
+
+    printf("ai_bench: %d ticks at %d Hz, paddles still\n", ticks,
+           SIM_TICK_RATE);
+    printf("  %6s %14s %14s %10s %12s\n", "balls", "scan ns/tick",
+           "heap ns/tick", "speedup", "turned/tick");
+    const int COUNTS[] = {1, 67, 1000, 10000};
+    for (int count : COUNTS) timeAI(count, ticks);
+
+    printf("incremental heap vs predicting every ball:\n");
+    int mismatches = 0;
+    for (int count : COUNTS)
+        mismatches += crossCheck(count, ticks / 2, false);
+    mismatches += crossCheck(1000, ticks / 2, true);
+    printf("%s\n", mismatches == 0 ? "OK" : "FAILED");
+    return mismatches == 0 ? 0 : 1;
+}
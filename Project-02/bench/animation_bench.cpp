@@ -0,0 +1,104 @@
+// Animation cost per atlas entity: the old per-frame std::map lookup and
+// vector copy vs the flat AnimationClips table. Counts every operator new
+// during the timed frames; the flat table must not allocate at all.
+// Usage: ./animation_bench [frames=1000]
+
+#include "../CS3113/Animation.h"
+#include "BenchUtil.h"
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned long long gAllocations = 0;
+
+void* operator new(size_t size) {
+    gAllocations++;
+    void* memory = malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept { free(memory); }
+
+// What Entity did before: copy the direction's clip out of the map each frame
+struct MapEntity {
+    std::map<Direction, std::vector<int>> atlas;
+    std::vector<int> indices;
+    Direction direction = DOWN;
+    int frameIndex = 0;
+    float time = 0.0f;
+
+    void update(float deltaTime, int frameSpeed) {
+        indices = atlas.at(direction);
+        time += deltaTime;
+        if (time >= 1.0f / frameSpeed) {
+            time = 0.0f;
+            frameIndex = (frameIndex + 1) % indices.size();
+        }
+    }
+};
+
+struct ClipEntity {
+    AnimationClips clips;
+    Animator animator {14};
+    Direction direction = DOWN;
+};
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 1000;
+    const int counts[] = {100, 1000, 10000};
+    const float deltaTime = 1.0f / 120.0f;
+    std::map<Direction, std::vector<int>> atlas = {
+        {LEFT, {0, 1, 2, 3}},
+        {UP, {4, 5, 6, 7}},
+        {RIGHT, {8, 9, 10, 11}},
+        {DOWN, {12, 13, 14, 15, 16, 17}}};
+    bool allocationFree = true;
+
+    printf("animation_bench: %d frames, 4 directions\n", frames);
+    printf("  %8s %14s %14s %14s %14s\n", "entities", "map ns/entity",
+           "map allocs", "flat ns/entity", "flat allocs");
+    for (int count : counts) {
+        std::vector<MapEntity> mapEntities(count);
+        std::vector<ClipEntity> clipEntities(count);
+        for (int i = 0; i < count; i++) {
+            mapEntities[i].atlas = atlas;
+            clipEntities[i].clips = AnimationClips(atlas);
+        }
+        double updates = (double)frames * count;
+
+        unsigned long long before = gAllocations;
+        Clock::time_point start = Clock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            Direction direction = static_cast<Direction>(frame / 30 % 4);
+            for (MapEntity& entity : mapEntities) {
+                entity.direction = direction;
+                entity.update(deltaTime, 14);
+            }
+        }
+        double mapSeconds = secondsSince(start);
+        unsigned long long mapAllocations = gAllocations - before;
+
+        int checksum = 0;
+        before = gAllocations;
+        start = Clock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            Direction direction = static_cast<Direction>(frame / 30 % 4);
+            for (ClipEntity& entity : clipEntities) {
+                entity.direction = direction;
+                entity.animator.update(entity.clips, direction, deltaTime);
+                checksum += entity.animator.getFrame(entity.clips, direction);
+            }
+        }
+        double flatSeconds = secondsSince(start);
+        unsigned long long flatAllocations = gAllocations - before;
+        allocationFree = allocationFree && flatAllocations == 0;
+
+        printf("  %8d %14.2f %14llu %14.2f %14llu\n", count,
+               mapSeconds * 1e9 / updates, mapAllocations,
+               flatSeconds * 1e9 / updates, flatAllocations);
+        if (checksum == -1) printf("unreachable\n"); // Keep the loop alive
+    }
+
+    return allocationFree ? 0 : 1;
+}
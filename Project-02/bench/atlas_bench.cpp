@@ -0,0 +1,101 @@
+// Atlas packing quality and speed. Packs the game's three sprites and some
+// random sprite sets, and checks every sprite and its border lands inside
+// the atlas without touching another. Prints how much of the atlas is
+// sprite, against the pixels the separate textures take.
+// Usage: ./atlas_bench [sprites=1000]
+
+#include "../CS3113/AtlasPacker.h"
+#include "../CS3113/Physics.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Every padded sprite is inside the atlas and overlaps no other
+static bool checkPlacement(const std::vector<AtlasRect>& rects, int padding,
+                           int width, int height) {
+    for (size_t i = 0; i < rects.size(); i++) {
+        const AtlasRect& a = rects[i];
+        if (a.x - padding < 0 || a.y - padding < 0
+            || a.x + a.width + padding > width
+            || a.y + a.height + padding > height)
+            return false;
+        for (size_t j = i + 1; j < rects.size(); j++) {
+            const AtlasRect& b = rects[j];
+            bool apart = a.x + a.width + padding <= b.x - padding
+                         || b.x + b.width + padding <= a.x - padding
+                         || a.y + a.height + padding <= b.y - padding
+                         || b.y + b.height + padding <= a.y - padding;
+            if (!apart) return false;
+        }
+    }
+    return true;
+}
+
+// Packs rects and prints the result. Returns false if the placement is bad
+static bool run(const char* name, std::vector<AtlasRect> rects) {
+    long long spritePixels = 0;
+    for (const AtlasRect& rect : rects)
+        spritePixels += (long long)rect.width * rect.height;
+    int width = 0, height = 0;
+    Clock::time_point start = Clock::now();
+    bool packed =
+        packAtlas(rects, ATLAS_PADDING, ATLAS_MAX_SIZE, width, height);
+    double seconds = secondsSince(start);
+    bool valid = packed && checkPlacement(rects, ATLAS_PADDING, width, height);
+    printf("  %-22s %5d sprites -> %5d x %-5d %5.1f%% sprite %9.2f ms: %s\n",
+           name, (int)rects.size(), width, height,
+           packed ? 100.0 * spritePixels / ((double)width * height) : 0.0,
+           seconds * 1000.0, valid ? "OK" : "BAD PLACEMENT");
+    return valid;
+}
+
+// paddle.png, ball.png and win.png, shrunk the way pack_assets --max-sprite
+// shrinks them (0 for full size)
+static std::vector<AtlasRect> gameRects(int maxSprite) {
+    const int SIZES[3][2] = {{1012, 1425}, {512, 512}, {4980, 498}};
+    std::vector<AtlasRect> rects(3);
+    for (int i = 0; i < 3; i++) {
+        int longest = std::max(SIZES[i][0], SIZES[i][1]);
+        int scale = maxSprite > 0 && longest > maxSprite ? maxSprite : longest;
+        rects[i].width = std::max(1, SIZES[i][0] * scale / longest);
+        rects[i].height = std::max(1, SIZES[i][1] * scale / longest);
+    }
+    return rects;
+}
+
+static std::vector<AtlasRect> randomRects(int count, int smallest,
+                                          int largest, uint32_t seed) {
+    Rng rng(seed);
+    std::vector<AtlasRect> rects(count);
+    for (AtlasRect& rect : rects) {
+        rect.width = rng.range(smallest, largest);
+        rect.height = rng.range(smallest, largest);
+    }
+    return rects;
+}
+
+int main(int argc, char** argv) {
+    int sprites = argc > 1 ? atoi(argv[1]) : 1000;
+    bool ok = true;
+
+    printf("atlas_bench: padding %d, at most %d x %d\n", ATLAS_PADDING,
+           ATLAS_MAX_SIZE, ATLAS_MAX_SIZE);
+    ok = run("game sprites", gameRects(0)) && ok;
+    ok = run("game, max-sprite 1024", gameRects(1024)) && ok;
+    ok = run("icons 16-64", randomRects(sprites, 16, 64, 1)) && ok;
+    ok = run("mixed 8-256", randomRects(sprites / 4, 8, 256, 2)) && ok;
+    ok = run("strips", randomRects(sprites / 10, 4, 512, 3)) && ok;
+
+    // Too big to fit is refused, not packed out of bounds
+    std::vector<AtlasRect> huge(1);
+    huge[0].width = ATLAS_MAX_SIZE, huge[0].height = 16;
+    int width, height;
+    bool refused =
+        !packAtlas(huge, ATLAS_PADDING, ATLAS_MAX_SIZE, width, height);
+    printf("  oversized sprite refused: %s\n", refused ? "OK" : "PACKED");
+    ok = ok && refused;
+
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+// BallPool scaling benchmark: per-ball update cost and memory from 1k to 1M
+// balls, against a gBalls-style vector of heap-allocated balls.
+// Usage: ./ballpool_bench [maxBalls=1000000]
+
+#include "../CS3113/BallPool.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+    int maxBalls = argc > 1 ? atoi(argv[1]) : 1000000;
+    const float deltaTime = 1.0f / FPS;
+    const long long ballUpdates = 20000000; // Per configuration
+    PaddleState paddles[2] = {makePaddle(LEFT_PADDLE),
+                              makePaddle(RIGHT_PADDLE)};
+
+    printf("ballpool_bench: %zu bytes/ball (pool), %zu bytes/ball "
+           "(BallState + heap pointer)\n",
+           BallPool::BYTES_PER_BALL, sizeof(BallState) + sizeof(BallState*));
+    printf("%10s %14s %14s %12s\n", "balls", "pool ns/ball", "heap ns/ball",
+           "pool MiB");
+    for (int count = 1000; count <= maxBalls; count *= 10) {
+        int steps = (int)(ballUpdates / count);
+        int leftScore = 0, rightScore = 0;
+        Rng rng(67);
+
+        BallPool pool;
+        pool.resize(count);
+        pool.resetAll(rng);
+        Clock::time_point start = Clock::now();
+        for (int s = 0; s < steps; s++)
+            pool.update(deltaTime, paddles, leftScore, rightScore, rng);
+        double poolSeconds = secondsSince(start);
+
+        // Same balls as separate heap allocations, walked through pointers
+        // like the old std::vector<Ball*> gBalls
+        rng.setSeed(67);
+        std::vector<BallState*> heapBalls;
+        std::vector<void*> padding; // Keeps allocations apart like a Ball
+        for (int i = 0; i < count; i++) {
+            BallState* ball = new BallState(pool.get(i));
+            ball->radius = pool.getRadius();
+            ball->baseSpeed = pool.getBaseSpeed();
+            resetBall(*ball, rng);
+            heapBalls.push_back(ball);
+            padding.push_back(malloc(160));
+        }
+        start = Clock::now();
+        for (int s = 0; s < steps; s++) {
+            for (BallState* ball : heapBalls) {
+                int scorer = stepBall(*ball, paddles, deltaTime);
+                if (scorer != NO_PADDLE) {
+                    (scorer == LEFT_PADDLE ? leftScore : rightScore)++;
+                    resetBall(*ball, rng);
+                }
+            }
+        }
+        double heapSeconds = secondsSince(start);
+        for (BallState* ball : heapBalls) delete ball;
+        for (void* p : padding) free(p);
+
+        double updates = (double)steps * count;
+        printf("%10d %14.2f %14.2f %12.2f\n", count,
+               poolSeconds * 1e9 / updates, heapSeconds * 1e9 / updates,
+               pool.memoryUsage() / (1024.0 * 1024.0));
+    }
+    return 0;
+}
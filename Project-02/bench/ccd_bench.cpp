@@ -0,0 +1,116 @@
+// Continuous collision at 100x the normal ball speed, where one step can
+// cross the whole screen. Every trial aims a ball at the left paddle's face,
+// straight or off the top or bottom edge first, so it must bounce; a ball
+// that ever gets behind the paddle tunnelled. Runs the old first contact
+// only sweep and the contact loop, which must not tunnel at all, then times
+// both speeds to show the loop only costs extra when there are contacts.
+// Usage: ./ccd_bench [trials=100000]
+
+#include "../CS3113/BallPool.h"
+#include "../CS3113/Telemetry.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const float STRESS_SPEED = BALL_FAST_SPEED * 100.0f;
+
+// Counts trials where a ball aimed at the left paddle ends up behind it
+static int countTunnels(int trials, int maxContacts, const PaddleState
+                        paddles[2], float deltaTime) {
+    const float radius = BALL_SIZE / 2.0f;
+    const PaddleState& paddle = paddles[LEFT_PADDLE];
+    float faceX = paddle.position.x + PADDLE_WIDTH / 2.0f + radius;
+    float spanTop = paddle.position.y - PADDLE_HEIGHT / 2.0f + 5.0f;
+    float spanBottom = paddle.position.y + PADDLE_HEIGHT / 2.0f - 5.0f;
+    Rng rng(1234);
+    int tunnels = 0;
+    for (int trial = 0; trial < trials; trial++) {
+        BallState ball;
+        ball.radius = radius;
+        ball.baseSpeed = STRESS_SPEED;
+        ball.speedMultiplier = 1.0f + rng.range(0, 20) / 10.0f;
+        ball.speed = ball.baseSpeed * ball.speedMultiplier;
+        ball.lastCollision = NO_PADDLE;
+        ball.position = {static_cast<float>(rng.range(300, SCREEN_WIDTH - 100)),
+                         static_cast<float>(rng.range(
+                             static_cast<int>(radius),
+                             static_cast<int>(SCREEN_HEIGHT - radius)))};
+        float targetY = spanTop + (spanBottom - spanTop) * rng.range(0, 1000)
+                                      / 1000.0f;
+        // Aim at the target's mirror image to bounce off an edge on the way
+        int route = trial % 3;
+        if (route == 1) targetY = 2.0f * radius - targetY;
+        if (route == 2) targetY = 2.0f * (SCREEN_HEIGHT - radius) - targetY;
+        float dirX = faceX - ball.position.x;
+        float dirY = targetY - ball.position.y;
+        float length = sqrtf(dirX * dirX + dirY * dirY);
+        ball.movement = {dirX / length, dirY / length};
+        for (int step = 0; step < 20; step++) {
+            stepBall(ball, paddles, deltaTime, maxContacts);
+            if (ball.position.x < paddle.position.x) {
+                tunnels++;
+                break;
+            }
+            if (ball.lastCollision == LEFT_PADDLE && ball.movement.x > 0.0f)
+                break; // Bounced off the face
+        }
+    }
+    return tunnels;
+}
+
+// Steps a pool of balls between moving paddles, returning ns per ball step
+static double timePool(float baseSpeed, int balls, int steps,
+                       float deltaTime) {
+    PaddleState paddles[2] = {makePaddle(LEFT_PADDLE),
+                              makePaddle(RIGHT_PADDLE)};
+    BallPool pool;
+    pool.setBaseSpeed(baseSpeed);
+    pool.resize(balls);
+    Rng rng(67);
+    pool.resetAll(rng);
+    int leftScore = 0, rightScore = 0;
+    Clock::time_point start = Clock::now();
+    for (int step = 0; step < steps; step++) {
+        float direction = step / 60 % 2 ? 1.0f : -1.0f;
+        paddles[LEFT_PADDLE].movement.y = direction;
+        paddles[RIGHT_PADDLE].movement.y = -direction;
+        pool.update(deltaTime, paddles, leftScore, rightScore, rng);
+        stepPaddle(paddles[LEFT_PADDLE], deltaTime);
+        stepPaddle(paddles[RIGHT_PADDLE], deltaTime);
+    }
+    return secondsSince(start) * 1e9 / ((double)steps * balls);
+}
+
+int main(int argc, char** argv) {
+    int trials = argc > 1 ? atoi(argv[1]) : 100000;
+    const float deltaTime = 1.0f / FPS;
+    PaddleState paddles[2] = {makePaddle(LEFT_PADDLE),
+                              makePaddle(RIGHT_PADDLE)};
+
+    printf("ccd_bench: %d trials at %.0f px/s (%.0f px per step), "
+           "straight or off an edge\n",
+           trials, STRESS_SPEED, STRESS_SPEED * deltaTime);
+    int oldTunnels = countTunnels(trials, 1, paddles, deltaTime);
+    int newTunnels =
+        countTunnels(trials, CCD_MAX_CONTACTS, paddles, deltaTime);
+    printf("  first contact only   %8d tunnelled (%.2f%%)\n", oldTunnels,
+           100.0 * oldTunnels / trials);
+    printf("  contact loop (%d)     %8d tunnelled: %s\n", CCD_MAX_CONTACTS,
+           newTunnels, newTunnels == 0 ? "OK" : "FAILED");
+
+    // Cost per ball step, with the loop's extra contacts counted
+    const int BALLS = 1000, STEPS = 2000;
+    Telemetry::setEnabled(true);
+    printf("  %10s %12s %16s %14s\n", "speed", "ns/ball", "extra contacts",
+           "contact caps");
+    const float speeds[] = {BALL_FAST_SPEED, STRESS_SPEED};
+    for (float speed : speeds) {
+        Telemetry::reset();
+        double ns = timePool(speed, BALLS, STEPS, deltaTime);
+        printf("  %9.0fx %12.2f %16.4f %14llu\n", speed / BALL_FAST_SPEED, ns,
+               (double)Telemetry::getTotal(TM_EXTRA_CONTACT) / (BALLS * STEPS),
+               (unsigned long long)Telemetry::getTotal(TM_CONTACT_CAP));
+    }
+    printf("  (extra contacts per ball step)\n");
+    return newTunnels == 0 ? 0 : 1;
+}
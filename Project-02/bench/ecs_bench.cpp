@@ -0,0 +1,152 @@
+// Per-entity footprint and update throughput: the Entity/Ball class layout
+// (each object on the heap, updated through a virtual call) vs EcsWorld's
+// packed components updated by moveSystem() and animationSystem(). The class
+// side is a reconstruction of the deleted Entity's members, in their order,
+// since the ECS replaced it. Both must end with every entity in the same
+// place on the same frame.
+// Usage: ./ecs_bench [frames=200]
+
+#include "../CS3113/Ecs.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// The deleted Entity's members, in Entity's order
+class ClassEntity {
+public:
+    virtual ~ClassEntity() { }
+
+    virtual void update(float deltaTime) {
+        mPosition = {mPosition.x + mSpeed * mMovement.x * deltaTime,
+                     mPosition.y + mSpeed * mMovement.y * deltaTime};
+        if (mAtlas
+            && (mAlwaysAnimate || mMovement.x != 0.0f || mMovement.y != 0.0f))
+            mAnimator.update(mClips, mDirection, deltaTime);
+    }
+
+    virtual void setScale(Vec2 scale) { mScale = scale; }
+
+    int mTexture = 0;
+    bool mAtlas = false; // TextureType
+    Vec2 mSpriteSheetDimensions = {1.0f, 1.0f};
+    AnimationClips mClips;
+    Animator mAnimator {14};
+    Direction mDirection = DOWN;
+    Vec2 mPosition, mMovement, mScale, mColliderDimensions;
+    int mSpeed = 200;
+    float mAngle = 0.0f;
+    bool mFlipped = false;
+    bool mAlwaysAnimate = false;
+};
+
+// Ball's extra members
+class ClassBall : public ClassEntity {
+public:
+    void setScale(Vec2 scale) override {
+        ClassEntity::setScale(scale);
+        mRadius = scale.x / 2.0f;
+    }
+
+    float mSpeedMultiplier = 1.0f;
+    float mBaseSpeed = BALL_FAST_SPEED;
+    float mRadius = 0.0f;
+    int mLastCollision = NO_PADDLE;
+};
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 200;
+    const float deltaTime = 1.0f / 120.0f;
+    const int counts[] = {1000, 10000, 100000};
+    std::map<Direction, std::vector<int>> atlas = {{DOWN, {0, 1, 2, 3}}};
+    bool ok = true;
+
+    // Every entity moves; one in ten also animates
+    size_t classBytes = sizeof(ClassBall);
+    size_t ecsBytes = SparseSet<TransformComponent>::BYTES_PER_ENTITY
+                    + SparseSet<Motion>::BYTES_PER_ENTITY
+                    + SparseSet<BoxCollider>::BYTES_PER_ENTITY
+                    + SparseSet<Sprite>::BYTES_PER_ENTITY
+                    + sizeof(uint32_t); // Generation
+    printf("ecs_bench: %d frames, 1 in 10 entities animated\n", frames);
+    printf("  bytes per ball: class %zu (+ pointer and heap header), "
+           "components %zu (+%zu animated)\n",
+           classBytes, ecsBytes, SparseSet<AnimationState>::BYTES_PER_ENTITY);
+    printf("  %8s %16s %16s %8s\n", "entities", "class ns/entity",
+           "ecs ns/entity", "speedup");
+    for (int count : counts) {
+        Rng rng(67);
+        std::vector<ClassEntity*> objects(count);
+        EcsWorld world;
+        int clips = world.addClips(atlas);
+        for (int i = 0; i < count; i++) {
+            Vec2 position = {(float)rng.range(0, SCREEN_WIDTH),
+                             (float)rng.range(0, SCREEN_HEIGHT)};
+            Vec2 movement = {rng.range(-100, 100) / 100.0f,
+                             rng.range(-100, 100) / 100.0f};
+            bool animated = i % 10 == 0;
+
+            ClassBall* ball = new ClassBall();
+            ball->mPosition = position;
+            ball->mMovement = movement;
+            ball->setScale({BALL_SIZE, BALL_SIZE});
+            ball->mColliderDimensions = {BALL_SIZE, BALL_SIZE};
+            if (animated) {
+                ball->mAtlas = true;
+                ball->mClips = AnimationClips(atlas);
+            }
+            objects[i] = ball;
+
+            EntityId entity = world.create();
+            TransformComponent transform;
+            transform.position = position;
+            transform.scale = {BALL_SIZE, BALL_SIZE};
+            world.transforms.add(entity, transform);
+            world.motions.add(entity, {movement, 200.0f});
+            world.colliders.add(entity, {{BALL_SIZE, BALL_SIZE}});
+            Sprite sprite;
+            sprite.texture = 0;
+            sprite.sheetDimensions = {1.0f, 1.0f};
+            world.sprites.add(entity, sprite);
+            if (animated) {
+                AnimationState animation;
+                animation.clips = clips;
+                animation.animator.setFrameSpeed(14);
+                world.animations.add(entity, animation);
+            }
+        }
+        double updates = (double)frames * count;
+
+        Clock::time_point start = Clock::now();
+        for (int frame = 0; frame < frames; frame++)
+            for (ClassEntity* object : objects) object->update(deltaTime);
+        double classTime = secondsSince(start);
+
+        start = Clock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            moveSystem(world, deltaTime);
+            animationSystem(world, deltaTime);
+        }
+        double ecsTime = secondsSince(start);
+
+        // Entity ids were handed out in order, so index i is object i
+        bool same = true;
+        const TransformComponent* transforms = world.transforms.data();
+        for (int i = 0; i < count; i++) {
+            if (transforms[i].position.x != objects[i]->mPosition.x
+                || transforms[i].position.y != objects[i]->mPosition.y)
+                same = false;
+        }
+        for (int i = 0; i < world.animations.size(); i++) {
+            uint32_t owner = world.animations.entities()[i];
+            if (world.animations.data()[i].animator.getFrameIndex()
+                != objects[owner]->mAnimator.getFrameIndex())
+                same = false;
+        }
+        ok = ok && same;
+        printf("  %8d %16.2f %16.2f %7.2fx %s\n", count,
+               classTime * 1e9 / updates, ecsTime * 1e9 / updates,
+               classTime / ecsTime, same ? "" : "MISMATCH");
+        for (ClassEntity* object : objects) delete object;
+    }
+    return ok ? 0 : 1;
+}
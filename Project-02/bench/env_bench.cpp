@@ -0,0 +1,109 @@
+// Batch environment throughput. Steps thousands of envs with random actions
+// on one thread and on every core, and prints env steps per second. Checks
+// that both end in exactly the same observations, that a caller's buffer is
+// filled in place, and that a policy tracking the ball loses fewer points
+// than a random one.
+// Usage: ./env_bench [steps=2000] [threads=hardware_concurrency]
+
+#include "../CS3113/BatchEnv.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Actions for every step up front, so the timing is only the env
+static std::vector<int8_t> randomActions(int envs, int steps, uint32_t seed) {
+    Rng rng(seed);
+    std::vector<int8_t> actions(static_cast<size_t>(envs) * steps);
+    for (int8_t& action : actions)
+        action = static_cast<int8_t>(rng.range(ENV_UP, ENV_DOWN));
+    return actions;
+}
+
+// Runs steps steps and returns the wall time
+static double run(BatchEnv& env, const std::vector<int8_t>& actions,
+                  int steps) {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < steps; i++)
+        env.step(&actions[static_cast<size_t>(i) * env.count()]);
+    return secondsSince(start);
+}
+
+// Points lost per minute of play with the left paddle moving towards the
+// ball, read straight from the observation buffer, or at random. The AI on
+// the right rarely misses, so fewer is better
+static double pointsLost(bool track, int envs, int steps) {
+    BatchEnv env;
+    EnvStep result = env.reset(envs, 1);
+    std::vector<int8_t> actions(envs);
+    Rng rng(2);
+    double lost = 0.0;
+    for (int i = 0; i < steps; i++) {
+        for (int e = 0; e < envs; e++) {
+            const float* row = result.observations + e * ENV_OBS_SIZE;
+            if (!track)
+                actions[e] = static_cast<int8_t>(rng.range(ENV_UP, ENV_DOWN));
+            else // Ball y against own paddle y, with a little slack
+                actions[e] = row[1] < row[4] - 0.02f ? ENV_UP :
+                             row[1] > row[4] + 0.02f ? ENV_DOWN :
+                                                       ENV_STAY;
+        }
+        result = env.step(actions.data());
+        for (int e = 0; e < envs; e++)
+            if (result.rewards[e] < 0.0f) lost -= result.rewards[e];
+    }
+    double minutes = (double)envs * steps * ENV_TICKS_PER_STEP
+                   / SIM_TICK_RATE / 60.0;
+    return lost / minutes;
+}
+
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? atoi(argv[1]) : 2000;
+    int threads = argc > 2 ? atoi(argv[2]) : WorkerPool::defaultThreads();
+    WorkerPool workers(threads);
+    const int counts[] = {1, 64, 1024, 16384};
+    bool ok = true;
+
+    printf("env_bench: %d steps of %d ticks, %d threads\n", steps,
+           ENV_TICKS_PER_STEP, threads);
+    printf("  %6s %16s %16s %8s %9s %6s\n", "envs", "1 thread steps/s",
+           "pool steps/s", "speedup", "episodes", "match");
+    for (int count : counts) {
+        std::vector<int8_t> actions = randomActions(count, steps, 67);
+        BatchEnv serial;
+        serial.reset(count);
+        double serialSeconds = run(serial, actions, steps);
+
+        // The same envs on every core, observing into our own buffer
+        std::vector<float> buffer(static_cast<size_t>(count) * ENV_OBS_SIZE);
+        BatchEnv parallel(&workers);
+        EnvStep first = parallel.reset(count, 67, buffer.data());
+        double parallelSeconds = run(parallel, actions, steps);
+
+        // Threads only split the envs, so both runs end bit for bit equal
+        EnvStep serialLast = serial.step(&actions[0]);
+        EnvStep parallelLast = parallel.step(&actions[0]);
+        bool inPlace = first.observations == buffer.data()
+                    && parallelLast.observations == buffer.data();
+        bool match = inPlace
+                  && memcmp(serialLast.observations, buffer.data(),
+                            buffer.size() * sizeof(float))
+                         == 0
+                  && serial.getEpisodes() == parallel.getEpisodes();
+        ok = ok && match;
+        printf("  %6d %16.0f %16.0f %7.1fx %9llu %6s\n", count,
+               (double)count * steps / serialSeconds,
+               (double)count * steps / parallelSeconds,
+               serialSeconds / parallelSeconds,
+               (unsigned long long)parallel.getEpisodes(),
+               match ? "yes" : "NO");
+    }
+
+    double tracking = pointsLost(true, 256, 4000);
+    double random = pointsLost(false, 256, 4000);
+    printf("  points lost a minute: tracking %.2f, random %.2f\n", tracking,
+           random);
+    ok = ok && tracking < random;
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+// Event-driven EventSim vs the per-tick stepBall() path with fixed paddles.
+// First a cross-check: the same balls run until they score under both, and
+// each must hit the same paddles and leave on the same side at (nearly) the
+// same time. Then both simulate an hour of play to compare throughput.
+// Usage: ./event_bench [balls=1000] [checkRate=SIM_TICK_RATE] [hours=1]
+
+#include "../CS3113/EventSim.h"
+#include "BenchUtil.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// What happened to one ball until it scored
+struct Outcome {
+    std::vector<int> paddles; // Paddles hit, in order, repeats collapsed
+    int scorer = NO_PADDLE;
+    double exitTime = 0.0;
+    Vec2 position = {0.0f, 0.0f}; // Where it ended if it never scored
+};
+
+static void notePaddle(Outcome& outcome, int side) {
+    if (outcome.paddles.empty() || outcome.paddles.back() != side)
+        outcome.paddles.push_back(side);
+}
+
+int main(int argc, char** argv) {
+    int ballCount = argc > 1 ? atoi(argv[1]) : 1000;
+    int checkRate = argc > 2 ? atoi(argv[2]) : SIM_TICK_RATE;
+    double hours = argc > 3 ? atof(argv[3]) : 1.0;
+    const double horizon = 8.0; // Seconds each ball is followed for
+    PaddleState paddles[2] = {makePaddle(LEFT_PADDLE),
+                              makePaddle(RIGHT_PADDLE)};
+
+    // Balls anywhere between the paddles, heading anywhere but straight up
+    Rng rng(67);
+    std::vector<BallState> balls(ballCount);
+    for (BallState& ball : balls) {
+        ball.baseSpeed = BALL_FAST_SPEED;
+        ball.radius = BALL_SIZE / 2.0f;
+        resetBall(ball, rng.range(-60, 60), rng.range(0, 1) != 0);
+        ball.position = {(float)rng.range(100, SCREEN_WIDTH - 100),
+                         (float)rng.range(20, SCREEN_HEIGHT - 20)};
+    }
+
+    // Each ball runs in its own EventSim, with serving off so it stops when
+    // it scores, stepped along with the per-tick path. stepBall() piles up
+    // float rounding over thousands of small steps, and a paddle's hit
+    // offset would blow that up into a different rally, so after each hit
+    // the per-tick ball restarts from where the event path has it. Higher
+    // check rates step more often and round more, so in a big enough batch
+    // some ball grazes a paddle corner by less than that and splits
+    std::vector<Outcome> ticked(ballCount);
+    std::vector<Outcome> predicted(ballCount);
+    float deltaTime = 1.0f / checkRate;
+    int steps = static_cast<int>(horizon * checkRate);
+    for (int i = 0; i < ballCount; i++) {
+        std::vector<SimEvent> log;
+        EventSim events;
+        events.setPaddles(paddles);
+        events.setServeAfterScore(false);
+        events.setEventLog(&log);
+        events.setBalls(std::vector<BallState>(1, balls[i]));
+
+        // Per-tick path: stepBall(), with paddle hits read off lastCollision
+        BallState ball = balls[i];
+        Outcome& outcome = ticked[i];
+        for (int step = 0; step < steps; step++) {
+            int lastCollision = ball.lastCollision;
+            int scorer = stepBall(ball, paddles, deltaTime);
+            if (scorer != NO_PADDLE) {
+                outcome.scorer = scorer;
+                outcome.exitTime = (step + 1) * (double)deltaTime;
+                break;
+            }
+            if (ball.lastCollision != lastCollision) {
+                notePaddle(outcome, ball.lastCollision);
+                events.advanceTo((step + 1) * (double)deltaTime);
+                if (events.isActive(0)) ball = events.getBall(0);
+            }
+        }
+        outcome.position = ball.position;
+
+        events.advanceTo(horizon);
+        Outcome& eventOutcome = predicted[i];
+        for (const SimEvent& event : log) {
+            if (event.type == EVENT_PADDLE_LEFT)
+                notePaddle(eventOutcome, LEFT_PADDLE);
+            if (event.type == EVENT_PADDLE_RIGHT)
+                notePaddle(eventOutcome, RIGHT_PADDLE);
+            if (event.type == EVENT_EXIT) {
+                eventOutcome.scorer = events.getBall(0).movement.x > 0 ?
+                                          LEFT_PADDLE :
+                                          RIGHT_PADDLE;
+                eventOutcome.exitTime = event.time;
+            }
+        }
+        if (events.isActive(0))
+            eventOutcome.position = events.getBall(0).position;
+    }
+
+    // Exits still only line up to within a tick plus rounding
+    const double EXIT_TOLERANCE = 0.01;
+    int mismatches = 0;
+    for (int i = 0; i < ballCount; i++) {
+        const Outcome& a = ticked[i];
+        const Outcome& b = predicted[i];
+        bool same = a.paddles == b.paddles && a.scorer == b.scorer;
+        if (same && a.scorer != NO_PADDLE)
+            same = fabs(a.exitTime - b.exitTime) <= EXIT_TOLERANCE;
+        if (!same) mismatches++;
+    }
+
+    printf("event_bench: %d balls, cross-checked at %d Hz for %.0f s\n",
+           ballCount, checkRate, horizon);
+    printf("  mismatches       %d\n", mismatches);
+
+    // Throughput: an hour of 67 balls serving forever. Paddles jump to new
+    // heights every second (fixed paddles would allow endless dead-centre
+    // rallies), which also re-predicts every ball in the EventSim
+    const int ballsInPlay = 67;
+    const float tickTime = 1.0f / SIM_TICK_RATE;
+    const int seconds = static_cast<int>(hours * 3600.0);
+    std::vector<float> heights[2];
+    Rng paddleRng(67);
+    for (int second = 0; second < seconds; second++)
+        for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++)
+            heights[side].push_back((float)paddleRng.range(
+                PADDLE_HEIGHT / 2, SCREEN_HEIGHT - PADDLE_HEIGHT / 2));
+
+    std::vector<BallState> pool(ballsInPlay);
+    Rng serveRng(67);
+    for (BallState& ball : pool) {
+        ball.baseSpeed = BALL_SLOW_SPEED;
+        ball.radius = BALL_SIZE / 2.0f;
+        resetBall(ball, serveRng);
+    }
+    int tickScores = 0;
+    uint64_t ticks = 0;
+    Clock::time_point start = Clock::now();
+    for (int second = 0; second < seconds; second++) {
+        paddles[LEFT_PADDLE].position.y = heights[LEFT_PADDLE][second];
+        paddles[RIGHT_PADDLE].position.y = heights[RIGHT_PADDLE][second];
+        for (int tick = 0; tick < SIM_TICK_RATE; tick++, ticks++)
+            for (BallState& ball : pool)
+                if (stepBall(ball, paddles, tickTime) != NO_PADDLE) {
+                    resetBall(ball, serveRng);
+                    tickScores++;
+                }
+    }
+    double tickSeconds = secondsSince(start);
+
+    EventSim hour;
+    hour.setBallCount(ballsInPlay, BALL_SLOW_SPEED);
+    start = Clock::now();
+    for (int second = 0; second < seconds; second++) {
+        paddles[LEFT_PADDLE].position.y = heights[LEFT_PADDLE][second];
+        paddles[RIGHT_PADDLE].position.y = heights[RIGHT_PADDLE][second];
+        hour.setPaddles(paddles);
+        hour.advanceTo(second + 1.0);
+    }
+    double eventSeconds = secondsSince(start);
+    const EventSimStats& stats = hour.getStats();
+
+    printf("  %.1f h of %d balls, paddles moved every second:\n", hours,
+           ballsInPlay);
+    printf("    per tick       %.3f s (%llu ticks, %d points)\n", tickSeconds,
+           (unsigned long long)ticks, tickScores);
+    printf("    event driven   %.3f s (%llu events, %llu stale, %d points)\n",
+           eventSeconds, (unsigned long long)stats.events,
+           (unsigned long long)stats.staleEvents,
+           hour.getLeftScore() + hour.getRightScore());
+    printf("    speedup        %.1fx\n", tickSeconds / eventSeconds);
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// Ball-ball broadphase benchmark: uniform grid against testing every pair,
+// as the ball count grows in the normal arena.
+// Usage: ./grid_bench [frames=200]
+
+#include "../CS3113/BallGrid.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool operator<(const BallPair& a, const BallPair& b) {
+    return a.first != b.first ? a.first < b.first : a.second < b.second;
+}
+
+static int findContactsNaive(const float* posX, const float* posY, int count,
+                             float radius, std::vector<BallPair>& contacts) {
+    contacts.clear();
+    const float touchSq = (2.0f * radius) * (2.0f * radius);
+    int tests = 0;
+    for (int i = 0; i < count; i++) {
+        for (int j = i + 1; j < count; j++) {
+            tests++;
+            float dx = posX[j] - posX[i];
+            float dy = posY[j] - posY[i];
+            if (dx * dx + dy * dy < touchSq) contacts.push_back({i, j});
+        }
+    }
+    return tests;
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 200;
+    const int counts[] = {67, 250, 500, 1000, 2000, 5000, 10000};
+    PaddleState paddles[2] = {makePaddle(LEFT_PADDLE),
+                              makePaddle(RIGHT_PADDLE)};
+
+    printf("grid_bench: %d frames per count, %.0fx%.0f cells of %.0f px\n",
+           frames, ceilf(SCREEN_WIDTH / BALL_SIZE),
+           ceilf(SCREEN_HEIGHT / BALL_SIZE), BALL_SIZE);
+    printf("%7s %12s %12s %10s %12s %12s %8s\n", "balls", "grid tests",
+           "naive tests", "contacts", "grid ms/f", "naive ms/f", "match");
+    for (int count : counts) {
+        BallPool balls;
+        BallGrid grid;
+        Rng rng(67);
+        int leftScore = 0, rightScore = 0;
+        balls.resize(count);
+        balls.resetAll(rng);
+        // Spread the balls over the arena instead of stacked on the serve
+        for (int i = 0; i < count; i++) {
+            BallState ball = balls.get(i);
+            ball.position = {(float)rng.range(40, SCREEN_WIDTH - 40),
+                             (float)rng.range(10, SCREEN_HEIGHT - 10)};
+            balls.set(i, ball);
+        }
+
+        long long gridTests = 0, contacts = 0;
+        double gridSeconds = 0.0;
+        for (int f = 0; f < frames; f++) {
+            balls.update(1.0f / FPS, paddles, leftScore, rightScore, rng);
+            Clock::time_point start = Clock::now();
+            contacts += grid.collide(balls);
+            gridSeconds += secondsSince(start);
+            gridTests += grid.getPairTests();
+        }
+
+        // Same final positions through both broadphases
+        std::vector<BallPair> gridPairs, naivePairs;
+        grid.findContacts(balls.getPositionsX(), balls.getPositionsY(), count,
+                          balls.getRadius(), gridPairs);
+        int naiveFrames = std::max(1, std::min(frames, 2000000 / count));
+        long long naiveTests = 0;
+        Clock::time_point start = Clock::now();
+        for (int f = 0; f < naiveFrames; f++)
+            naiveTests = findContactsNaive(balls.getPositionsX(),
+                                           balls.getPositionsY(), count,
+                                           balls.getRadius(), naivePairs);
+        double naiveSeconds = secondsSince(start) / naiveFrames;
+        std::sort(gridPairs.begin(), gridPairs.end());
+        bool match = gridPairs.size() == naivePairs.size()
+                  && std::equal(gridPairs.begin(), gridPairs.end(),
+                                naivePairs.begin(),
+                                [](const BallPair& a, const BallPair& b) {
+                                    return a.first == b.first
+                                        && a.second == b.second;
+                                });
+
+        printf("%7d %12lld %12lld %10lld %12.4f %12.4f %8s\n", count,
+               gridTests / frames, naiveTests, contacts / frames,
+               gridSeconds * 1000.0 / frames, naiveSeconds * 1000.0,
+               match ? "yes" : "NO");
+        if (!match) return 1;
+    }
+    return 0;
+}
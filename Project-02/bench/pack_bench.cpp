@@ -0,0 +1,224 @@
+// Asset pack format and startup cost, without raylib. Packs textures the
+// size of the game's PNGs (read from their headers) and checks they read
+// back exactly, aligned, and that a flipped byte, a wrong version, a short
+// file or a texture size that doesn't fit its pixels is refused, and that an
+// image changed since packing is noticed. Then
+// times opening the pack against reading every PNG file the way
+// LoadTexture(path) starts. That side leaves out the inflate, so it
+// understates the PNG path; tools/pack_assets times the full decode.
+// Usage: ./pack_bench [runs=50]
+
+#include "../CS3113/AssetPack.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const IMAGES[] = {"assets/paddle.png", "assets/ball.png",
+                                     "assets/win.png"};
+static const int IMAGE_COUNT = 3;
+static const uint32_t RGBA8 = 7; // raylib's PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+static const char* const PACK_PATH = "pack_bench.pack";
+static const char* const BROKEN_PATH = "pack_bench_broken.pack";
+static const char* const SOURCE_PATH = "pack_bench_source.png";
+
+static std::vector<uint8_t> readFile(const char* filepath) {
+    std::vector<uint8_t> data;
+    FILE* file = fopen(filepath, "rb");
+    if (!file) return data;
+    uint8_t buffer[65536];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        data.insert(data.end(), buffer, buffer + read);
+    fclose(file);
+    return data;
+}
+
+static bool writeFile(const char* filepath, const std::vector<uint8_t>& data) {
+    FILE* file = fopen(filepath, "wb");
+    if (!file) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && ok;
+}
+
+// Width and height from a PNG's IHDR chunk, big-endian at bytes 16 and 20
+static bool pngSize(const std::vector<uint8_t>& png, uint32_t& width,
+                    uint32_t& height) {
+    if (png.size() < 24 || memcmp(&png[12], "IHDR", 4) != 0) return false;
+    width = (uint32_t)png[16] << 24 | png[17] << 16 | png[18] << 8 | png[19];
+    height = (uint32_t)png[20] << 24 | png[21] << 16 | png[22] << 8 | png[23];
+    return true;
+}
+
+// Pixels that differ per texture and per byte, so a mix-up shows
+static std::vector<uint8_t> makePixels(size_t bytes, int seed) {
+    std::vector<uint8_t> pixels(bytes);
+    for (size_t i = 0; i < bytes; i++)
+        pixels[i] = static_cast<uint8_t>(i * 31 + seed * 101 + (i >> 12));
+    return pixels;
+}
+
+// Writes a damaged copy of the pack and opens it
+static PackStatus openBroken(std::vector<uint8_t> data, size_t offset,
+                             int byteDelta, size_t truncate,
+                             bool verify = true) {
+    if (offset < data.size()) data[offset] += byteDelta;
+    if (truncate > 0) data.resize(truncate);
+    writeFile(BROKEN_PATH, data);
+    AssetPack pack;
+    return pack.open(BROKEN_PATH, verify);
+}
+
+int main(int argc, char** argv) {
+    int runs = argc > 1 ? atoi(argv[1]) : 50;
+    bool ok = true;
+
+    AssetPackWriter writer;
+    std::vector<std::vector<uint8_t>> pixels;
+    size_t pngBytes = 0;
+    for (int i = 0; i < IMAGE_COUNT; i++) {
+        std::vector<uint8_t> png = readFile(IMAGES[i]);
+        uint32_t width, height;
+        if (!pngSize(png, width, height)) {
+            printf("pack_bench: can't read %s (run from Project-02)\n",
+                   IMAGES[i]);
+            return 1;
+        }
+        pngBytes += png.size();
+        pixels.push_back(makePixels((size_t)width * height * 4, i));
+        writer.add(IMAGES[i], width, height, 1, RGBA8, pixels[i].data(),
+                   pixels[i].size());
+    }
+    bool duplicate = writer.add(IMAGES[0], 1, 1, 1, RGBA8, "abcd", 4);
+    // The ball again as a region of the win strip, standing in for an atlas
+    bool region =
+        writer.addRegion("assets/region.png", IMAGES[2], 16, 8, 64, 32)
+        && !writer.addRegion("assets/outside.png", IMAGES[2], 4970, 0, 64, 1)
+        && !writer.addRegion("assets/nested.png", "assets/region.png", 0, 0,
+                             1, 1);
+    if (!writer.write(PACK_PATH, 0)) {
+        printf("pack_bench: can't write %s\n", PACK_PATH);
+        return 1;
+    }
+
+    // Everything reads back where it was put
+    AssetPack pack;
+    PackStatus status = pack.open(PACK_PATH);
+    bool same =
+        status == PACK_OK && pack.size() == IMAGE_COUNT + 1 && !duplicate;
+    for (int i = 0; same && i < IMAGE_COUNT; i++) {
+        const PackTexture* texture = pack.find(IMAGES[i]);
+        same = texture && texture->size == pixels[i].size()
+               && texture->offset % PACK_ALIGNMENT == 0
+               && memcmp(pack.getPixels(*texture), pixels[i].data(),
+                         pixels[i].size())
+                      == 0;
+        if (texture)
+            printf("  %-20s %5u x %-5u %9.1f KiB at %llu\n", IMAGES[i],
+                   texture->width, texture->height, texture->size / 1024.0,
+                   (unsigned long long)texture->offset);
+    }
+    same = same && pack.find("assets/missing.png") == nullptr;
+    const PackTexture* packedRegion = pack.find("assets/region.png");
+    region = region && packedRegion && packedRegion->size == 0
+             && &pack.get(packedRegion->atlas) == pack.find(IMAGES[2])
+             && packedRegion->x == 16 && packedRegion->y == 8
+             && packedRegion->width == 64 && packedRegion->height == 32;
+    printf("  atlas region: %s\n", region ? "OK" : "MISMATCH");
+    ok = ok && region;
+    printf("pack_bench: %d textures, %.1f KiB pack from %.1f KiB of PNG: "
+           "%s\n",
+           pack.size(), pack.getFileSize() / 1024.0, pngBytes / 1024.0,
+           same ? "OK" : "MISMATCH");
+    ok = ok && same;
+
+    // Damage is refused, not uploaded
+    std::vector<uint8_t> data = readFile(PACK_PATH);
+    PackStatus flipped = openBroken(data, data.size() / 2, 1, 0);
+    PackStatus version = openBroken(data, 7, 1, 0);
+    PackStatus magic = openBroken(data, 0, 1, 0);
+    PackStatus shortFile = openBroken(data, 0, 0, data.size() - 1);
+    AssetPack missing;
+    PackStatus absent = missing.open("pack_bench_absent.pack");
+    bool refused = flipped == PACK_BAD_CHECKSUM && version == PACK_BAD_VERSION
+                   && magic == PACK_BAD_MAGIC && shortFile == PACK_TRUNCATED
+                   && absent == PACK_MISSING;
+    printf("  flipped byte: %s, version: %s, magic: %s, short: %s, absent: "
+           "%s: %s\n",
+           AssetPack::describe(flipped), AssetPack::describe(version),
+           AssetPack::describe(magic), AssetPack::describe(shortFile),
+           AssetPack::describe(absent), refused ? "OK" : "ACCEPTED");
+    ok = ok && refused;
+
+    // Without the checksum, the directory alone has to stop an upload from
+    // reading past a texture or the file. The first texture's size field
+    // follows the 32 byte header, its name and 40 bytes of other fields
+    const size_t SIZE_FIELD = 32 + PACK_NAME_SIZE + 40;
+    PackStatus wrongSize = openBroken(data, SIZE_FIELD, 4, 0, false);
+    PackStatus pastEnd = openBroken(data, SIZE_FIELD + 5, 1, 0, false);
+    bool wrongFormat =
+        !writer.add("assets/odd.png", 4, 4, 1, RGBA8, "abcd", 4);
+    bool sized = wrongSize == PACK_BAD_SIZE && pastEnd == PACK_TRUNCATED
+              && wrongFormat;
+    printf("  unverified, wrong size: %s, past the end: %s: %s\n",
+           AssetPack::describe(wrongSize), AssetPack::describe(pastEnd),
+           sized ? "OK" : "ACCEPTED");
+    ok = ok && sized;
+    remove(BROKEN_PATH);
+
+    // An image edited after packing is stale; one with no file never is
+    std::vector<uint8_t> source(64, 1);
+    AssetPackWriter stamped;
+    writeFile(SOURCE_PATH, source);
+    stamped.add(SOURCE_PATH, 4, 4, 1, RGBA8, source.data(), source.size());
+    stamped.add("assets/generated.png", 4, 4, 1, RGBA8, source.data(),
+                source.size());
+    AssetPack stampedPack;
+    bool current = stamped.write(BROKEN_PATH, 0)
+                && stampedPack.open(BROKEN_PATH) == PACK_OK
+                && stampedPack.isCurrent(*stampedPack.find(SOURCE_PATH))
+                && pack.isCurrent(*pack.find(IMAGES[0]));
+    source.push_back(2);
+    writeFile(SOURCE_PATH, source);
+    bool stale = current
+              && !stampedPack.isCurrent(*stampedPack.find(SOURCE_PATH))
+              && stampedPack.isCurrent(
+                     *stampedPack.find("assets/generated.png"));
+    printf("  edited image: %s\n", stale ? "stale, OK" : "NOT NOTICED");
+    ok = ok && stale;
+    stampedPack.close();
+    remove(BROKEN_PATH);
+    remove(SOURCE_PATH);
+
+    // Startup, best of runs. The pixels end up readable either way
+    double filesBest = 1e9, packBest = 1e9, trustedBest = 1e9;
+    uint64_t sink = 0;
+    for (int run = 0; run < runs; run++) {
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < IMAGE_COUNT; i++)
+            sink += readFile(IMAGES[i]).size();
+        filesBest = std::min(filesBest, secondsSince(start));
+        start = Clock::now();
+        pack.open(PACK_PATH);
+        packBest = std::min(packBest, secondsSince(start));
+        start = Clock::now();
+        pack.open(PACK_PATH, false);
+        // Touch a byte a page, as the upload would
+        for (int i = 0; i < pack.size(); i++) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(
+                pack.getPixels(pack.get(i)));
+            for (uint64_t b = 0; b < pack.get(i).size; b += 4096)
+                sink += bytes[b];
+        }
+        trustedBest = std::min(trustedBest, secondsSince(start));
+    }
+    printf("  read PNG files (no inflate) %8.3f ms\n", filesBest * 1000.0);
+    printf("  map pack + checksum         %8.3f ms\n", packBest * 1000.0);
+    printf("  map pack, touch pages       %8.3f ms (%llu)\n",
+           trustedBest * 1000.0, (unsigned long long)(sink & 0xFF));
+    pack.close();
+    remove(PACK_PATH);
+
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
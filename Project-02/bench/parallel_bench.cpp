@@ -0,0 +1,54 @@
+// Multithreaded BallPool::update() scaling: same balls and seed on 1..N
+// threads, checking every thread count ends in exactly the serial state.
+// Usage: ./parallel_bench [ticks=200] [maxThreads=hardware_concurrency]
+
+#include "../CS3113/Simulation.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Runs `ticks` AI vs AI ticks and returns the wall time in seconds
+static double runTicks(Simulation& sim, int ticks) {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < ticks; i++) sim.step();
+    return secondsSince(start);
+}
+
+int main(int argc, char** argv) {
+    int ticks = argc > 1 ? atoi(argv[1]) : 200;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : WorkerPool::defaultThreads();
+    const int counts[] = {10000, 100000, 1000000};
+    bool allMatch = true;
+
+    printf("parallel_bench: %d ticks, up to %d threads\n", ticks, maxThreads);
+    printf("  %8s %8s %12s %10s %8s\n", "balls", "threads", "ns/ball",
+           "speedup", "match");
+    for (int count : counts) {
+        int countTicks = count >= 1000000 ? ticks / 10 : ticks;
+        Simulation serial;
+        serial.setBallCount(count);
+        serial.setAI(LEFT_PADDLE, true);
+        serial.setAI(RIGHT_PADDLE, true);
+        double serialSeconds = runTicks(serial, countTicks);
+        double updates = (double)countTicks * count;
+        printf("  %8d %8s %12.2f %10s %8s\n", count, "serial",
+               serialSeconds * 1e9 / updates, "1.00x", "-");
+
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            WorkerPool workers(threads);
+            Simulation sim;
+            sim.setWorkerPool(&workers);
+            sim.setBallCount(count);
+            sim.setAI(LEFT_PADDLE, true);
+            sim.setAI(RIGHT_PADDLE, true);
+            double seconds = runTicks(sim, countTicks);
+            bool match = sameState(serial, sim);
+            allMatch = allMatch && match;
+            printf("  %8d %8d %12.2f %9.2fx %8s\n", count, threads,
+                   seconds * 1e9 / updates, serialSeconds / seconds,
+                   match ? "yes" : "NO");
+        }
+    }
+
+    return allMatch ? 0 : 1;
+}
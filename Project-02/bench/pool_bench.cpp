@@ -0,0 +1,126 @@
+// Mode switch cost with the ball pool allocated up front. Cycles the game's
+// ball counts on a Simulation, counting every operator new and timing each
+// switch, then churns handles with activate()/deactivate(). Fails if anything
+// allocates after the pool is reserved or a handle loses its ball.
+// Usage: ./pool_bench [switches=2000]
+
+#include "../CS3113/Simulation.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned long long gAllocations = 0;
+
+void* operator new(size_t size) {
+    gAllocations++;
+    void* memory = malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept { free(memory); }
+
+int main(int argc, char** argv) {
+    int switches = argc > 1 ? atoi(argv[1]) : 2000;
+    const int modes[] = {1, 2, 3, 67, BALL_POOL_CAPACITY};
+    const int MODE_COUNT = sizeof(modes) / sizeof(modes[0]);
+    bool ok = true;
+
+    printf("pool_bench: %d switches over 1/2/3/67/%d balls\n", switches,
+           BALL_POOL_CAPACITY);
+
+    // First switch to the biggest mode: an empty pool has to grow into it
+    {
+        BallPool cold;
+        Rng rng;
+        unsigned long long before = gAllocations;
+        Clock::time_point start = Clock::now();
+        cold.resize(BALL_POOL_CAPACITY);
+        cold.resetAll(rng);
+        double seconds = secondsSince(start);
+        printf("  unreserved first switch: %8.1f us, %llu allocs\n",
+               seconds * 1e6, gAllocations - before);
+
+        BallPool warm(BALL_SIZE / 2.0f, BALL_POOL_CAPACITY);
+        before = gAllocations;
+        start = Clock::now();
+        warm.resize(BALL_POOL_CAPACITY);
+        warm.resetAll(rng);
+        seconds = secondsSince(start);
+        printf("  reserved first switch:   %8.1f us, %llu allocs\n",
+               seconds * 1e6, gAllocations - before);
+        ok = ok && gAllocations == before;
+    }
+
+    // Every mode switch the game can make, with a few ticks in between
+    Simulation simulation;
+    std::vector<double> times[MODE_COUNT];
+    for (std::vector<double>& modeTimes : times) modeTimes.reserve(switches);
+    unsigned long long before = gAllocations;
+    for (int i = 0; i < switches; i++) {
+        int mode = (i * 7 + i / MODE_COUNT) % MODE_COUNT; // Every pairing
+        Clock::time_point start = Clock::now();
+        simulation.setBallCount(modes[mode]);
+        times[mode].push_back(secondsSince(start));
+        for (int tick = 0; tick < 3; tick++) simulation.step(0);
+    }
+    unsigned long long switchAllocations = gAllocations - before;
+    ok = ok && switchAllocations == 0;
+
+    printf("  %8s %8s %12s %12s\n", "balls", "switches", "p50 us", "max us");
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        std::vector<double>& modeTimes = times[mode];
+        std::sort(modeTimes.begin(), modeTimes.end());
+        printf("  %8d %8d %12.2f %12.2f\n", modes[mode],
+               static_cast<int>(modeTimes.size()),
+               modeTimes[modeTimes.size() / 2] * 1e6,
+               modeTimes.back() * 1e6);
+    }
+    printf("  allocations while switching: %llu\n", switchAllocations);
+
+    // Random activate()/deactivate() churn; each ball remembers its handle in
+    // its x position, so a slot mixup shows up as a mismatch
+    BallPool pool(BALL_SIZE / 2.0f, BALL_POOL_CAPACITY);
+    std::vector<BallHandle> live;
+    live.reserve(BALL_POOL_CAPACITY);
+    Rng rng(1234);
+    const int CHURN = 1000000;
+    bool consistent = true;
+    before = gAllocations;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < CHURN; i++) {
+        bool add = live.empty()
+                   || (static_cast<int>(live.size()) < BALL_POOL_CAPACITY
+                       && rng.next() % 2);
+        if (add) {
+            BallHandle handle = pool.activate();
+            BallState state = pool.get(pool.indexOf(handle));
+            state.position.x = static_cast<float>(handle);
+            pool.set(pool.indexOf(handle), state);
+            live.push_back(handle);
+        } else {
+            int pick = static_cast<int>(rng.next() % live.size());
+            pool.deactivate(live[pick]);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+    }
+    double churnSeconds = secondsSince(start);
+    unsigned long long churnAllocations = gAllocations - before;
+    for (BallHandle handle : live) {
+        int index = pool.indexOf(handle);
+        consistent = consistent && index >= 0 && index < pool.size()
+                     && pool.getPositionsX()[index] == handle;
+    }
+    consistent = consistent && pool.size() == static_cast<int>(live.size());
+    printf("  churn: %d ops, %.1f ns/op, %llu allocs, %d growths, %s\n",
+           CHURN, churnSeconds * 1e9 / CHURN, churnAllocations,
+           pool.getGrowthCount(), consistent ? "handles OK" : "MISMATCH");
+    ok = ok && consistent && churnAllocations == 0
+         && pool.getGrowthCount() == 0;
+
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
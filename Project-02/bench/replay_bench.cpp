@@ -0,0 +1,158 @@
+// Replay round trip and playback speed. Records a scripted session (held
+// inputs, ball count changes, collisions, resets), plays the log back into a
+// fresh Simulation, checks both end in the same state and times playback.
+// Usage: ./replay_bench [ticks=200000] [log=replay_bench.rpl]
+//        ./replay_bench --play <log>   (time an existing recording)
+
+#include "../CS3113/Replay.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Runs a command on the live Simulation and logs it, like main.cpp does
+static void command(Simulation& sim, ReplayWriter& writer,
+                    ReplayEventType type, uint32_t value) {
+    ReplayEvent event = {type, value};
+    writer.event(event);
+    applyReplayEvent(sim, event);
+}
+
+static int play(const char* path) {
+    ReplayReader reader;
+    if (!reader.open(path)) {
+        printf("replay_bench: can't read %s\n", path);
+        return 1;
+    }
+    Simulation sim(reader.getSeed(), static_cast<float>(reader.getTickRate()));
+    Clock::time_point start = Clock::now();
+    uint64_t ticks = playReplay(reader, sim);
+    double seconds = secondsSince(start);
+    printf("replay_bench: %s, seed %u, %u Hz\n", path, reader.getSeed(),
+           reader.getTickRate());
+    printf("  ticks            %llu (%.1f s of play)\n",
+           (unsigned long long)ticks, ticks * sim.getDeltaTime());
+    printf("  final score      %d - %d\n", sim.getLeftScore(),
+           sim.getRightScore());
+    printf("  ticks/sec        %.0f\n", ticks / seconds);
+    return 0;
+}
+
+// Records 100 ticks, one item a writer never produces, then 100 more ticks.
+// Playback must stop at the bad item rather than apply it
+static bool stopsAtCorruption(const char* path,
+                              void (*corrupt)(ReplayWriter&)) {
+    ReplayWriter writer;
+    if (!writer.open(path, 67, SIM_TICK_RATE)) return false;
+    for (int tick = 0; tick < 100; tick++) writer.tick(0);
+    corrupt(writer);
+    for (int tick = 0; tick < 100; tick++) writer.tick(INPUT_LEFT_UP);
+    writer.close();
+    ReplayReader reader;
+    if (!reader.open(path)) return false;
+    Simulation sim(reader.getSeed(), static_cast<float>(reader.getTickRate()));
+    uint64_t played = playReplay(reader, sim);
+    remove(path);
+    return played == 100 && sim.getBalls().size() == 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && strcmp(argv[1], "--play") == 0) return play(argv[2]);
+    int ticks = argc > 1 ? atoi(argv[1]) : 200000;
+    const char* path = argc > 2 ? argv[2] : "replay_bench.rpl";
+    const uint32_t seed = 67;
+    const uint32_t tickRate = SIM_TICK_RATE;
+    const uint32_t ballCounts[] = {1, 2, 3, 67};
+
+    // Record: inputs held for a random number of ticks, a command now and then
+    Simulation live(seed, static_cast<float>(tickRate));
+    ReplayWriter writer;
+    if (!writer.open(path, seed, tickRate)) {
+        printf("replay_bench: can't write %s\n", path);
+        return 1;
+    }
+    command(live, writer, REPLAY_BALL_COUNT, 1);
+    Rng script(1234);
+    uint8_t input = 0;
+    int held = 0;
+    Clock::time_point start = Clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        if (held-- <= 0) {
+            input = static_cast<uint8_t>(script.range(0, 15));
+            held = script.range(10, 240);
+        }
+        if (tick % 20000 == 19999) {
+            int roll = script.range(0, 9);
+            if (roll < 5)
+                command(live, writer, REPLAY_BALL_COUNT,
+                        ballCounts[script.range(0, 3)]);
+            else if (roll < 7)
+                command(live, writer, REPLAY_BALL_COLLISIONS, roll == 5);
+            else if (roll < 9)
+                command(live, writer, REPLAY_SINGLE_PLAYER, roll == 7);
+            else
+                command(live, writer, REPLAY_RESET, 0);
+        }
+        writer.tick(input);
+        live.step(input);
+    }
+    double recordSeconds = secondsSince(start);
+    writer.close();
+
+    FILE* file = fopen(path, "rb");
+    long bytes = 0;
+    if (file) {
+        fseek(file, 0, SEEK_END);
+        bytes = ftell(file);
+        fclose(file);
+    }
+
+    // Play back into a fresh Simulation built from the header
+    ReplayReader reader;
+    if (!reader.open(path)) {
+        printf("replay_bench: can't read %s\n", path);
+        return 1;
+    }
+    Simulation replayed(reader.getSeed(),
+                        static_cast<float>(reader.getTickRate()));
+    start = Clock::now();
+    uint64_t played = playReplay(reader, replayed);
+    double playSeconds = secondsSince(start);
+    bool match = sameState(live, replayed);
+
+    printf("replay_bench: %d ticks, seed %u, %u Hz\n", ticks, seed, tickRate);
+    printf("  log size         %ld bytes (%.3f bytes/tick)\n", bytes,
+           (double)bytes / ticks);
+    printf("  recorded         %.0f ticks/sec (%d - %d)\n",
+           ticks / recordSeconds, live.getLeftScore(), live.getRightScore());
+    printf("  played back      %.0f ticks/sec (%d - %d)\n",
+           played / playSeconds, replayed.getLeftScore(),
+           replayed.getRightScore());
+    printf("  state matches    %s\n", match ? "yes" : "NO");
+    remove(path);
+
+    // A corrupt log just ends early
+    bool stops =
+        stopsAtCorruption(path,
+                          [](ReplayWriter& w) {
+                              w.event({REPLAY_BALL_COUNT, 0x80000000u});
+                          })
+        && stopsAtCorruption(path,
+                             [](ReplayWriter& w) {
+                                 w.event({REPLAY_BALL_COUNT, 0});
+                             })
+        && stopsAtCorruption(path,
+                             [](ReplayWriter& w) {
+                                 w.event({REPLAY_BALL_COUNT,
+                                          BALL_POOL_CAPACITY + 1});
+                             })
+        && stopsAtCorruption(path,
+                             [](ReplayWriter& w) {
+                                 w.event({static_cast<ReplayEventType>(5),
+                                          0});
+                             })
+        && stopsAtCorruption(path, [](ReplayWriter& w) { w.tick(0x10); });
+    printf("  corrupt logs end %s\n", stops ? "early" : "WRONGLY");
+
+    return match && stops ? 0 : 1;
+}
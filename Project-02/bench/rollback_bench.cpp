@@ -0,0 +1,147 @@
+// Rollback netcode over real localhost UDP sockets with simulated latency,
+// jitter and loss. First times Simulation snapshots, then plays a scripted
+// match between two peers in this process under each network condition and
+// fails unless both peers end in exactly the state of a local Simulation fed
+// both players' inputs directly.
+// Usage: ./rollback_bench [seconds=60] [balls=3] [port=47670]
+
+#include "../CS3113/Rollback.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Condition {
+    float latency, jitter, loss;
+};
+
+// Microseconds to save and to load a snapshot at a few ball counts
+static void timeSnapshots() {
+    printf("%8s %10s %10s %10s\n", "balls", "bytes", "save us", "load us");
+    const int counts[] = {1, 67, 1000, 10000};
+    for (int balls : counts) {
+        Simulation simulation;
+        simulation.setBallCount(balls);
+        SimSnapshot snapshot;
+        simulation.save(snapshot); // Sizes the buffer once, like the ring
+        const int repeats = 2000;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < repeats; i++) simulation.save(snapshot);
+        double save = secondsSince(start) / repeats;
+        start = Clock::now();
+        for (int i = 0; i < repeats; i++) simulation.load(snapshot);
+        double load = secondsSince(start) / repeats;
+        printf("%8d %10zu %10.2f %10.2f\n", balls, snapshot.balls.size(),
+               save * 1e6, load * 1e6);
+    }
+}
+
+// Each player holds up, down or nothing for a random stretch of ticks
+static std::vector<uint8_t> scriptInputs(int ticks, int side, uint32_t seed) {
+    Rng rng(seed);
+    std::vector<uint8_t> inputs(ticks);
+    uint8_t up = side == LEFT_PADDLE ? INPUT_LEFT_UP : INPUT_RIGHT_UP;
+    uint8_t down = side == LEFT_PADDLE ? INPUT_LEFT_DOWN : INPUT_RIGHT_DOWN;
+    uint8_t held = 0;
+    for (int tick = 0; tick < ticks; tick++) {
+        if (rng.range(0, 29) == 0) {
+            int choice = rng.range(0, 2);
+            held = choice == 0 ? 0 : choice == 1 ? up : down;
+        }
+        inputs[tick] = held;
+    }
+    return inputs;
+}
+
+static bool playMatch(const Condition& condition, int ticks, int balls,
+                      uint16_t port) {
+    NetTransport transports[2];
+    if (!transports[0].open(port, port + 1)
+        || !transports[1].open(port + 1, port)) {
+        printf("can't open UDP ports %d and %d, skipped\n", port, port + 1);
+        return true;
+    }
+    Simulation simulations[2], reference;
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+        transports[side].setConditions(condition.latency, condition.jitter,
+                                       condition.loss, 100 + side);
+        simulations[side].setBallCount(balls);
+    }
+    reference.setBallCount(balls);
+    RollbackSession left(simulations[LEFT_PADDLE], transports[LEFT_PADDLE],
+                         LEFT_PADDLE);
+    RollbackSession right(simulations[RIGHT_PADDLE],
+                          transports[RIGHT_PADDLE], RIGHT_PADDLE);
+    RollbackSession* sessions[2] = {&left, &right};
+    std::vector<uint8_t> inputs[2] = {scriptInputs(ticks, LEFT_PADDLE, 1),
+                                      scriptInputs(ticks, RIGHT_PADDLE, 2)};
+    for (int tick = 0; tick < ticks; tick++)
+        reference.step(inputs[LEFT_PADDLE][tick] | inputs[RIGHT_PADDLE][tick]);
+
+    // One frame per tick of simulated time; a stalled peer just waits
+    double deltaTime = reference.getDeltaTime();
+    Clock::time_point start = Clock::now();
+    long long frame = 0;
+    const long long maxFrames = ticks * 4LL + 10 * SIM_TICK_RATE;
+    for (; frame < maxFrames; frame++) {
+        double now = frame * deltaTime;
+        bool done = true;
+        for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+            RollbackSession& session = *sessions[side];
+            if (session.getTick() < (uint64_t)ticks)
+                session.advance(inputs[side][session.getTick()], now);
+            else
+                session.poll(now); // Finished: wait for the last inputs
+            done = done && session.getTick() == (uint64_t)ticks
+                && session.isSynchronized();
+        }
+        if (done) break;
+    }
+    double wall = secondsSince(start);
+
+    bool same = sameState(simulations[LEFT_PADDLE], reference)
+             && sameState(simulations[RIGHT_PADDLE], reference);
+    const RollbackStats& stats = left.getStats();
+    double seconds = ticks * deltaTime;
+    double avgDepth =
+        stats.rollbacks ? (double)stats.resimulatedTicks / stats.rollbacks : 0;
+    double rollbackUs = stats.rollbacks ?
+                            (stats.loadSeconds + stats.resimulateSeconds)
+                                * 1e6 / stats.rollbacks :
+                            0;
+    printf("%5.0f ms %4.0f ms %4.0f%% %8.1f %6.1f %5d %7.1f%% %8.1f %7.2f "
+           "%6llu %6llu %7.0fx %s\n",
+           condition.latency * 1000, condition.jitter * 1000,
+           condition.loss * 100, stats.rollbacks / seconds, avgDepth,
+           stats.maxDepth, 100.0 * stats.resimulatedTicks / ticks, rollbackUs,
+           stats.saveSeconds * 1e6 / (ticks + stats.resimulatedTicks),
+           (unsigned long long)stats.stalls,
+           (unsigned long long)transports[LEFT_PADDLE].getStats()
+               .packetsDropped,
+           seconds / wall, same ? "OK" : "MISMATCH");
+    return same;
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 60.0;
+    int balls = argc > 2 ? atoi(argv[2]) : 3;
+    int port = argc > 3 ? atoi(argv[3]) : 47670;
+    int ticks = static_cast<int>(seconds * SIM_TICK_RATE);
+    timeSnapshots();
+
+    const Condition conditions[] = {{0.0f, 0.0f, 0.0f},
+                                    {0.025f, 0.0f, 0.0f},
+                                    {0.05f, 0.01f, 0.02f},
+                                    {0.1f, 0.02f, 0.05f},
+                                    {0.15f, 0.03f, 0.1f},
+                                    {0.3f, 0.0f, 0.05f}};
+    printf("\n%8s %7s %5s %8s %6s %5s %8s %8s %7s %6s %6s %8s\n", "latency",
+           "jitter", "loss", "rb/s", "depth", "max", "resim", "rb us",
+           "save us", "stalls", "lost", "realtime");
+    bool ok = true;
+    for (const Condition& condition : conditions) {
+        ok = playMatch(condition, ticks, balls, static_cast<uint16_t>(port))
+          && ok;
+        port += 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+// Headless physics throughput benchmark: AI vs AI with no window or GPU.
+// Usage: ./sim_bench [rallies=1000000] [balls=67] [seed=67]
+
+#include "../CS3113/Simulation.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+    uint64_t targetRallies =
+        argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    int ballCount = argc > 2 ? atoi(argv[2]) : 67;
+    uint32_t seed = argc > 3 ? (uint32_t)strtoul(argv[3], nullptr, 10) : 67;
+
+    Simulation sim(seed);
+    sim.setBallCount(ballCount);
+    sim.setAI(LEFT_PADDLE, true);
+    sim.setAI(RIGHT_PADDLE, true);
+
+    // Full game ticks: AI, balls, paddles and scoring
+    Clock::time_point start = Clock::now();
+    while (sim.getRallies() < targetRallies) sim.step();
+    double seconds = secondsSince(start);
+    uint64_t ballUpdates = sim.getTick() * (uint64_t)ballCount;
+
+    printf("sim_bench: %d balls, %.0f Hz, seed %u\n", ballCount,
+           1.0f / sim.getDeltaTime(), seed);
+    printf("  rallies          %llu (%d - %d)\n",
+           (unsigned long long)sim.getRallies(), sim.getLeftScore(),
+           sim.getRightScore());
+    printf("  ticks            %llu (%.1f simulated hours)\n",
+           (unsigned long long)sim.getTick(),
+           sim.getTick() * sim.getDeltaTime() / 3600.0);
+    printf("  wall time        %.3f s\n", seconds);
+    printf("  rallies/sec      %.0f\n", sim.getRallies() / seconds);
+    printf("  ns/tick          %.1f\n", seconds * 1e9 / sim.getTick());
+    printf("  ns/ball update   %.2f (whole tick, amortised)\n",
+           seconds * 1e9 / ballUpdates);
+
+    // stepBall() alone, the work Ball::update() delegates to
+    std::vector<BallState> balls;
+    for (int i = 0; i < ballCount; i++) balls.push_back(sim.getBalls().get(i));
+    PaddleState paddles[2] = {sim.getPaddle(LEFT_PADDLE),
+                              sim.getPaddle(RIGHT_PADDLE)};
+    Rng rng(seed);
+    const uint64_t steps = 20000000;
+    int scored = 0;
+    start = Clock::now();
+    for (uint64_t i = 0; i < steps; i++) {
+        BallState& ball = balls[i % balls.size()];
+        if (stepBall(ball, paddles, sim.getDeltaTime()) != NO_PADDLE) {
+            resetBall(ball, rng);
+            scored++;
+        }
+    }
+    seconds = secondsSince(start);
+    printf("  ns/ball update   %.2f (stepBall only, %d points)\n",
+           seconds * 1e9 / steps, scored);
+    return 0;
+}
@@ -0,0 +1,129 @@
+// The simulation thread under a stalling renderer. A headless render loop
+// runs at FPS and stalls for STALL_MS every STALL_EVERY frames, changing the
+// input now and then. Ticking on the render thread, the way update() does,
+// makes every tick in a stall late; on the SimThread they stay on schedule.
+// Checks the frames the render loop sees never go backwards, the thread kept
+// its tick rate through the stalls, and a fetch never waits.
+// Usage: ./simthread_bench [frames=360] [balls=67]
+
+#include "../CS3113/SimThread.h"
+#include "BenchUtil.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+static const int STALL_EVERY = 30; // Frames
+static const double STALL_MS = 50.0;
+
+// Sleeps until the given SimThread::now() time
+static void sleepUntil(double time) {
+    double wait = time - SimThread::now();
+    if (wait > 0.0)
+        std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+}
+
+// Frame's work plus the occasional stall
+static void renderFrame(int frame, double frameStart) {
+    double end = frameStart + 1.0 / FPS;
+    if (frame % STALL_EVERY == STALL_EVERY - 1) end += STALL_MS / 1000.0;
+    sleepUntil(end);
+}
+
+// Input that changes every 10 frames, like a player tapping up and down
+static uint8_t inputFor(int frame) {
+    static const uint8_t INPUTS[] = {INPUT_LEFT_UP, 0, INPUT_LEFT_DOWN, 0};
+    return INPUTS[frame / 10 % 4];
+}
+
+static void printRing(const char* name, LatencyRing& ring) {
+    printf("  %-22s p50 %7.3f  p99 %7.3f  max %7.3f ms (%d)\n", name,
+           ring.getPercentile(50.0f), ring.getPercentile(99.0f),
+           ring.getMaximum(), ring.getCount());
+}
+
+// Ticks on the render thread, as update() does: after each frame, every
+// tick that's due, dropping any backlog past MAX_TICK_BACKLOG
+static void runInline(int frames, int balls, LatencyRing& lateness) {
+    Simulation sim(67, SIM_TICK_RATE);
+    sim.setBallCount(balls);
+    sim.setAI(RIGHT_PADDLE, true);
+    const double tickTime = sim.getDeltaTime();
+    double due = SimThread::now();
+    for (int frame = 0; frame < frames; frame++) {
+        double frameStart = SimThread::now();
+        if (frameStart - due > MAX_TICK_BACKLOG)
+            due = frameStart - MAX_TICK_BACKLOG;
+        while (SimThread::now() >= due) {
+            lateness.add(
+                static_cast<float>((SimThread::now() - due) * 1000.0));
+            sim.step(inputFor(frame));
+            due += tickTime;
+        }
+        renderFrame(frame, frameStart);
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 360;
+    int balls = argc > 2 ? atoi(argv[2]) : 67;
+    bool ok = true;
+
+    printf("simthread_bench: %d frames at %d Hz, %d Hz ticks, %d balls, "
+           "%.0f ms stall every %d frames\n",
+           frames, FPS, SIM_TICK_RATE, balls, STALL_MS, STALL_EVERY);
+    LatencyRing inlineLateness;
+    runInline(frames, balls, inlineLateness);
+
+    Simulation sim(67, SIM_TICK_RATE);
+    sim.setBallCount(balls);
+    sim.setAI(RIGHT_PADDLE, true);
+    SimThread thread(sim);
+    thread.start();
+    thread.setPaused(false);
+    double start = SimThread::now();
+    uint64_t lastTick = 0;
+    int backwards = 0;
+    double slowestFetch = 0.0;
+    for (int frame = 0; frame < frames; frame++) {
+        double frameStart = SimThread::now();
+        thread.setInput(inputFor(frame), frameStart);
+        Clock::time_point fetchStart = Clock::now();
+        thread.fetchFrame();
+        double fetch =
+            std::chrono::duration<double>(Clock::now() - fetchStart).count();
+        if (fetch > slowestFetch) slowestFetch = fetch;
+        const FrameState& state = thread.getFrame();
+        if (state.tick < lastTick) backwards++;
+        lastTick = state.tick;
+        renderFrame(frame, frameStart);
+    }
+    thread.stop();
+    double seconds = SimThread::now() - start;
+
+    printf("  ticking on the render thread\n");
+    printRing("tick lateness", inlineLateness);
+    printf("  ticking on the SimThread\n");
+    printRing("tick lateness", thread.getTickLateness());
+    printRing("input to tick", thread.getInputLatency());
+
+    double expected = seconds * SIM_TICK_RATE;
+    double ratio = sim.getTick() / expected;
+    bool onRate = ratio > 0.9 && ratio < 1.1;
+    printf("  %llu ticks in %.2f s (%.1f%% of %d Hz), %llu dropped: %s\n",
+           (unsigned long long)sim.getTick(), seconds, ratio * 100.0,
+           SIM_TICK_RATE, (unsigned long long)thread.getDroppedTicks(),
+           onRate ? "OK" : "OFF RATE");
+    ok = ok && onRate;
+    printf("  frames seen in order: %s\n",
+           backwards == 0 && lastTick > 0 ? "OK" : "WENT BACKWARDS");
+    ok = ok && backwards == 0 && lastTick > 0;
+    // A fetch is one atomic exchange; anything near a tick means it waited
+    bool nonBlocking = slowestFetch < 0.5 / SIM_TICK_RATE;
+    printf("  slowest fetch %.2f us: %s\n", slowestFetch * 1e6,
+           nonBlocking ? "OK" : "BLOCKED");
+    ok = ok && nonBlocking;
+
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
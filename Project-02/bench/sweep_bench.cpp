@@ -0,0 +1,113 @@
+// Batched slab test benchmark: sweepBatch() against one sweepCollision() call
+// per ball per paddle, plus a bit-for-bit comparison of the two.
+// Usage: ./sweep_bench [balls=4096]
+
+#include "../CS3113/SweepKernel.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static bool sameBits(float a, float b) {
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 4096;
+    const float deltaTime = 1.0f / FPS;
+    const float radius = BALL_SIZE / 2.0f;
+    Rng rng(67);
+
+    // Moving paddles, and balls scattered around them so plenty of lanes hit
+    PaddleState paddles[2] = {makePaddle(LEFT_PADDLE),
+                              makePaddle(RIGHT_PADDLE)};
+    paddles[LEFT_PADDLE].movement = {0.0f, -1.0f};
+    std::vector<float> posX(count), posY(count), moveX(count), moveY(count),
+        speed(count);
+    for (int i = 0; i < count; i++) {
+        int side = i % 2;
+        posX[i] = paddles[side].position.x + rng.range(-60, 60);
+        posY[i] = paddles[side].position.y + rng.range(-80, 80);
+        BallState ball;
+        ball.baseSpeed = BALL_FAST_SPEED * rng.range(1, 40);
+        resetBall(ball, rng);
+        if (i % 16 == 0) ball.movement = {0.0f, 0.0f}; // Still ball early out
+        if (i % 16 == 1) ball.movement.y = 0.0f;       // Still on one axis
+        moveX[i] = ball.movement.x;
+        moveY[i] = ball.movement.y;
+        speed[i] = ball.speed;
+    }
+
+    std::vector<float> batchT(count), batchX(count), batchY(count);
+    std::vector<float> scalarT(count), scalarX(count), scalarY(count);
+    const int repeats = 20000000 / count + 1;
+    double checksum = 0.0;
+
+    // Scalar: sweepCollision() once per ball per paddle
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < repeats; r++) {
+        for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+            for (int i = 0; i < count; i++) {
+                BallState ball;
+                ball.position = {posX[i], posY[i]};
+                ball.movement = {moveX[i], moveY[i]};
+                ball.speed = speed[i];
+                ball.radius = radius;
+                Vec2 normal = {0.0f, 0.0f};
+                scalarT[i] =
+                    sweepCollision(ball, paddles[side], normal, deltaTime);
+                scalarX[i] = normal.x;
+                scalarY[i] = normal.y;
+            }
+            checksum += scalarT[r % count];
+        }
+    }
+    double scalarSeconds = secondsSince(start);
+
+    // Batched: sweepBatch() per paddle
+    start = Clock::now();
+    for (int r = 0; r < repeats; r++) {
+        for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+            sweepBatch(posX.data(), posY.data(), moveX.data(), moveY.data(),
+                       speed.data(), radius, count, paddles[side], deltaTime,
+                       batchT.data(), batchX.data(), batchY.data());
+            checksum += batchT[r % count];
+        }
+    }
+    double batchSeconds = secondsSince(start);
+
+    // Compare both paths against each paddle
+    int hits = 0, mismatches = 0;
+    for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+        sweepBatch(posX.data(), posY.data(), moveX.data(), moveY.data(),
+                   speed.data(), radius, count, paddles[side], deltaTime,
+                   batchT.data(), batchX.data(), batchY.data());
+        for (int i = 0; i < count; i++) {
+            BallState ball;
+            ball.position = {posX[i], posY[i]};
+            ball.movement = {moveX[i], moveY[i]};
+            ball.speed = speed[i];
+            ball.radius = radius;
+            Vec2 normal = {0.0f, 0.0f};
+            float t = sweepCollision(ball, paddles[side], normal, deltaTime);
+            bool hit = t >= 0.0f;
+            hits += hit;
+            if (!sameBits(t, batchT[i])
+                || (hit
+                    && (!sameBits(normal.x, batchX[i])
+                        || !sameBits(normal.y, batchY[i]))))
+                mismatches++;
+        }
+    }
+
+    double sweeps = 2.0 * repeats * count;
+    printf("sweep_bench: %d balls, %d lanes, %d/%d sweeps hit (checksum %g)\n",
+           count, sweepLanes(), hits, 2 * count, checksum);
+    printf("  scalar sweepCollision  %8.1f M balls/sec\n",
+           sweeps / scalarSeconds / 1e6);
+    printf("  batched sweepBatch     %8.1f M balls/sec (%.2fx)\n",
+           sweeps / batchSeconds / 1e6, scalarSeconds / batchSeconds);
+    printf("  mismatches             %8d\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+// Cost and correctness of the collision telemetry. Runs the same seeded
+// AI vs AI game with telemetry off and on, which must end identically, then
+// checks that the batched sweep counts the same outcomes as sweepCollision()
+// and that the Prometheus file has the totals in it.
+// Usage: ./telemetry_bench [ticks=200000] [balls=67]
+
+#include "../CS3113/Simulation.h"
+#include "../CS3113/SweepKernel.h"
+#include "../CS3113/Telemetry.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const COUNTER_NAMES[TM_COUNT] = {
+    "hits left",        "hits right",     "clamped entries", "depen in",
+    "depen overlap",    "still early outs", "extra contacts",
+    "contact caps"};
+
+// Plays ticks of the seeded game, returning wall time and the final score
+static double play(uint64_t ticks, int balls, int scores[2]) {
+    Simulation sim(67);
+    sim.setBallCount(balls);
+    sim.setAI(LEFT_PADDLE, true);
+    sim.setAI(RIGHT_PADDLE, true);
+    Clock::time_point start = Clock::now();
+    for (uint64_t tick = 0; tick < ticks; tick++) {
+        sim.step();
+        Telemetry::endFrame();
+    }
+    double seconds = secondsSince(start);
+    scores[LEFT_PADDLE] = sim.getLeftScore();
+    scores[RIGHT_PADDLE] = sim.getRightScore();
+    return seconds;
+}
+
+int main(int argc, char** argv) {
+    uint64_t ticks = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200000;
+    int balls = argc > 2 ? atoi(argv[2]) : 67;
+    bool ok = true;
+
+    printf("telemetry_bench: %llu ticks, %d balls, %d sweep lanes\n",
+           (unsigned long long)ticks, balls, sweepLanes());
+    int offScores[2], onScores[2];
+    double offSeconds = play(ticks, balls, offScores);
+    uint64_t offTotal = 0;
+    for (int counter = 0; counter < TM_COUNT; counter++)
+        offTotal += Telemetry::getTotal(static_cast<TelemetryCounter>(counter));
+    Telemetry::setEnabled(true);
+    double onSeconds = play(ticks, balls, onScores);
+    bool same = offScores[0] == onScores[0] && offScores[1] == onScores[1];
+    printf("  off  %8.1f ns/tick, score %d - %d, %llu counted\n",
+           offSeconds * 1e9 / ticks, offScores[0], offScores[1],
+           (unsigned long long)offTotal);
+    printf("  on   %8.1f ns/tick, score %d - %d (%+.1f%%)\n",
+           onSeconds * 1e9 / ticks, onScores[0], onScores[1],
+           (onSeconds / offSeconds - 1.0) * 100.0);
+    for (int counter = 0; counter < TM_COUNT; counter++)
+        printf("    %-18s %12llu\n", COUNTER_NAMES[counter],
+               (unsigned long long)Telemetry::getTotal(
+                   static_cast<TelemetryCounter>(counter)));
+    bool counted = Telemetry::getTotal(TM_HIT_LEFT) > 0
+                   && Telemetry::getTotal(TM_HIT_RIGHT) > 0;
+    printf("  %s\n", same && offTotal == 0 && counted ?
+                         "same result, nothing counted while off: OK" :
+                         "MISMATCH");
+    ok = ok && same && offTotal == 0 && counted;
+
+    // Batched vs scalar sweeps over random balls, some starting inside the
+    // paddle and some nearly still, must count the same outcomes
+    const int COUNT = 4099; // Not a multiple of any lane width
+    std::vector<float> posX(COUNT), posY(COUNT), moveX(COUNT), moveY(COUNT),
+        speed(COUNT), outTime(COUNT), outNormalX(COUNT), outNormalY(COUNT);
+    PaddleState paddle = {{PADDLE_MARGIN, SCREEN_HEIGHT / 2},
+                          {0.0f, 1.0f},
+                          {PADDLE_WIDTH, PADDLE_HEIGHT},
+                          {PADDLE_WIDTH, PADDLE_HEIGHT},
+                          PADDLE_SPEED};
+    Rng rng(99);
+    for (int i = 0; i < COUNT; i++) {
+        posX[i] = static_cast<float>(rng.range(0, 120));
+        posY[i] = static_cast<float>(rng.range(200, 520));
+        moveX[i] = rng.range(-100, 100) / 100.0f;
+        moveY[i] = rng.range(-100, 100) / 100.0f;
+        // Every fourth ball moves with the paddle: near 0 relative velocity
+        speed[i] = i % 4 == 0 ? 0.0f : static_cast<float>(rng.range(50, 900));
+        if (i % 4 == 0) moveY[i] = 0.0f;
+    }
+    paddle.movement.y = 0.0f; // So speed 0 balls really are still
+    float deltaTime = 1.0f / 120.0f;
+    Telemetry::reset();
+    sweepBatch(posX.data(), posY.data(), moveX.data(), moveY.data(),
+               speed.data(), BALL_SIZE / 2.0f, COUNT, paddle, deltaTime,
+               outTime.data(), outNormalX.data(), outNormalY.data());
+    uint64_t batchStill = Telemetry::getTotal(TM_STILL_EARLY_OUT);
+    uint64_t batchClamped = Telemetry::getTotal(TM_CLAMPED_ENTRY);
+    Telemetry::reset();
+    for (int i = 0; i < COUNT; i++) {
+        BallState ball;
+        ball.position = {posX[i], posY[i]};
+        ball.movement = {moveX[i], moveY[i]};
+        ball.speed = speed[i];
+        ball.radius = BALL_SIZE / 2.0f;
+        Vec2 normal;
+        sweepCollision(ball, paddle, normal, deltaTime);
+    }
+    uint64_t scalarStill = Telemetry::getTotal(TM_STILL_EARLY_OUT);
+    uint64_t scalarClamped = Telemetry::getTotal(TM_CLAMPED_ENTRY);
+    bool agree = batchStill == scalarStill && batchClamped == scalarClamped
+                 && scalarStill > 0 && scalarClamped > 0;
+    printf("  batch vs scalar: still %llu/%llu, clamped %llu/%llu: %s\n",
+           (unsigned long long)batchStill, (unsigned long long)scalarStill,
+           (unsigned long long)batchClamped,
+           (unsigned long long)scalarClamped, agree ? "OK" : "MISMATCH");
+    ok = ok && agree;
+
+    // The exposition file has every counter's total
+    const char* path = "telemetry_bench.prom";
+    bool exported = Telemetry::writePrometheus(path);
+    char expected[128];
+    snprintf(expected, sizeof(expected),
+             "pong_ccd_still_early_outs_total %llu\n",
+             (unsigned long long)scalarStill);
+    if (exported) {
+        FILE* file = fopen(path, "r");
+        std::string text;
+        char line[256];
+        while (file && fgets(line, sizeof(line), file)) text += line;
+        if (file) fclose(file);
+        exported = text.find(expected) != std::string::npos
+                   && text.find("# TYPE pong_ccd_swept_hits_total counter")
+                          != std::string::npos;
+        remove(path);
+    }
+    printf("  prometheus file: %s\n", exported ? "OK" : "MISSING COUNTERS");
+    ok = ok && exported;
+
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+// CollisionWorld checks and scaling. First a world holding only the two
+// classic paddles must play out bit for bit like BallPool::update(). Then
+// balls run through a field of 2 to 120 obstacles with sweep-and-prune and
+// with every pair tested, which must agree, and a four-player round where
+// every edge is a goal guarded by a paddle.
+// Usage: ./world_bench [balls=10000] [ticks=240]
+
+#include "../CS3113/CollisionWorld.h"
+#include "BenchUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const float DELTA_TIME = 1.0f / SIM_TICK_RATE;
+
+static PaddleState makeBody(Vec2 position, Vec2 size) {
+    PaddleState body;
+    body.position = position;
+    body.movement = {0.0f, 0.0f};
+    body.colliderDimensions = size;
+    body.scale = size;
+    body.speed = PADDLE_SPEED;
+    return body;
+}
+
+static Collider makePaddle(Vec2 position, Vec2 size, Vec2 facing) {
+    Collider collider;
+    collider.body = makeBody(position, size);
+    collider.facing = facing;
+    collider.kind = COLLIDER_PADDLE;
+    return collider;
+}
+
+static bool sameBalls(const BallPool& a, const BallPool& b) {
+    for (int i = 0; i < a.size(); i++) {
+        BallState x = a.get(i), y = b.get(i);
+        if (memcmp(&x, &y, sizeof(BallState)) != 0) return false;
+    }
+    return true;
+}
+
+// Both paddles chase the first ball, the world's colliders mirror them
+static bool checkClassic(int ballCount, int ticks) {
+    PaddleState paddles[2];
+    paddles[LEFT_PADDLE] = makeBody({PADDLE_MARGIN, SCREEN_HEIGHT / 2},
+                                    {PADDLE_WIDTH, PADDLE_HEIGHT});
+    paddles[RIGHT_PADDLE] =
+        makeBody({SCREEN_WIDTH - PADDLE_MARGIN, SCREEN_HEIGHT / 2},
+                 {PADDLE_WIDTH, PADDLE_HEIGHT});
+    CollisionWorld world;
+    world.addCollider(makePaddle(paddles[LEFT_PADDLE].position,
+                                 {PADDLE_WIDTH, PADDLE_HEIGHT}, {1.0f, 0.0f}));
+    world.addCollider(makePaddle(paddles[RIGHT_PADDLE].position,
+                                 {PADDLE_WIDTH, PADDLE_HEIGHT},
+                                 {-1.0f, 0.0f}));
+
+    Rng poolRng(67), worldRng(67);
+    BallPool pool, worldPool;
+    pool.resize(ballCount);
+    worldPool.resize(ballCount);
+    pool.resetAll(poolRng);
+    worldPool.resetAll(worldRng);
+    int scores[2] = {0, 0}, worldScores[2] = {0, 0};
+    std::vector<BallExit> exits;
+    for (int tick = 0; tick < ticks; tick++) {
+        for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++) {
+            steerPaddle(paddles[side], pool.get(0).position.y, DELTA_TIME);
+            world.getCollider(side).body = paddles[side];
+        }
+        pool.update(DELTA_TIME, paddles, scores[LEFT_PADDLE],
+                    scores[RIGHT_PADDLE], poolRng);
+        world.step(worldPool, DELTA_TIME, exits);
+        for (const BallExit& exit : exits) {
+            worldScores[exit.edge == EDGE_RIGHT ? LEFT_PADDLE :
+                                                  RIGHT_PADDLE]++;
+            worldPool.reset(exit.ball, worldRng);
+        }
+        for (int side = LEFT_PADDLE; side <= RIGHT_PADDLE; side++)
+            stepPaddle(paddles[side], DELTA_TIME);
+    }
+    bool same = sameBalls(pool, worldPool)
+             && scores[LEFT_PADDLE] == worldScores[LEFT_PADDLE]
+             && scores[RIGHT_PADDLE] == worldScores[RIGHT_PADDLE];
+    printf("classic: %d balls x %d ticks, score %d - %d vs %d - %d: %s\n",
+           ballCount, ticks, scores[LEFT_PADDLE], scores[RIGHT_PADDLE],
+           worldScores[LEFT_PADDLE], worldScores[RIGHT_PADDLE],
+           same ? "OK" : "MISMATCH");
+    return same;
+}
+
+// Runs a world for some ticks, serving balls that leave, and times it
+static double runWorld(CollisionWorld& world, BallPool& balls, int ticks,
+                       long long& pairs, long long& tests, long long& hits,
+                       int exitsPerEdge[EDGE_COUNT]) {
+    Rng rng(7);
+    std::vector<BallExit> exits;
+    pairs = tests = hits = 0;
+    for (int edge = 0; edge < EDGE_COUNT; edge++) exitsPerEdge[edge] = 0;
+    Clock::time_point start = Clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        world.step(balls, DELTA_TIME, exits);
+        for (const BallExit& exit : exits) {
+            exitsPerEdge[exit.edge]++;
+            balls.reset(exit.ball, rng);
+        }
+        world.stepColliders(DELTA_TIME);
+        pairs += world.getStats().candidatePairs;
+        tests += world.getStats().slabTests;
+        hits += world.getStats().hits;
+    }
+    return secondsSince(start);
+}
+
+// Balls spread over the whole screen heading every which way
+static void scatterBalls(BallPool& balls, int count) {
+    Rng rng(67);
+    balls.resize(count);
+    for (int i = 0; i < count; i++) {
+        BallState ball = balls.get(i);
+        resetBall(ball, rng.range(-60, 60), rng.range(0, 1) != 0);
+        ball.position = {(float)rng.range(10, SCREEN_WIDTH - 10),
+                         (float)rng.range(10, SCREEN_HEIGHT - 10)};
+        balls.set(i, ball);
+    }
+}
+
+static bool checkObstacles(int ballCount, int ticks) {
+    bool ok = true;
+    printf("\n%9s %10s %10s %12s %12s %9s %s\n", "colliders", "SAP ns/ball",
+           "all ns/ball", "SAP tests", "all tests", "hits", "");
+    const int counts[] = {2, 8, 32, 64, 120};
+    for (int colliders : counts) {
+        CollisionWorld world;
+        world.addCollider(makePaddle({PADDLE_MARGIN, SCREEN_HEIGHT / 2},
+                                     {PADDLE_WIDTH, PADDLE_HEIGHT},
+                                     {1.0f, 0.0f}));
+        world.addCollider(makePaddle({SCREEN_WIDTH - PADDLE_MARGIN,
+                                      SCREEN_HEIGHT / 2},
+                                     {PADDLE_WIDTH, PADDLE_HEIGHT},
+                                     {-1.0f, 0.0f}));
+        // Small blocks on a grid between the paddles, some drifting
+        Rng rng(colliders);
+        for (int i = 2; i < colliders; i++) {
+            Collider block;
+            block.body = makeBody({(float)rng.range(100, SCREEN_WIDTH - 100),
+                                   (float)rng.range(40, SCREEN_HEIGHT - 40)},
+                                  {16.0f, 16.0f});
+            block.body.movement = {0.0f, (float)rng.range(-1, 1)};
+            block.body.speed = 30.0f;
+            block.facing = {0.0f, 0.0f};
+            block.kind = COLLIDER_OBSTACLE;
+            world.addCollider(block);
+        }
+        CollisionWorld brute = world;
+        brute.setBroadphase(false);
+
+        BallPool sapBalls, bruteBalls;
+        scatterBalls(sapBalls, ballCount);
+        scatterBalls(bruteBalls, ballCount);
+        long long sapPairs, sapTests, sapHits, allPairs, allTests, allHits;
+        int sapExits[EDGE_COUNT], allExits[EDGE_COUNT];
+        double sapTime = runWorld(world, sapBalls, ticks, sapPairs, sapTests,
+                                  sapHits, sapExits);
+        double allTime = runWorld(brute, bruteBalls, ticks, allPairs,
+                                  allTests, allHits, allExits);
+        bool same = sameBalls(sapBalls, bruteBalls) && sapHits == allHits;
+        ok = ok && same;
+        double steps = (double)ballCount * ticks;
+        printf("%9d %10.1f %10.1f %12lld %12lld %9lld %s\n", colliders,
+               sapTime * 1e9 / steps, allTime * 1e9 / steps, sapTests,
+               allTests, sapHits, same ? "OK" : "MISMATCH");
+    }
+    return ok;
+}
+
+// A paddle on every edge, each facing the middle; any edge is a goal
+static bool checkFourPlayer(int ballCount, int ticks) {
+    const float length = 160.0f;
+    CollisionWorld world;
+    world.addCollider(makePaddle({PADDLE_MARGIN, SCREEN_HEIGHT / 2},
+                                 {PADDLE_WIDTH, length}, {1.0f, 0.0f}));
+    world.addCollider(makePaddle({SCREEN_WIDTH - PADDLE_MARGIN,
+                                  SCREEN_HEIGHT / 2},
+                                 {PADDLE_WIDTH, length}, {-1.0f, 0.0f}));
+    world.addCollider(makePaddle({SCREEN_WIDTH / 2, PADDLE_MARGIN},
+                                 {length, PADDLE_WIDTH}, {0.0f, 1.0f}));
+    world.addCollider(makePaddle({SCREEN_WIDTH / 2,
+                                  SCREEN_HEIGHT - PADDLE_MARGIN},
+                                 {length, PADDLE_WIDTH}, {0.0f, -1.0f}));
+    for (int edge = 0; edge < EDGE_COUNT; edge++)
+        world.setEdge(static_cast<ScreenEdge>(edge), EDGE_GOAL);
+
+    BallPool balls;
+    scatterBalls(balls, ballCount);
+    long long pairs, tests, hits;
+    int exits[EDGE_COUNT];
+    double time = runWorld(world, balls, ticks, pairs, tests, hits, exits);
+    // Every ball must still be on screen or just served
+    bool ok = true;
+    for (int i = 0; i < balls.size(); i++) {
+        Vec2 position = balls.get(i).position;
+        if (position.x < -BALL_SIZE || position.x > SCREEN_WIDTH + BALL_SIZE
+            || position.y < -BALL_SIZE
+            || position.y > SCREEN_HEIGHT + BALL_SIZE)
+            ok = false;
+    }
+    ok = ok && hits > 0 && exits[EDGE_TOP] > 0 && exits[EDGE_BOTTOM] > 0;
+    printf("\nfour players: %lld paddle hits, exits L %d R %d T %d B %d, "
+           "%.1f ns/ball: %s\n",
+           hits, exits[EDGE_LEFT], exits[EDGE_RIGHT], exits[EDGE_TOP],
+           exits[EDGE_BOTTOM], time * 1e9 / ((double)ballCount * ticks),
+           ok ? "OK" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int ballCount = argc > 1 ? atoi(argv[1]) : 10000;
+    int ticks = argc > 2 ? atoi(argv[2]) : 240;
+    bool ok = checkClassic(1000, 20 * SIM_TICK_RATE);
+    ok = checkObstacles(ballCount, ticks) && ok;
+    ok = checkFourPlayer(ballCount, ticks) && ok;
+    return ok ? 0 : 1;
+}
@@ -8,10 +8,20 @@
  * Academic Misconduct.
  **/
 
-#include "CS3113/Ball.h"
+#include "CS3113/AssetLoader.h"
 #include "CS3113/Constants.h"
-#include "CS3113/Entity.h"
-#include "CS3113/Paddle.h"
+#include "CS3113/EcsRender.h"
+#include "CS3113/HudText.h"
+#include "CS3113/Profiler.h"
+#include "CS3113/Replay.h"
+#include "CS3113/Rollback.h"
+#include "CS3113/SimThread.h"
+#include "CS3113/Simulation.h"
+#include "CS3113/SpriteBatch.h"
+#include "CS3113/Telemetry.h"
+#include "CS3113/TextureCache.h"
+#include <stdlib.h>
+#include <string.h>
 
 // Global Constants
 constexpr char BG_COLOUR[] = "#000000";
@@ -21,6 +31,10 @@ const int SCORE_FONT_SIZE = 50, TEXT_FONT_SIZE = 30,
           LEFT_SCORE_X = SCREEN_WIDTH / 4,
           RIGHT_SCORE_X = SCREEN_WIDTH * 3 / 4 - 20, SCORE_Y = 25,
           CENTER_TEXT_Y = SCREEN_HEIGHT / 2 - 15;
+const int STRESS_BALLS =
+    BALL_POOL_CAPACITY; // Press 0: renderer stress test, no winner
+const float TELEMETRY_FLUSH_SECONDS = 1.0f; // --telemetry file rewrite period
+constexpr char ASSET_PACK[] = "assets/textures.pack"; // From `make pack`
 
 // Player enum
 enum Player { NONE, LEFT_P, RIGHT_P, BOTH };
@@ -28,22 +42,79 @@ enum Player { NONE, LEFT_P, RIGHT_P, BOTH };
 // Global Variables
 AppStatus gAppStatus = RUNNING;
 float gPreviousTicks = 0.0f;
+float gAccumulator = 0.0f; // Real time not yet simulated, under one tick
+int gTickRate = SIM_TICK_RATE;
+uint8_t gInput = 0;        // InputBits held this frame
 
 int gLeftScore = 0;
 int gRightScore = 0;
 bool gSinglePlayer = false;
 bool gPaused = true;
 bool gStarted = false;
+bool gBallCollisions = false; // Balls bounce off each other
+bool gShowProfiler = false;   // F1: frame time graph and percentiles
+const char* gProfileCsv = "profile.csv"; // Written on exit
+const char* gTelemetryPath = nullptr; // Prometheus counters, if --telemetry
+float gTelemetryFlushed = 0.0f;       // When gTelemetryPath was last written
+Color gBackground;           // BG_COLOUR, parsed once
+// Startup: textures come from ASSET_PACK unless --no-pack, and anything
+// else decodes in the background unless --sync-assets
+const std::chrono::steady_clock::time_point gLaunchTime =
+    std::chrono::steady_clock::now();
+bool gSyncAssets = false;
+bool gUsePack = true;
+AssetPack gPack;
+AssetLoader* gAssets = nullptr;
+bool gFirstFrameLogged = false;
+bool gAssetsLogged = false;
 int gActiveBalls = 1;
 Player gWinner = NONE;
 
-// Entities
-Paddle* left_paddle = nullptr;
-Paddle* right_paddle = nullptr;
-std::vector<Ball*> gBalls;
-Entity* gWinAnimation = nullptr;
+// Game state, stepped at gTickRate. Entities below only draw it
+Simulation* gSimulation = nullptr;
+WorkerPool* gWorkers = nullptr;   // Splits the ball update across cores
+Vec2 gPreviousPaddles[2];         // Paddle positions before last tick
+std::vector<Vec2> gPreviousBalls; // Ball positions before last tick
+
+// Simulation thread: with --sim-thread it steps gSimulation, not update()
+bool gUseSimThread = false;
+SimThread* gSimThread = nullptr;
+LatencyRing gPresentLatency;   // Input sampled to the first frame showing it
+uint16_t gPresentedInput = 0;  // FrameState::inputSequence last presented
+
+// Replays
+const char* gRecordPath = nullptr; // --record <path>
+const char* gPlayPath = nullptr;   // --play <path>
+bool gFastForward = false;         // --fast-forward: play headless, no window
+ReplayWriter gRecorder;            // Only writes once opened
+ReplayReader* gReplay = nullptr;   // Set while playing back, replaces keys
+
+// Netplay between two processes on this machine
+const uint32_t NET_SEED = 67;          // Both peers must start identically
+int gNetPort = 0;                      // --net-port <port>: ours, 0 = offline
+int gNetPeer = 0;                      // --net-peer <port>: the other process
+int gNetSide = LEFT_PADDLE;            // --net-side left|right
+float gNetLatency = 0.0f;              // --net-latency <ms>, added on purpose
+float gNetLoss = 0.0f;                 // --net-loss <percent>, dropped
+NetTransport gTransport;
+RollbackSession* gSession = nullptr;   // Set while netplaying, steps the game
+
+// Entities: components packed by kind, drawing what the Simulation says
+EcsWorld gWorld;
+EntityId gLeftPaddle = NO_ENTITY;
+EntityId gRightPaddle = NO_ENTITY;
+EntityId gBallSprite = NO_ENTITY; // Drawn once per simulated ball
+EntityId gWinAnimation = NO_ENTITY;
+
+// HUD text, rasterised again only when it changes
+HudText* gLeftScoreText = nullptr;
+HudText* gRightScoreText = nullptr;
+HudText* gMessageText = nullptr; // Winner or pause message
+SpriteBatch gSpriteBatch; // Paddles and balls: one bind each, or one for
+                          // both when they're in the pack's atlas
 
 // Function Declarations (game loop)
+void parseArguments(int argc, char** argv);
 void initialise();
 void processInput();
 void update();
@@ -51,19 +122,38 @@ void render();
 void shutdown();
 
 // Local Function Declarations
+int fastForward();
+void runCommand(ReplayEventType type, uint32_t value);
+void applyCommand(const ReplayEvent& event);
+void runReplayEvents();
+bool nextReplayTick();
 void setBallCount(int count);
 void resetGame();
+void savePreviousState();
+Vec2 interpolate(Vec2 previous, Vec2 current, float alpha);
+void updateHud();
 void renderAllText();
 void renderScores(Player players);
+void renderProfiler();
+void flushTelemetry();
+void queueBall(Vec2 position);
+void logStartup(int texturesLoading);
 void setWinAnimPos();
 
-int main(void) {
+int main(int argc, char** argv) {
+    parseArguments(argc, argv);
+    if (gPlayPath && gFastForward) return fastForward();
     initialise();
 
     while (gAppStatus == RUNNING) {
-        processInput();
-        update();
-        render();
+        {
+            ProfileScope scope(PHASE_FRAME);
+            processInput();
+            update();
+            render();
+        }
+        Profiler::endFrame();
+        flushTelemetry();
     }
 
     shutdown();
@@ -71,28 +161,168 @@ int main(void) {
     return 0;
 }
 
+// Reads command line options: --tick-rate <Hz>, --profile-csv <path>,
+// --record <path>, --play <path>, --fast-forward, --net-port <port>,
+// --net-peer <port>, --net-side left|right, --net-latency <ms>,
+// --net-loss <percent>, --telemetry <path>, --sim-thread, --sync-assets,
+// --no-pack
+void parseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+            gTickRate = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc)
+            gProfileCsv = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            gRecordPath = argv[++i];
+        else if (strcmp(argv[i], "--play") == 0 && i + 1 < argc)
+            gPlayPath = argv[++i];
+        else if (strcmp(argv[i], "--fast-forward") == 0)
+            gFastForward = true;
+        else if (strcmp(argv[i], "--net-port") == 0 && i + 1 < argc)
+            gNetPort = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--net-peer") == 0 && i + 1 < argc)
+            gNetPeer = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--net-side") == 0 && i + 1 < argc)
+            gNetSide = strcmp(argv[++i], "right") == 0 ? RIGHT_PADDLE :
+                                                         LEFT_PADDLE;
+        else if (strcmp(argv[i], "--net-latency") == 0 && i + 1 < argc)
+            gNetLatency = static_cast<float>(atof(argv[++i])) / 1000.0f;
+        else if (strcmp(argv[i], "--net-loss") == 0 && i + 1 < argc)
+            gNetLoss = static_cast<float>(atof(argv[++i])) / 100.0f;
+        else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc)
+            gTelemetryPath = argv[++i];
+        else if (strcmp(argv[i], "--sim-thread") == 0)
+            gUseSimThread = true;
+        else if (strcmp(argv[i], "--sync-assets") == 0)
+            gSyncAssets = true;
+        else if (strcmp(argv[i], "--no-pack") == 0)
+            gUsePack = false;
+    }
+    Telemetry::setEnabled(gTelemetryPath != nullptr);
+}
+
+// Plays a whole log without a window as fast as possible and prints the
+// result. Returns the process exit code
+int fastForward() {
+    ReplayReader reader;
+    if (!reader.open(gPlayPath)) {
+        printf("Replay: can't read %s\n", gPlayPath);
+        return 1;
+    }
+    WorkerPool workers;
+    Simulation simulation(reader.getSeed(),
+                          static_cast<float>(reader.getTickRate()));
+    simulation.setWorkerPool(&workers);
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    uint64_t ticks = playReplay(reader, simulation);
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    printf("Replay: %llu ticks (%.1f s of play) in %.3f s, %.0f ticks/sec\n",
+           (unsigned long long)ticks, ticks * simulation.getDeltaTime(),
+           seconds, ticks / std::max(seconds, 1e-9));
+    printf("Replay: final score %d - %d, seed %u\n",
+           simulation.getLeftScore(), simulation.getRightScore(),
+           reader.getSeed());
+    if (gTelemetryPath && !Telemetry::writePrometheus(gTelemetryPath))
+        printf("Telemetry: can't write %s\n", gTelemetryPath);
+    return 0;
+}
+
 void initialise() {
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "We Got Pong 67 Before GTA 6");
+    gBackground = ColorFromHex(BG_COLOUR);
+    Profiler::setEnabled(true);
+    PackStatus packStatus = gUsePack ? gPack.open(ASSET_PACK) : PACK_MISSING;
+    if (packStatus == PACK_OK)
+        TextureCache::setPack(&gPack);
+    else if (packStatus != PACK_MISSING) // Old or broken: decode instead
+        printf("AssetPack: %s is unusable (%s), decoding images\n",
+               ASSET_PACK, AssetPack::describe(packStatus));
+    if (!gSyncAssets) { // Sprites draw nothing until their texture arrives
+        gAssets = new AssetLoader();
+        TextureCache::setLoader(gAssets);
+    }
+    uint32_t seed = static_cast<uint32_t>(time(nullptr));
+    if (gPlayPath) { // Seed and tick rate come from the log
+        gReplay = new ReplayReader();
+        if (gReplay->open(gPlayPath)) {
+            seed = gReplay->getSeed();
+            gTickRate = static_cast<int>(gReplay->getTickRate());
+        } else {
+            printf("Replay: can't read %s, playing live\n", gPlayPath);
+            delete gReplay;
+            gReplay = nullptr;
+        }
+    }
+    bool netplay = gNetPort && gNetPeer && !gReplay;
+    if (netplay) seed = NET_SEED;
+    if (netplay && gRecordPath) {
+        printf("Replay: can't record a netplay match, not recording\n");
+        gRecordPath = nullptr;
+    }
+    gSimulation = new Simulation(seed, static_cast<float>(gTickRate));
+    // Sized for the biggest mode, like the Simulation's balls
+    gPreviousBalls.reserve(BALL_POOL_CAPACITY);
+    gSpriteBatch.reserve(BALL_POOL_CAPACITY + 2);
+    if (gRecordPath && !gReplay
+        && !gRecorder.open(gRecordPath, seed, static_cast<uint32_t>(gTickRate)))
+        printf("Replay: can't write %s\n", gRecordPath);
+    gWorkers = new WorkerPool();
+    gSimulation->setWorkerPool(gWorkers);
     // Set left paddle at left edge, vertically centred
-    left_paddle = new Paddle(Vector2 {25.0f, SCREEN_HEIGHT / 2},
-                             Vector2 {25.0f, 100.0f}, "assets/paddle.png");
-    left_paddle->setFlipped(true); // Flip left paddle horizontally
+    gLeftPaddle = createSprite(
+        gWorld, Vector2 {PADDLE_MARGIN, SCREEN_HEIGHT / 2},
+        Vector2 {PADDLE_WIDTH, PADDLE_HEIGHT}, "assets/paddle.png");
+    gWorld.sprites.get(gLeftPaddle).flipped = true; // Flip horizontally
     // Set right paddle at right edge, vertically centred
-    right_paddle = new Paddle(Vector2 {SCREEN_WIDTH - 25.0f, SCREEN_HEIGHT / 2},
-                              Vector2 {25.0f, 100.0f}, "assets/paddle.png");
+    gRightPaddle = createSprite(
+        gWorld, Vector2 {SCREEN_WIDTH - PADDLE_MARGIN, SCREEN_HEIGHT / 2},
+        Vector2 {PADDLE_WIDTH, PADDLE_HEIGHT}, "assets/paddle.png");
+    // One sprite shared by every ball, positioned per ball when rendering
+    gBallSprite = createSprite(gWorld, ORIGIN, Vector2 {BALL_SIZE, BALL_SIZE},
+                               "assets/ball.png");
     // Initialize balls in centre of screen with random movement direction
-    setBallCount(1);
+    runCommand(REPLAY_BALL_COUNT, 1);
+    // Netplay takes over stepping once both peers are in the same state
+    if (netplay) {
+        if (gTransport.open(static_cast<uint16_t>(gNetPort),
+                            static_cast<uint16_t>(gNetPeer))) {
+            gTransport.setConditions(gNetLatency, 0.0f, gNetLoss);
+            gSession = new RollbackSession(*gSimulation, gTransport, gNetSide);
+            printf("Netplay: port %d, peer %d, %s paddle\n", gNetPort,
+                   gNetPeer, gNetSide == LEFT_PADDLE ? "left" : "right");
+        } else {
+            printf("Netplay: can't open port %d, playing locally\n",
+                   gNetPort);
+        }
+    }
+    gLeftScoreText = new HudText(SCORE_FONT_SIZE, WHITE);
+    gRightScoreText = new HudText(SCORE_FONT_SIZE, WHITE);
+    gMessageText = new HudText(TEXT_FONT_SIZE, WHITE);
     // Initialize win animation entity (hidden until game over)
-    gWinAnimation =
-        new Entity(ORIGIN, Vector2 {100.0f, 100.0f}, "assets/win.png", ATLAS,
-                   Vector2 {1, 10}, {{DOWN, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}}});
-    gWinAnimation->setAlwaysAnimate(
-        true); // Animate win animation even without movement
-    gWinAnimation->setFrameSpeed(10);
+    gWinAnimation = createAnimatedSprite(
+        gWorld, ORIGIN, Vector2 {100.0f, 100.0f}, "assets/win.png",
+        Vector2 {1, 10}, {{DOWN, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}}}, 10);
+    // Animate win animation even without movement
+    gWorld.animations.get(gWinAnimation).alwaysAnimate = true;
+    TextureCache::logStats("initialise");
+    // Replays and netplay step the Simulation tick by tick from this thread
+    if (gUseSimThread && (gReplay || gRecordPath || gSession)) {
+        printf("SimThread: not used for replays or netplay\n");
+        gUseSimThread = false;
+    }
+    if (gUseSimThread) {
+        gSimThread = new SimThread(*gSimulation);
+        gSimThread->start();
+        printf("SimThread: ticking at %d Hz\n", gTickRate);
+    }
     SetTargetFPS(FPS);
 }
 
 void processInput() {
+    ProfileScope scope(PHASE_INPUT);
     if (IsKeyPressed(KEY_Q) || WindowShouldClose()) gAppStatus = TERMINATED;
     if (IsKeyPressed(KEY_P)) { // Pause/unpause game
         if (gWinner == NONE) {
@@ -101,130 +331,368 @@ void processInput() {
                 gStarted = true; // Mark game as started on first unpause
             if (!gPaused)
                 gPreviousTicks = (float)GetTime(); // Reset timer on unpause
+        } else if (gReplay) {
+            runReplayEvents(); // Move on to the reset that followed the win
         }
     }
+    // Toggle profiler overlay
+    if (IsKeyPressed(KEY_F1)) gShowProfiler = !gShowProfiler;
+    if (gReplay) return; // Commands and input come from the log instead
+    if (gSession) { // Netplay: no commands, either key pair moves our paddle
+        gInput = 0;
+        if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP))
+            gInput |= INPUT_LEFT_UP | INPUT_RIGHT_UP;
+        if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN))
+            gInput |= INPUT_LEFT_DOWN | INPUT_RIGHT_DOWN;
+        return;
+    }
 
-    if (IsKeyPressed(KEY_R)) resetGame(); // Reset game state
+    if (IsKeyPressed(KEY_R)) runCommand(REPLAY_RESET, 0); // Reset game state
     // Toggle single-player mode
-    if (IsKeyPressed(KEY_T)) gSinglePlayer = !gSinglePlayer;
+    if (IsKeyPressed(KEY_T)) runCommand(REPLAY_SINGLE_PLAYER, !gSinglePlayer);
+    // Toggle ball-ball collisions
+    if (IsKeyPressed(KEY_B))
+        runCommand(REPLAY_BALL_COLLISIONS, !gBallCollisions);
     // Ball count controls
-    if (IsKeyPressed(KEY_ONE)) setBallCount(1);
-    if (IsKeyPressed(KEY_TWO)) setBallCount(2);
-    if (IsKeyPressed(KEY_THREE)) setBallCount(3);
+    if (IsKeyPressed(KEY_ONE)) runCommand(REPLAY_BALL_COUNT, 1);
+    if (IsKeyPressed(KEY_TWO)) runCommand(REPLAY_BALL_COUNT, 2);
+    if (IsKeyPressed(KEY_THREE)) runCommand(REPLAY_BALL_COUNT, 3);
     // Easter egg
-    if (IsKeyDown(KEY_SIX) && IsKeyPressed(KEY_SEVEN)) setBallCount(67);
+    if (IsKeyDown(KEY_SIX) && IsKeyPressed(KEY_SEVEN))
+        runCommand(REPLAY_BALL_COUNT, 67);
+    if (IsKeyPressed(KEY_ZERO)) runCommand(REPLAY_BALL_COUNT, STRESS_BALLS);
     // Left paddle controls always active
-    if (IsKeyDown(KEY_W)) left_paddle->moveUp();
-    if (IsKeyDown(KEY_S)) left_paddle->moveDown();
+    gInput = 0;
+    if (IsKeyDown(KEY_W)) gInput |= INPUT_LEFT_UP;
+    if (IsKeyDown(KEY_S)) gInput |= INPUT_LEFT_DOWN;
     // Right paddle only controllable in 2-player mode
     if (!gSinglePlayer) {
-        if (IsKeyDown(KEY_UP)) right_paddle->moveUp();
-        if (IsKeyDown(KEY_DOWN)) right_paddle->moveDown();
+        if (IsKeyDown(KEY_UP)) gInput |= INPUT_RIGHT_UP;
+        if (IsKeyDown(KEY_DOWN)) gInput |= INPUT_RIGHT_DOWN;
     }
+    if (gSimThread) gSimThread->setInput(gInput, SimThread::now());
 }
 
 void update() {
+    ProfileScope scope(PHASE_UPDATE);
     // Delta time
     float ticks = (float)GetTime();
     float deltaTime = ticks - gPreviousTicks;
     gPreviousTicks = ticks;
     // Check for winner
     int winScore = gActiveBalls == 67 ? 67 : 10;
-    if (gLeftScore >= winScore && gWinner == NONE) {
+    bool canWin = gActiveBalls != STRESS_BALLS && gWinner == NONE;
+    if (canWin && gLeftScore >= winScore) {
         gWinner = LEFT_P;
-    } else if (gRightScore >= winScore && gWinner == NONE) {
+    } else if (canWin && gRightScore >= winScore) {
         gWinner = RIGHT_P;
     }
     if (gWinner != NONE) { // Someone won
         setWinAnimPos();
         gPaused = true;
         if (gActiveBalls == 67) {
-            gWinAnimation->update(deltaTime); // Update only on game over
+            animationSystem(gWorld, deltaTime); // Update only on game over
         }
     }
 
-    if (gPaused) return; // Don't update game entities if paused
-    if (gSinglePlayer) { // Update AI paddle movement if in single-player mode
-        right_paddle->singlePlayerAI(gBalls, gActiveBalls);
+    if (gSimThread) { // It ticks by itself; take the newest frame's scores
+        gSimThread->setPaused(gPaused);
+        gSimThread->fetchFrame();
+        const FrameState& frame = gSimThread->getFrame();
+        // Until a pushed reset is applied, the frame's scores are stale
+        if (frame.commands == gSimThread->getCommandsPushed()) {
+            gLeftScore = frame.scores[LEFT_PADDLE];
+            gRightScore = frame.scores[RIGHT_PADDLE];
+        }
+        return;
     }
-    // Update entities
-    for (int i = 0; i < gActiveBalls; i++) {
-        gBalls[i]->update(deltaTime, left_paddle, right_paddle, gLeftScore,
-                          gRightScore);
+    if (gPaused) { // Don't update game entities if paused
+        if (gSession) gSession->poll(GetTime()); // Keep the peer informed
+        return;
     }
-    left_paddle->update(deltaTime);
-    right_paddle->update(deltaTime);
+    // Run every whole tick that real time has covered, dropping any backlog
+    // past MAX_TICK_BACKLOG instead of spiralling
+    float tickTime = gSimulation->getDeltaTime();
+    gAccumulator = std::min(gAccumulator + deltaTime, MAX_TICK_BACKLOG);
+    while (gAccumulator >= tickTime) {
+        if (gReplay && !nextReplayTick()) break; // Loads gInput from the log
+        savePreviousState();
+        if (gSession) {
+            if (!gSession->advance(gInput, GetTime())) break; // Peer is behind
+        } else {
+            gRecorder.tick(gInput);
+            gSimulation->step(gInput);
+        }
+        gAccumulator -= tickTime;
+    }
+    // Stopped by the log or the peer: don't rush the missed ticks later
+    if (gAccumulator >= tickTime) gAccumulator = fmodf(gAccumulator, tickTime);
+    if (gSession) { // Only points a rollback can't take back
+        gLeftScore = gSession->getConfirmedScore(LEFT_PADDLE);
+        gRightScore = gSession->getConfirmedScore(RIGHT_PADDLE);
+        return;
+    }
+    gLeftScore = gSimulation->getLeftScore();
+    gRightScore = gSimulation->getRightScore();
 }
 
 void render() {
+    // The simulation thread's newest tick, fetched by update()
+    const FrameState* frame = gSimThread ? &gSimThread->getFrame() : nullptr;
+    int texturesLoading;
+    {
+        ProfileScope upload(PHASE_UPLOAD);
+        texturesLoading = TextureCache::update(); // Within the frame budget
+    }
+    {
+        ProfileScope text(PHASE_TEXT);
+        updateHud(); // Render textures can't be drawn into mid-frame
+    }
     BeginDrawing();
-    ClearBackground(ColorFromHex(BG_COLOUR));
-    // Render entities
-    left_paddle->render();
-    right_paddle->render();
-    for (int i = 0; i < gActiveBalls; i++) {
-        gBalls[i]->render();
+    {
+        ProfileScope scope(PHASE_RENDER); // Excludes the EndDrawing() wait
+        ClearBackground(gBackground);
+        // Blend between the last two ticks by how far into the next one we are
+        float alpha = gAccumulator / gSimulation->getDeltaTime();
+        Vec2 leftPos, rightPos;
+        if (frame) { // Ticks run on their own clock, so time since the last
+            alpha = std::min(1.0f, static_cast<float>(
+                                       (SimThread::now() - frame->time)
+                                       / frame->deltaTime));
+            leftPos = interpolate(frame->previousPaddles[LEFT_PADDLE],
+                                  frame->paddles[LEFT_PADDLE], alpha);
+            rightPos = interpolate(frame->previousPaddles[RIGHT_PADDLE],
+                                   frame->paddles[RIGHT_PADDLE], alpha);
+        } else {
+            leftPos = interpolate(gPreviousPaddles[LEFT_PADDLE],
+                                  gSimulation->getPaddle(LEFT_PADDLE).position,
+                                  alpha);
+            rightPos = interpolate(
+                gPreviousPaddles[RIGHT_PADDLE],
+                gSimulation->getPaddle(RIGHT_PADDLE).position, alpha);
+        }
+        gWorld.transforms.get(gLeftPaddle).position = leftPos;
+        gWorld.transforms.get(gRightPaddle).position = rightPos;
+        {
+            // Render entities, batched by texture
+            ProfileScope entities(PHASE_ENTITIES);
+            gSpriteBatch.begin();
+            queueSprite(gWorld, gLeftPaddle, gSpriteBatch);
+            queueSprite(gWorld, gRightPaddle, gSpriteBatch);
+            if (frame) {
+                const std::vector<Vec2>& balls = frame->balls;
+                const std::vector<Vec2>& previous = frame->previousBalls;
+                bool hasPrevious = previous.size() == balls.size();
+                for (size_t i = 0; i < balls.size(); i++)
+                    queueBall(hasPrevious ?
+                                  interpolate(previous[i], balls[i], alpha) :
+                                  balls[i]);
+            } else {
+                const BallPool& balls = gSimulation->getBalls();
+                bool hasPrevious =
+                    gPreviousBalls.size() == (size_t)balls.size();
+                for (int i = 0; i < balls.size(); i++) {
+                    Vec2 current = {balls.getPositionsX()[i],
+                                    balls.getPositionsY()[i]};
+                    queueBall(hasPrevious ?
+                                  interpolate(gPreviousBalls[i], current,
+                                              alpha) :
+                                  current);
+                }
+            }
+            gSpriteBatch.end();
+        }
+        {
+            ProfileScope text(PHASE_TEXT);
+            renderAllText(); // Render text
+        }
+        if (gActiveBalls == STRESS_BALLS) DrawFPS(10, 10);
+        // Render win animation if game over in 67 mode
+        if (gWinner != NONE && gActiveBalls == 67)
+            drawSprite(gWorld, gWinAnimation);
     }
-    renderAllText(); // Render text
-    // Render win animation if game over in 67 mode
-    if (gWinner != NONE && gActiveBalls == 67) { gWinAnimation->render(); }
+    if (gShowProfiler) renderProfiler(); // Drawn outside the timed phases
 
     EndDrawing();
+    // Input to photon, as near as we can see it: the buffer swap after the
+    // first frame drawn from a tick that used the input
+    if (frame && frame->inputSequence != gPresentedInput) {
+        gPresentedInput = frame->inputSequence;
+        gPresentLatency.add(
+            static_cast<float>((SimThread::now() - frame->inputTime) * 1000.0));
+    }
+    logStartup(texturesLoading);
 }
 
 void shutdown() {
-    delete left_paddle;
-    delete right_paddle;
-    delete gWinAnimation;
-    for (Ball* ball : gBalls) {
-        delete ball;
+    if (gSimThread) { // Stop ticking before anything it uses goes away
+        gSimThread->stop();
+        LatencyRing& lateness = gSimThread->getTickLateness();
+        LatencyRing& input = gSimThread->getInputLatency();
+        printf("SimThread: tick lateness p50 %.3f p99 %.3f max %.3f ms, "
+               "%llu ticks dropped\n",
+               lateness.getPercentile(50.0f), lateness.getPercentile(99.0f),
+               lateness.getMaximum(),
+               (unsigned long long)gSimThread->getDroppedTicks());
+        printf("SimThread: input to tick p50 %.2f p99 %.2f ms, to present "
+               "p50 %.2f p99 %.2f max %.2f ms\n",
+               input.getPercentile(50.0f), input.getPercentile(99.0f),
+               gPresentLatency.getPercentile(50.0f),
+               gPresentLatency.getPercentile(99.0f),
+               gPresentLatency.getMaximum());
+        delete gSimThread;
+    }
+    destroySprite(gWorld, gLeftPaddle);
+    destroySprite(gWorld, gRightPaddle);
+    destroySprite(gWorld, gWinAnimation);
+    destroySprite(gWorld, gBallSprite);
+    printf("HUD: %d text redraws in %d frames\n", HudText::getRedrawCount(),
+           Profiler::getFrameCount());
+    delete gLeftScoreText;
+    delete gRightScoreText;
+    delete gMessageText;
+    if (gSession) {
+        const RollbackStats& stats = gSession->getStats();
+        printf("Netplay: %llu ticks, %llu rollbacks (max %d ticks), %llu "
+               "resimulated, %llu stalls\n",
+               (unsigned long long)stats.ticks,
+               (unsigned long long)stats.rollbacks, stats.maxDepth,
+               (unsigned long long)stats.resimulatedTicks,
+               (unsigned long long)stats.stalls);
+        delete gSession; // Holds a reference to the Simulation
     }
+    gTransport.close();
+    delete gSimulation;
+    delete gWorkers;
+    delete gReplay;
+    if (gRecordPath && gRecorder.getTicks() > 0)
+        printf("Replay: recorded %llu ticks to %s\n",
+               (unsigned long long)gRecorder.getTicks(), gRecordPath);
+    gRecorder.close();
+    TextureCache::logStats("shutdown");
+    TextureCache::setLoader(nullptr);
+    delete gAssets;
+    TextureCache::setPack(nullptr);
+    gPack.close();
+    if (Profiler::writeCsv(gProfileCsv))
+        printf("Profiler: wrote %d frames to %s\n", Profiler::getFrameCount(),
+               gProfileCsv);
+    if (gTelemetryPath && Telemetry::writePrometheus(gTelemetryPath))
+        printf("Telemetry: %llu paddle hits, %llu depenetrations in %s\n",
+               (unsigned long long)(Telemetry::getTotal(TM_HIT_LEFT)
+                                    + Telemetry::getTotal(TM_HIT_RIGHT)),
+               (unsigned long long)(Telemetry::getTotal(TM_DEPEN_INSIDE)
+                                    + Telemetry::getTotal(TM_DEPEN_OVERLAP)),
+               gTelemetryPath);
     CloseWindow();
 }
 
+// Runs a command that changes the game between ticks, logging it first when
+// recording so playback can run it at the same point
+void runCommand(ReplayEventType type, uint32_t value) {
+    if (gReplay) return; // Playback only runs the log's commands
+    ReplayEvent event = {type, value};
+    gRecorder.event(event);
+    applyCommand(event);
+}
+
+// Applies a command to the Simulation, then to what main.cpp shows
+void applyCommand(const ReplayEvent& event) {
+    ProfileScope scope(PHASE_SWITCH);
+    if (gSimThread) { // Applied on its thread before the next tick
+        // The command is already logged and shown, so it can't be dropped.
+        // The thread drains the ring every pass, even when paused
+        while (!gSimThread->pushCommand(event)) std::this_thread::yield();
+    } else {
+        applyReplayEvent(*gSimulation, event);
+    }
+    switch (event.type) {
+    case REPLAY_BALL_COUNT :
+        setBallCount(static_cast<int>(event.value));
+        break;
+    case REPLAY_SINGLE_PLAYER : gSinglePlayer = event.value != 0; break;
+    case REPLAY_BALL_COLLISIONS : gBallCollisions = event.value != 0; break;
+    case REPLAY_RESET : resetGame(); break;
+    }
+}
+
+// Applies the log's commands up to its next tick
+void runReplayEvents() {
+    ReplayEvent event;
+    while (gReplay->nextEvent(event)) applyCommand(event);
+}
+
+// Loads the next tick's input from the log into gInput. Returns false when
+// there's no tick to run: a command paused the game, or the log has ended
+bool nextReplayTick() {
+    runReplayEvents();
+    if (gPaused) return false; // Resets pause, like they did when recorded
+    if (gReplay->nextTick(gInput)) return true;
+    printf("Replay: finished after %llu ticks\n",
+           (unsigned long long)gReplay->getTick());
+    gPaused = true;
+    return false;
+}
+
 // Sets the number of active balls in the game, resetting all balls when changed
 void setBallCount(int count) {
-    // Allocate more balls if needed
-    while (gBalls.size() < static_cast<size_t>(count)) {
-        Ball* b = new Ball(ORIGIN, Vector2 {20.0f, 20.0f}, "assets/ball.png");
-        gBalls.push_back(b);
-    }
-    // Set active ball count and reset all balls
+    // Set active ball count; the Simulation has already reset the balls
     gActiveBalls = count;
-    for (size_t i = 0; i < gActiveBalls; i++) {
-        Ball* b = gBalls[i];
-        if (gActiveBalls == 67) {
-            b->setBaseSpeed(Ball::SLOW_SPEED); // Slow down balls for 67 mode
-        } else {
-            b->setBaseSpeed(Ball::FAST_SPEED); // 1-3 balls use default speed
-        }
-        b->reset();
-    }
+    if (!gSimThread) savePreviousState(); // Nothing to interpolate from
+    if (gWorld.isAlive(gBallSprite))
+        TextureCache::logStats(TextFormat("%d balls", count));
 }
 
 // Resets game state and pauses
 void resetGame() {
     gLeftScore = 0;
     gRightScore = 0;
-    left_paddle->setPosition(Vector2 {25.0f, SCREEN_HEIGHT / 2});
-    right_paddle->setPosition(
-        Vector2 {SCREEN_WIDTH - 25.0f, SCREEN_HEIGHT / 2});
-    setBallCount(1);
+    setBallCount(1); // Simulation has reset scores, paddles and balls
     gPreviousTicks = (float)GetTime();
+    gAccumulator = 0.0f;
     gSinglePlayer = false; // Start in 2 player mode
     gPaused = true;        // Start paused to allow player(s) to prepare
     gStarted = false;      // Mark game as unstarted
     gWinner = NONE;        // Clear winner to allow new game
 }
 
+// Remembers where everything was before a tick, for render interpolation
+void savePreviousState() {
+    gPreviousPaddles[LEFT_PADDLE] =
+        gSimulation->getPaddle(LEFT_PADDLE).position;
+    gPreviousPaddles[RIGHT_PADDLE] =
+        gSimulation->getPaddle(RIGHT_PADDLE).position;
+    const BallPool& balls = gSimulation->getBalls();
+    gPreviousBalls.resize(balls.size());
+    for (int i = 0; i < balls.size(); i++)
+        gPreviousBalls[i] = {balls.getPositionsX()[i],
+                             balls.getPositionsY()[i]};
+}
+
+// Linear blend from previous to current, except for jumps (a ball served
+// back to the centre after scoring), which snap straight to current
+Vec2 interpolate(Vec2 previous, Vec2 current, float alpha) {
+    if (fabsf(current.x - previous.x) > SCREEN_WIDTH / 4.0f) return current;
+    return {previous.x + (current.x - previous.x) * alpha,
+            previous.y + (current.y - previous.y) * alpha};
+}
+
+// Brings the HUD text up to date with the game. Only text whose value
+// changed since last frame is laid out and rasterised again
+void updateHud() {
+    gLeftScoreText->setNumber(gLeftScore);
+    gRightScoreText->setNumber(gRightScore);
+    if (gWinner != NONE) // Display winner in game over message
+        gMessageText->setText(gWinner == LEFT_P ? "Left Player Wins!" :
+                                                  "Right Player Wins!");
+    else if (gPaused)
+        gMessageText->setText(gStarted ? "PAUSED" : "Press P to Play");
+}
+
 void renderAllText() {
     // Render game over text and return early
     if (gWinner != NONE) {
-        const char* winText = // Display winner in game over message
-            gWinner == LEFT_P ? "Left Player Wins!" : "Right Player Wins!";
-        int textWidth = MeasureText(winText, TEXT_FONT_SIZE);
-        DrawText(winText, SCREEN_WIDTH / 2 - textWidth / 2, CENTER_TEXT_Y,
-                 TEXT_FONT_SIZE, WHITE);
+        gMessageText->drawCentred(SCREEN_WIDTH / 2, CENTER_TEXT_Y);
         // In 67 mode, gif replaces winner's score
         if (gWinner == LEFT_P && gActiveBalls == 67)
             renderScores(RIGHT_P); // Right player lost - render their score
@@ -239,40 +707,104 @@ void renderAllText() {
     // Render scores normally
     renderScores(BOTH);
     // Render pause text if paused
-    if (gPaused && gWinner == NONE) {
-        const char* pauseText = gStarted ? "PAUSED" : "Press P to Play";
-        int textWidth = MeasureText(pauseText, TEXT_FONT_SIZE);
-        DrawText(pauseText, SCREEN_WIDTH / 2 - textWidth / 2, CENTER_TEXT_Y,
-                 TEXT_FONT_SIZE, WHITE);
-    }
+    if (gPaused && gWinner == NONE)
+        gMessageText->drawCentred(SCREEN_WIDTH / 2, CENTER_TEXT_Y);
 }
 
 void renderScores(Player players) {
-    if (players == LEFT_P || players == BOTH) {
-        DrawText(TextFormat("%d", gLeftScore), LEFT_SCORE_X, SCORE_Y,
-                 SCORE_FONT_SIZE, WHITE);
+    if (players == LEFT_P || players == BOTH)
+        gLeftScoreText->draw(LEFT_SCORE_X, SCORE_Y);
+    if (players == RIGHT_P || players == BOTH)
+        gRightScoreText->draw(RIGHT_SCORE_X, SCORE_Y);
+}
+
+void setWinAnimPos() {
+    // Over the winner's score, using the width measured when it last changed
+    const HudText* score =
+        gWinner == LEFT_P ? gLeftScoreText : gRightScoreText;
+    float scoreX = gWinner == LEFT_P ? LEFT_SCORE_X : RIGHT_SCORE_X;
+    TransformComponent& transform = gWorld.transforms.get(gWinAnimation);
+    transform.position = {scoreX + score->getWidth() / 2.0f, // Horizontal align
+                          SCORE_Y + transform.scale.y / 2.0f
+                              - SCORE_FONT_SIZE / 2.0f};     // Vertical align
+}
+
+// Frame time graph (last GRAPH_FRAMES frames, scaled so the top is two
+// frames' budget) and per-phase percentiles over the profiler's history
+void renderProfiler() {
+    const int GRAPH_FRAMES = 240, GRAPH_HEIGHT = 60, ROW_HEIGHT = 12;
+    const int width = 380;
+    const int height = GRAPH_HEIGHT + 20 + (PHASE_COUNT + 1) * ROW_HEIGHT;
+    const int x = 10, y = SCREEN_HEIGHT - height - 10;
+    const float budget = 1000.0f / FPS; // Milliseconds per frame at FPS
+    DrawRectangle(x, y, width, height, Fade(BLACK, 0.75f));
+
+    int graphBottom = y + 5 + GRAPH_HEIGHT;
+    for (int i = 0; i < GRAPH_FRAMES; i++) {
+        float ms = Profiler::getMilliseconds(PHASE_FRAME, GRAPH_FRAMES - 1 - i);
+        int barHeight = std::min(
+            GRAPH_HEIGHT, (int)(ms / (2.0f * budget) * GRAPH_HEIGHT));
+        Color colour = ms > budget * 1.5f ? RED : ms > budget ? YELLOW : GREEN;
+        DrawLine(x + 5 + i, graphBottom, x + 5 + i, graphBottom - barHeight,
+                 colour);
     }
-    if (players == RIGHT_P || players == BOTH) {
-        DrawText(TextFormat("%d", gRightScore), RIGHT_SCORE_X, SCORE_Y,
-                 SCORE_FONT_SIZE, WHITE);
+    // Budget line, halfway up
+    DrawLine(x + 5, graphBottom - GRAPH_HEIGHT / 2, x + 5 + GRAPH_FRAMES,
+             graphBottom - GRAPH_HEIGHT / 2, GRAY);
+    DrawText(TextFormat("%.1f ms", budget), x + GRAPH_FRAMES + 10,
+             graphBottom - GRAPH_HEIGHT / 2 - 5, 10, GRAY);
+
+    int rowY = graphBottom + 10;
+    DrawText("phase        p50     p95     p99     max (ms)", x + 5, rowY, 10,
+             WHITE);
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        ProfilePhase p = static_cast<ProfilePhase>(phase);
+        rowY += ROW_HEIGHT;
+        DrawText(TextFormat("%-10s %7.3f %7.3f %7.3f %7.3f",
+                            Profiler::getPhaseName(p),
+                            Profiler::getPercentile(p, 50.0f),
+                            Profiler::getPercentile(p, 95.0f),
+                            Profiler::getPercentile(p, 99.0f),
+                            Profiler::getMaximum(p)),
+                 x + 5, rowY, 10, LIGHTGRAY);
     }
 }
 
-void setWinAnimPos() {
-    // Left player won
-    if (gWinner == LEFT_P) {
-        gWinAnimation->setPosition(
-            {(float)LEFT_SCORE_X
-                 + MeasureText(TextFormat("%d", gLeftScore), SCORE_FONT_SIZE)
-                       / 2.0f,               // Horizontal align
-             SCORE_Y + gWinAnimation->getScale().y / 2.0f
-                 - SCORE_FONT_SIZE / 2.0f}); // Vertical align
-    } else {                                 // Right player won
-        gWinAnimation->setPosition(
-            {(float)RIGHT_SCORE_X
-                 + MeasureText(TextFormat("%d", gRightScore), SCORE_FONT_SIZE)
-                       / 2.0f,               // Horizontal align
-             SCORE_Y + gWinAnimation->getScale().y / 2.0f
-                 - SCORE_FONT_SIZE / 2.0f}); // Vertical align
+// Closes the frame's collision counters and, every TELEMETRY_FLUSH_SECONDS,
+// rewrites the --telemetry file for whatever is scraping it
+void flushTelemetry() {
+    if (!gTelemetryPath) return;
+    Telemetry::endFrame();
+    float now = (float)GetTime();
+    if (now - gTelemetryFlushed < TELEMETRY_FLUSH_SECONDS) return;
+    gTelemetryFlushed = now;
+    if (!Telemetry::writePrometheus(gTelemetryPath))
+        printf("Telemetry: can't write %s\n", gTelemetryPath);
+}
+
+// Queues the shared ball sprite at one ball's position
+void queueBall(Vec2 position) {
+    gWorld.transforms.get(gBallSprite).position = position;
+    queueSprite(gWorld, gBallSprite, gSpriteBatch);
+}
+
+// Prints time from launch to the first frame, then to every texture loaded
+void logStartup(int texturesLoading) {
+    if (gFirstFrameLogged && gAssetsLogged) return;
+    double milliseconds = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - gLaunchTime)
+                              .count();
+    if (!gFirstFrameLogged) {
+        gFirstFrameLogged = true;
+        printf("Startup: first frame after %.1f ms (%s textures)\n",
+               milliseconds,
+               gPack.isOpen() ? "packed" :
+               gAssets        ? "background" :
+                                "blocking");
     }
-}
\ No newline at end of file
+    if (!gAssetsLogged && texturesLoading == 0) {
+        gAssetsLogged = true;
+        printf("Startup: all textures after %.1f ms\n", milliseconds);
+        if (gAssets) gAssets->logStats("startup");
+    }
+}
@@ -0,0 +1,198 @@
+// Bakes images into an AssetPack. Decodes each one once, here, converts it
+// to RGBA8 and optionally builds its mipmaps, so the game only maps the pack
+// and uploads. Then times both ways the game can get the pixels at startup:
+// decoding every file as LoadTexture(path) does, and opening the pack.
+// With --atlas, the images go into one atlas texture instead, each a region
+// of it, so every sprite draws from the same texture. --max-sprite shrinks
+// any image bigger than that many pixels on a side first.
+// Usage: ./tools/pack_assets [--mipmaps | --atlas [--max-sprite <px>]]
+//                            <pack> <image>...
+
+#include "../CS3113/AssetPack.h"
+#include "../CS3113/AtlasPacker.h"
+#include "../CS3113/cs3113.h"
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::chrono::steady_clock Clock;
+
+static const int TIMING_RUNS = 20;
+static const char* ATLAS_NAME = "assets/atlas"; // Not a file: only in packs
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Bytes of an image's pixels, every mipmap level included
+static size_t imageBytes(const Image& image) {
+    size_t bytes = 0;
+    int width = image.width, height = image.height;
+    for (int level = 0; level < image.mipmaps; level++) {
+        bytes += GetPixelDataSize(width, height, image.format);
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Decodes every image into one RGBA8 atlas and adds it to writer,
+ * with each image as a region of it. Each sprite's edge pixels are repeated
+ * into its ATLAS_PADDING border, so filtering at the edge of a region never
+ * reads a neighbour
+ * @return false if an image doesn't decode or the atlas won't fit
+ */
+static bool addAtlas(AssetPackWriter& writer, char** paths, int count,
+                     int maxSprite) {
+    std::vector<Image> images;
+    std::vector<AtlasRect> rects;
+    for (int i = 0; i < count; i++) {
+        Image image = LoadImage(paths[i]);
+        if (image.data == nullptr) {
+            printf("pack_assets: can't decode %s\n", paths[i]);
+            for (Image& loaded : images) UnloadImage(loaded);
+            return false;
+        }
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        int longest = std::max(image.width, image.height);
+        if (maxSprite > 0 && longest > maxSprite)
+            ImageResize(&image,
+                        std::max(1, image.width * maxSprite / longest),
+                        std::max(1, image.height * maxSprite / longest));
+        images.push_back(image);
+        AtlasRect rect;
+        rect.width = image.width;
+        rect.height = image.height;
+        rects.push_back(rect);
+    }
+    int width = 0, height = 0;
+    bool packed =
+        packAtlas(rects, ATLAS_PADDING, ATLAS_MAX_SIZE, width, height);
+    std::vector<uint8_t> pixels;
+    if (packed) pixels.resize((size_t)width * height * 4, 0);
+    for (size_t i = 0; packed && i < images.size(); i++) {
+        const AtlasRect& rect = rects[i];
+        const uint8_t* source = static_cast<const uint8_t*>(images[i].data);
+        for (int y = -ATLAS_PADDING; y < rect.height + ATLAS_PADDING; y++) {
+            int sourceY = clamp(y, 0, rect.height - 1);
+            for (int x = -ATLAS_PADDING; x < rect.width + ATLAS_PADDING;
+                 x++) {
+                int sourceX = clamp(x, 0, rect.width - 1);
+                memcpy(&pixels[((size_t)(rect.y + y) * width + rect.x + x)
+                               * 4],
+                       source + ((size_t)sourceY * rect.width + sourceX) * 4,
+                       4);
+            }
+        }
+        printf("  %-24s %5d x %-5d at %d, %d\n", paths[i], rect.width,
+               rect.height, rect.x, rect.y);
+    }
+    for (Image& image : images) UnloadImage(image);
+    if (!packed) {
+        printf("pack_assets: the sprites don't fit in a %d x %d atlas; try "
+               "--max-sprite\n",
+               ATLAS_MAX_SIZE, ATLAS_MAX_SIZE);
+        return false;
+    }
+    writer.add(ATLAS_NAME, width, height, 1,
+               PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, pixels.data(),
+               pixels.size());
+    printf("  %-24s %5d x %-5d %12.1f KiB\n", ATLAS_NAME, width, height,
+           pixels.size() / 1024.0);
+    for (int i = 0; i < count; i++) {
+        if (!writer.addRegion(paths[i], ATLAS_NAME, rects[i].x, rects[i].y,
+                              rects[i].width, rects[i].height)) {
+            printf("pack_assets: %s is a duplicate or its path is over %d "
+                   "bytes\n",
+                   paths[i], PACK_NAME_SIZE - 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int first = 1;
+    bool mipmaps = false, atlas = false;
+    int maxSprite = 0;
+    for (; first < argc && strncmp(argv[first], "--", 2) == 0; first++) {
+        if (strcmp(argv[first], "--mipmaps") == 0) mipmaps = true;
+        else if (strcmp(argv[first], "--atlas") == 0) atlas = true;
+        else if (strcmp(argv[first], "--max-sprite") == 0 && first + 1 < argc)
+            maxSprite = atoi(argv[++first]);
+        else break;
+    }
+    // Smaller mipmap levels would blend neighbouring sprites together
+    if (argc - first < 2 || (mipmaps && atlas)) {
+        printf("Usage: %s [--mipmaps | --atlas [--max-sprite <px>]] <pack> "
+               "<image>...\n",
+               argv[0]);
+        return 1;
+    }
+    SetTraceLogLevel(LOG_WARNING);
+    const char* packPath = argv[first];
+    AssetPackWriter writer;
+    if (atlas && !addAtlas(writer, argv + first + 1, argc - first - 1,
+                           maxSprite))
+        return 1;
+    for (int i = first + 1; !atlas && i < argc; i++) {
+        Image image = LoadImage(argv[i]);
+        if (image.data == nullptr) {
+            printf("pack_assets: can't decode %s\n", argv[i]);
+            return 1;
+        }
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        if (mipmaps) ImageMipmaps(&image);
+        size_t bytes = imageBytes(image);
+        bool added = writer.add(argv[i], image.width, image.height,
+                                image.mipmaps, image.format, image.data,
+                                bytes);
+        printf("  %-24s %5d x %-5d %2d levels %9.1f KiB\n", argv[i],
+               image.width, image.height, image.mipmaps, bytes / 1024.0);
+        UnloadImage(image);
+        if (!added) {
+            printf("pack_assets: %s is a duplicate or its path is over %d "
+                   "bytes\n",
+                   argv[i], PACK_NAME_SIZE - 1);
+            return 1;
+        }
+    }
+    uint32_t flags = 0;
+    if (mipmaps) flags |= PACK_MIPMAPS;
+    if (atlas) flags |= PACK_ATLAS;
+    if (!writer.write(packPath, flags)) {
+        printf("pack_assets: can't write %s\n", packPath);
+        return 1;
+    }
+
+    // Startup cost of each path, best of TIMING_RUNS. Both end with the
+    // pixels in memory; uploading them costs the same either way
+    double decodeBest = 1e9, packBest = 1e9, trustedBest = 1e9;
+    AssetPack pack;
+    for (int run = 0; run < TIMING_RUNS; run++) {
+        Clock::time_point start = Clock::now();
+        for (int i = first + 1; i < argc; i++) UnloadImage(LoadImage(argv[i]));
+        decodeBest = std::min(decodeBest, secondsSince(start));
+        start = Clock::now();
+        PackStatus status = pack.open(packPath);
+        packBest = std::min(packBest, secondsSince(start));
+        if (status != PACK_OK) {
+            printf("pack_assets: %s doesn't read back: %s\n", packPath,
+                   AssetPack::describe(status));
+            return 1;
+        }
+        start = Clock::now();
+        pack.open(packPath, false);
+        trustedBest = std::min(trustedBest, secondsSince(start));
+    }
+    printf("pack_assets: %d textures, %.1f KiB in %s%s\n", pack.size(),
+           pack.getFileSize() / 1024.0, packPath,
+           mipmaps ? " with mipmaps" : atlas ? " as one atlas" : "");
+    printf("  decode every file   %8.3f ms\n", decodeBest * 1000.0);
+    printf("  map pack + checksum %8.3f ms (%.0fx)\n", packBest * 1000.0,
+           decodeBest / packBest);
+    printf("  map pack, no check  %8.3f ms (%.0fx)\n", trustedBest * 1000.0,
+           decodeBest / trustedBest);
+    return 0;
+}